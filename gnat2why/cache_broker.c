@@ -0,0 +1,196 @@
+/****************************************************************************
+ *                                                                          *
+ *                            GNAT2WHY COMPONENTS                           *
+ *                                                                          *
+ *                         C A C H E _ B R O K E R                          *
+ *                                                                          *
+ *                           C Implementation file                          *
+ *                                                                          *
+ *                       Copyright (C) 2026, AdaCore                        *
+ *                                                                          *
+ * gnat2why is  free  software;  you can redistribute  it and/or  modify it *
+ * under terms of the  GNU General Public License as published  by the Free *
+ * Software  Foundation;  either version 3,  or (at your option)  any later *
+ * version.  gnat2why is distributed  in the hope that  it will be  useful, *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- *
+ * TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public *
+ * License for  more details.  You should have  received  a copy of the GNU *
+ * General  Public License  distributed with  gnat2why;  see file COPYING3. *
+ * If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the *
+ * license.                                                                 *
+ *                                                                          *
+ * gnat2why is maintained by AdaCore (http://www.adacore.com)               *
+ *                                                                          *
+ ****************************************************************************/
+
+/* Client of spark_memcached_broker, used by gnat2why to look up the results
+   of gnatwhy3 in the memcached server shared by a gnatprove run, see package
+   Gnat2Why.Cache_Broker. gnat2why is built without streams, so it cannot use
+   GNAT.Sockets for that. The broker is not used on Windows. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+
+/* Write the LEN bytes of BUF to FD. Return 0 on success and -1 on error. */
+
+static int write_all (int fd, const char *buf, size_t len) {
+  while (len > 0) {
+    ssize_t n = send (fd, buf, len, SEND_FLAGS);
+    if (n <= 0)
+      return -1;
+    buf += n;
+    len -= n;
+  }
+  return 0;
+}
+
+/* Read exactly LEN bytes from FD into BUF. Return 0 on success and -1 on
+   error or end of file. */
+
+static int read_exact (int fd, char *buf, size_t len) {
+  while (len > 0) {
+    ssize_t n = read (fd, buf, len);
+    if (n <= 0)
+      return -1;
+    buf += n;
+    len -= n;
+  }
+  return 0;
+}
+
+/* Read a line terminated by CRLF from FD into BUF of SIZE bytes, and replace
+   the terminator by a NUL. Return 0 on success and -1 on error, end of file
+   or if the line does not fit in BUF. */
+
+static int read_line (int fd, char *buf, size_t size) {
+  size_t len = 0;
+  while (len + 1 < size) {
+    if (read_exact (fd, buf + len, 1) != 0)
+      return -1;
+    len++;
+    if (len >= 2 && buf[len - 2] == '\r' && buf[len - 1] == '\n') {
+      buf[len - 2] = '\0';
+      return 0;
+    }
+  }
+  return -1;
+}
+
+int gnat2why_broker_connect (const char *name) {
+  struct sockaddr_un addr;
+  int fd;
+
+  if (strlen (name) >= sizeof (addr.sun_path))
+    return -1;
+
+  fd = socket (AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0)
+    return -1;
+
+#ifdef SO_NOSIGPIPE
+  {
+    int on = 1;
+    setsockopt (fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof (on));
+  }
+#endif
+
+  /* The connection is not inherited by the processes spawned by gnat2why */
+
+  fcntl (fd, F_SETFD, FD_CLOEXEC);
+
+  memset (&addr, 0, sizeof (addr));
+  addr.sun_family = AF_UNIX;
+  strcpy (addr.sun_path, name);
+
+  if (connect (fd, (struct sockaddr *) &addr, sizeof (addr)) != 0) {
+    close (fd);
+    return -1;
+  }
+  return fd;
+}
+
+int gnat2why_broker_get
+  (int fd, const char *key, char **value, size_t *length)
+{
+  char header[512];
+  char trailer[7];
+  size_t bytes;
+
+  *value = NULL;
+  *length = 0;
+
+  if (write_all (fd, "get ", 4) != 0
+      || write_all (fd, key, strlen (key)) != 0
+      || write_all (fd, "\r\n", 2) != 0
+      || read_line (fd, header, sizeof (header)) != 0)
+    return -1;
+
+  if (strcmp (header, "END") == 0)
+    return 0;
+
+  if (sscanf (header, "VALUE %*s %*u %zu", &bytes) != 1)
+    return -1;
+
+  *value = malloc (bytes + 1);
+  if (*value == NULL)
+    return -1;
+
+  if (read_exact (fd, *value, bytes) != 0
+      || read_exact (fd, trailer, sizeof (trailer)) != 0
+      || memcmp (trailer, "\r\nEND\r\n", sizeof (trailer)) != 0)
+  {
+    free (*value);
+    *value = NULL;
+    return -1;
+  }
+
+  (*value)[bytes] = '\0';
+  *length = bytes;
+  return 1;
+}
+
+void gnat2why_broker_close (int fd) {
+  close (fd);
+}
+
+#else
+
+int gnat2why_broker_connect (const char *name) {
+  (void) name;
+  return -1;
+}
+
+int gnat2why_broker_get
+  (int fd, const char *key, char **value, size_t *length)
+{
+  (void) fd;
+  (void) key;
+  *value = NULL;
+  *length = 0;
+  return -1;
+}
+
+void gnat2why_broker_close (int fd) {
+  (void) fd;
+}
+
+#endif
+
+void gnat2why_broker_free (char *value) {
+  free (value);
+}
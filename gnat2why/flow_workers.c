@@ -0,0 +1,70 @@
+/****************************************************************************
+ *                                                                          *
+ *                            GNAT2WHY COMPONENTS                           *
+ *                                                                          *
+ *                          F L O W _ W O R K E R S                         *
+ *                                                                          *
+ *                           C Implementation file                          *
+ *                                                                          *
+ *                       Copyright (C) 2026, AdaCore                        *
+ *                                                                          *
+ * gnat2why is  free  software;  you can redistribute  it and/or  modify it *
+ * under terms of the  GNU General Public License as published  by the Free *
+ * Software  Foundation;  either version 3,  or (at your option)  any later *
+ * version.  gnat2why is distributed  in the hope that  it will be  useful, *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- *
+ * TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public *
+ * License for  more details.  You should have  received  a copy of the GNU *
+ * General  Public License  distributed with  gnat2why;  see file COPYING3. *
+ * If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the *
+ * license.                                                                 *
+ *                                                                          *
+ * gnat2why is maintained by AdaCore (http://www.adacore.com)               *
+ *                                                                          *
+ ****************************************************************************/
+
+/* Process primitives used to run flow analysis in forked worker processes,
+   see package Flow_Journal. Forking is not available on Windows, where flow
+   analysis is always done sequentially. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+int gnat2why_fork (void) {
+  fflush (NULL);
+  return fork ();
+}
+
+int gnat2why_wait (int pid) {
+  int status;
+  if (waitpid (pid, &status, 0) != pid || !WIFEXITED (status))
+    return -1;
+  return WEXITSTATUS (status);
+}
+
+void gnat2why_exit (int status) {
+  _exit (status);
+}
+
+#else
+
+int gnat2why_fork (void) {
+  return -1;
+}
+
+int gnat2why_wait (int pid) {
+  (void) pid;
+  return -1;
+}
+
+void gnat2why_exit (int status) {
+  exit (status);
+}
+
+#endif
@@ -108,6 +108,278 @@ procedure Call_With_Status
    end Call_With_Status;
    pragma Annotate (Xcov, Exempt_Off);
 
+   ------------------------------
+   -- Iterate_JSON_Object_File --
+   ------------------------------
+
+   procedure Iterate_JSON_Object_File
+     (Fn              : String;
+      Array_Field     : String;
+      Process_Object  : not null access procedure (Object : JSON_Value);
+      Process_Element : not null access procedure (Value : JSON_Value))
+   is
+      use GNATCOLL.Mmap;
+      File   : Mapped_File;
+      Region : Mapped_Region;
+
+   begin
+      File := Open_Read (Fn);
+
+      --  An empty file is not mapped, so that there is no data to scan
+
+      if Length (File) = 0 then
+         Close (File);
+         raise Invalid_JSON_Stream with Fn & ": empty file";
+      end if;
+
+      Read (File, Region);
+
+      declare
+         S : String (1 .. Integer (Length (File)));
+         for S'Address use Data (Region).all'Address;
+         --  A fake string directly mapped onto the file contents
+
+         Pos : Positive := S'First;
+         --  Current position of the scanner in S
+
+         Array_First : Natural := 0;
+         --  Position of the value of Array_Field in S, if any
+
+         Object : constant JSON_Value := Create_Object;
+         --  Fields of the object other than Array_Field
+
+         function Current return Character;
+         --  Return the character at Pos
+
+         procedure Expect (C : Character);
+         --  Skip blanks, then check that the character at Pos is C and skip
+         --  it.
+
+         procedure Skip_Blanks;
+         --  Skip whitespace starting at Pos
+
+         procedure Skip_String;
+         --  Skip the string literal starting at Pos
+
+         procedure Skip_Value;
+         --  Skip the JSON value starting at Pos, without parsing it
+
+         -------------
+         -- Current --
+         -------------
+
+         function Current return Character is
+         begin
+            if Pos > S'Last then
+               raise Invalid_JSON_Stream with
+                 Fn & ": unexpected end of file";
+            end if;
+
+            return S (Pos);
+         end Current;
+
+         ------------
+         -- Expect --
+         ------------
+
+         procedure Expect (C : Character) is
+         begin
+            Skip_Blanks;
+
+            if Current /= C then
+               raise Invalid_JSON_Stream with
+                 Fn & ":" & GNATCOLL.Utils.Image (Pos, 1)
+                 & ": expected '" & C & "'";
+            end if;
+
+            Pos := Pos + 1;
+         end Expect;
+
+         -----------------
+         -- Skip_Blanks --
+         -----------------
+
+         procedure Skip_Blanks is
+         begin
+            while Pos <= S'Last
+              and then S (Pos) in ' ' | ASCII.HT | ASCII.LF | ASCII.CR
+            loop
+               Pos := Pos + 1;
+            end loop;
+         end Skip_Blanks;
+
+         -----------------
+         -- Skip_String --
+         -----------------
+
+         procedure Skip_String is
+         begin
+            Expect ('"');
+
+            loop
+               case Current is
+                  when '\' =>
+                     Pos := Pos + 2;
+
+                  when '"' =>
+                     Pos := Pos + 1;
+                     exit;
+
+                  when others =>
+                     Pos := Pos + 1;
+               end case;
+            end loop;
+         end Skip_String;
+
+         ----------------
+         -- Skip_Value --
+         ----------------
+
+         procedure Skip_Value is
+            Depth : Natural := 0;
+         begin
+            Skip_Blanks;
+
+            case Current is
+               when '"' =>
+                  Skip_String;
+
+               when '{' | '[' =>
+                  loop
+                     case Current is
+                        when '"' =>
+                           Skip_String;
+
+                        when '{' | '[' =>
+                           Depth := Depth + 1;
+                           Pos := Pos + 1;
+
+                        when '}' | ']' =>
+                           if Depth = 0 then
+                              raise Invalid_JSON_Stream with
+                                Fn & ":" & GNATCOLL.Utils.Image (Pos, 1)
+                                & ": unexpected '" & Current & "'";
+                           end if;
+
+                           Depth := Depth - 1;
+                           Pos := Pos + 1;
+                           exit when Depth = 0;
+
+                        when others =>
+                           Pos := Pos + 1;
+                     end case;
+                  end loop;
+
+               --  Numbers and literals
+
+               when others =>
+                  while Pos <= S'Last
+                    and then S (Pos) not in ',' | '}' | ']' | ' '
+                                          | ASCII.HT | ASCII.LF | ASCII.CR
+                  loop
+                     Pos := Pos + 1;
+                  end loop;
+            end case;
+         end Skip_Value;
+
+      begin
+         --  Parse the fields of the object, except for the array which is
+         --  only located.
+
+         Skip_Blanks;
+
+         --  If the file does not contain an object, let the JSON parser
+         --  report the error, as it would when reading the whole file.
+
+         if Pos > S'Last or else S (Pos) /= '{' then
+            declare
+               Unused : constant JSON_Value := Read (S, Fn);
+            begin
+               raise Invalid_JSON_Stream with Fn & ": expected an object";
+            end;
+         end if;
+
+         Expect ('{');
+         Skip_Blanks;
+
+         if Current /= '}' then
+            loop
+               Skip_Blanks;
+
+               declare
+                  Name_First : constant Positive := Pos;
+               begin
+                  Skip_String;
+
+                  declare
+                     Name : constant String :=
+                       Get (Read (S (Name_First .. Pos - 1), Fn));
+                  begin
+                     Expect (':');
+                     Skip_Blanks;
+
+                     declare
+                        Value_First : constant Positive := Pos;
+                     begin
+                        Skip_Value;
+
+                        if Name = Array_Field then
+                           Array_First := Value_First;
+                        else
+                           Set_Field
+                             (Object,
+                              Name,
+                              Read (S (Value_First .. Pos - 1), Fn));
+                        end if;
+                     end;
+                  end;
+               end;
+
+               Skip_Blanks;
+               exit when Current = '}';
+               Expect (',');
+            end loop;
+         end if;
+
+         Process_Object (Object);
+
+         --  Then parse the elements of the array one at a time
+
+         if Array_First /= 0 then
+            Pos := Array_First;
+            Expect ('[');
+            Skip_Blanks;
+
+            if Current /= ']' then
+               loop
+                  Skip_Blanks;
+
+                  declare
+                     Element_First : constant Positive := Pos;
+                  begin
+                     Skip_Value;
+                     Process_Element
+                       (Read (S (Element_First .. Pos - 1), Fn));
+                  end;
+
+                  Skip_Blanks;
+                  exit when Current = ']';
+                  Expect (',');
+               end loop;
+            end if;
+         end if;
+
+      exception
+         when others =>
+            Free (Region);
+            Close (File);
+            raise;
+      end;
+
+      Free (Region);
+      Close (File);
+   end Iterate_JSON_Object_File;
+
    ------------------------
    -- Print_Command_Line --
    ------------------------
@@ -154,6 +426,13 @@ function Read_File_Into_String (Fn : String) return String is
    begin
       File := Open_Read (Fn);
 
+      --  An empty file is not mapped
+
+      if Length (File) = 0 then
+         Close (File);
+         return "";
+      end if;
+
       Read (File, Region);
 
       declare
@@ -0,0 +1,310 @@
+------------------------------------------------------------------------------
+--                                                                          --
+--                            GNATPROVE COMPONENTS                          --
+--                                                                          --
+--                      F I L E C A C H E _ C L I E N T                     --
+--                                                                          --
+--                                 B o d y                                  --
+--                                                                          --
+--                     Copyright (C) 2022-2025, AdaCore                     --
+--                                                                          --
+-- gnatprove is  free  software;  you can redistribute it and/or  modify it --
+-- under terms of the  GNU General Public License as published  by the Free --
+-- Software  Foundation;  either version 3,  or (at your option)  any later --
+-- version.  gnatprove is distributed  in the hope that  it will be useful, --
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- --
+-- TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public --
+-- License for  more details.  You should have  received  a copy of the GNU --
+-- General Public License  distributed with  gnatprove;  see file COPYING3. --
+-- If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the --
+-- license.                                                                 --
+--                                                                          --
+-- gnatprove is maintained by AdaCore (http://www.adacore.com)              --
+--                                                                          --
+------------------------------------------------------------------------------
+
+with Ada.Containers.Vectors;
+with Ada.Strings.Unbounded; use Ada.Strings.Unbounded;
+with Call;                  use Call;
+with GNATCOLL.Utils;
+
+package body Filecache_Client is
+
+   use type Ada.Calendar.Time;
+
+   Shard_Prefix_Length : constant := 2;
+   --  Number of leading characters of the key used to name the subdirectory
+   --  in which the entry is stored.
+
+   Temp_Suffix : constant String := ".tmp";
+   --  Suffix of the temporary files created by Set
+
+   Temp_File_Max_Age : constant Duration := 3600.0;
+   --  Age after which a temporary file is considered to be left over by an
+   --  interrupted call to Set, and can be removed.
+
+   type Cache_Entry is record
+      Name : Unbounded_String;
+      Time : Ada.Calendar.Time;
+      Size : File_Size;
+   end record;
+
+   function "<" (Left, Right : Cache_Entry) return Boolean
+   is (Left.Time < Right.Time);
+
+   package Entry_Vectors is new
+     Ada.Containers.Vectors
+       (Index_Type   => Positive,
+        Element_Type => Cache_Entry);
+
+   package Entry_Sorting is new Entry_Vectors.Generic_Sorting;
+
+   function Shard_Dir (Dir : String; Key : String) return String
+   is (Compose (Dir, Key (Key'First .. Key'First + Shard_Prefix_Length - 1)));
+   --  Return the subdirectory of Dir in which the entry for Key is stored
+
+   function Entry_File (Dir : String; Key : String) return String
+   is (if Key'Length > Shard_Prefix_Length
+       then Compose (Shard_Dir (Dir, Key), Key)
+       else Compose (Dir, Key));
+   --  Return the file in which the entry for Key is stored
+
+   procedure Iterate_Entries
+     (Dir     : String;
+      Process : not null access procedure (E : Directory_Entry_Type));
+   --  Call Process on all the files of the file cache in Dir, including
+   --  temporary files and entries stored without sharding.
+
+   ----------
+   -- Init --
+   ----------
+
+   function Init (Dir : String) return Filecache is
+   begin
+      return Filecache'(Dir => new String'(Dir));
+   end Init;
+
+   ---------------------
+   -- Iterate_Entries --
+   ---------------------
+
+   procedure Iterate_Entries
+     (Dir     : String;
+      Process : not null access procedure (E : Directory_Entry_Type))
+   is
+      procedure Process_Shard (E : Directory_Entry_Type);
+      --  Call Process on all the files of the subdirectory E
+
+      -------------------
+      -- Process_Shard --
+      -------------------
+
+      procedure Process_Shard (E : Directory_Entry_Type) is
+         Name : constant String := Simple_Name (E);
+      begin
+         if Name'Length = Shard_Prefix_Length and then Name /= ".." then
+            Search
+              (Full_Name (E),
+               "",
+               (Ordinary_File => True, others => False),
+               Process);
+         end if;
+      end Process_Shard;
+
+   begin
+      Search (Dir, "", (Ordinary_File => True, others => False), Process);
+      Search
+        (Dir, "", (Directory => True, others => False), Process_Shard'Access);
+   end Iterate_Entries;
+
+   ---------
+   -- Set --
+   ---------
+
+   procedure Set (Conn : Filecache; Key : String; Value : String) is
+      Fn      : constant String := Entry_File (Conn.Dir.all, Key);
+      Shard   : constant String := Containing_Directory (Fn);
+      Name    : constant String :=
+        Fn & "." & GNATCOLL.Utils.Image (Get_Process_Id, 1) & Temp_Suffix;
+      FD      : File_Descriptor;
+      Written : Integer;
+      Unused  : Boolean;
+   begin
+      --  We first write to a temporary file, then rename the file to the
+      --  target filename. This should protect against:
+      --    - Clients reading (via Get) the file while we write it, getting
+      --      incomplete data. The file is always present with full data,
+      --      or absent.
+      --    - Two clients racing to write the file. Both clients would write to
+      --      their own temporary file, and it doesn't matter which one "wins"
+      --      the rename (renames last), as both should contain the same
+      --      content.
+
+      --  Renaming doesn't work across devices, so the temp file is created in
+      --  the target directory, under a name that is unique to this process.
+
+      if not Exists (Shard) then
+         begin
+            Create_Directory (Shard);
+         exception
+
+            --  Another client may have created the directory in the meantime
+
+            when Use_Error =>
+               if not Exists (Shard) then
+                  return;
+               end if;
+         end;
+      end if;
+
+      FD := Create_New_File (Name, Binary);
+      if FD = Invalid_FD then
+         return;
+      end if;
+      Written := Write (FD, Value (Value'First)'Address, Value'Length);
+      Close (FD);
+      if Written /= Value'Length then
+         --  some error happened
+         Delete_File (Name, Unused);
+         return;
+      end if;
+      Rename_File (Name, Fn, Unused);
+   end Set;
+
+   ---------
+   -- Get --
+   ---------
+
+   function Get (Conn : Filecache; Key : String) return String is
+      File   : constant String := Entry_File (Conn.Dir.all, Key);
+      Legacy : constant String := Compose (Conn.Dir.all, Key);
+   begin
+      if Is_Regular_File (File) then
+
+         --  Record the access for the eviction of least recently used
+         --  entries.
+
+         Set_File_Last_Modify_Time_Stamp (File, Current_Time);
+         return Read_File_Into_String (File);
+
+      --  Entries written without sharding are still used, but not touched,
+      --  so that they are evicted first.
+
+      elsif Is_Regular_File (Legacy) then
+         return Read_File_Into_String (Legacy);
+      else
+         return "";
+      end if;
+   end Get;
+
+   -----------
+   -- Close --
+   -----------
+
+   procedure Close (Conn : in out Filecache) is
+   begin
+      Free (Conn.Dir);
+   end Close;
+
+   ---------------
+   -- Get_Stats --
+   ---------------
+
+   function Get_Stats (Dir : String) return Cache_Stats is
+      Result : Cache_Stats;
+
+      procedure Count (E : Directory_Entry_Type);
+
+      -----------
+      -- Count --
+      -----------
+
+      procedure Count (E : Directory_Entry_Type) is
+      begin
+         Result.Entries := Result.Entries + 1;
+         Result.Size := Result.Size + Size (E);
+         if Modification_Time (E) < Result.Oldest then
+            Result.Oldest := Modification_Time (E);
+         end if;
+      end Count;
+
+   begin
+      Iterate_Entries (Dir, Count'Access);
+      return Result;
+   end Get_Stats;
+
+   ---------------------
+   -- Collect_Garbage --
+   ---------------------
+
+   procedure Collect_Garbage
+     (Dir      : String;
+      Max_Size : File_Size;
+      Max_Age  : Duration;
+      Removed  : out Cache_Stats)
+   is
+      Now     : constant Ada.Calendar.Time := Ada.Calendar.Clock;
+      Entries : Entry_Vectors.Vector;
+      Total   : File_Size := 0;
+
+      procedure Collect (E : Directory_Entry_Type);
+      --  Add E to Entries, or remove it if it is a stale temporary file
+
+      procedure Remove (E : Cache_Entry);
+      --  Delete the file of E and account for it in Removed
+
+      -------------
+      -- Collect --
+      -------------
+
+      procedure Collect (E : Directory_Entry_Type) is
+         Item : constant Cache_Entry :=
+           (Name => To_Unbounded_String (Full_Name (E)),
+            Time => Modification_Time (E),
+            Size => Size (E));
+      begin
+         if GNATCOLL.Utils.Ends_With (Simple_Name (E), Temp_Suffix) then
+            if Now - Item.Time > Temp_File_Max_Age then
+               Remove (Item);
+            end if;
+         else
+            Entries.Append (Item);
+            Total := Total + Item.Size;
+         end if;
+      end Collect;
+
+      ------------
+      -- Remove --
+      ------------
+
+      procedure Remove (E : Cache_Entry) is
+         Success : Boolean;
+      begin
+         --  Another gc may have removed the file already, which is fine
+
+         Delete_File (To_String (E.Name), Success);
+         if Success then
+            Removed.Entries := Removed.Entries + 1;
+            Removed.Size := Removed.Size + E.Size;
+         end if;
+      end Remove;
+
+   begin
+      Removed := (Entries => 0, Size => 0, Oldest => Now);
+      Iterate_Entries (Dir, Collect'Access);
+
+      --  Evict entries from the least recently used one, until both bounds
+      --  are met.
+
+      Entry_Sorting.Sort (Entries);
+
+      for E of Entries loop
+         exit when
+           (Max_Size = 0 or else Total <= Max_Size)
+           and then (Max_Age = 0.0 or else Now - E.Time <= Max_Age);
+         Remove (E);
+         Total := Total - E.Size;
+      end loop;
+   end Collect_Garbage;
+
+end Filecache_Client;
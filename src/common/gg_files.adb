@@ -0,0 +1,456 @@
+------------------------------------------------------------------------------
+--                                                                          --
+--                            GNAT2WHY COMPONENTS                           --
+--                                                                          --
+--                             G G _ F I L E S                              --
+--                                                                          --
+--                                 B o d y                                  --
+--                                                                          --
+--                       Copyright (C) 2026, AdaCore                        --
+--                                                                          --
+-- gnat2why is  free  software;  you can redistribute  it and/or  modify it --
+-- under terms of the  GNU General Public License as published  by the Free --
+-- Software  Foundation;  either version 3,  or (at your option)  any later --
+-- version.  gnat2why is distributed  in the hope that  it will be  useful, --
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- --
+-- TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public --
+-- License for  more details.  You should have  received  a copy of the GNU --
+-- General  Public License  distributed with  gnat2why;  see file COPYING3. --
+-- If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the --
+-- license.                                                                 --
+--                                                                          --
+-- gnat2why is maintained by AdaCore (http://www.adacore.com)               --
+--                                                                          --
+------------------------------------------------------------------------------
+
+with Ada.Containers.Indefinite_Hashed_Maps;
+with Ada.Containers.Indefinite_Hashed_Sets;
+with Ada.Directories;
+with Ada.Strings.Hash;
+with GNAT.OS_Lib;   use GNAT.OS_Lib;
+with GNATCOLL.Mmap; use GNATCOLL.Mmap;
+
+package body GG_Files is
+
+   -----------------
+   -- Append_Name --
+   -----------------
+
+   procedure Append_Name (Buffer : in out Unbounded_String; Name : String) is
+   begin
+      Append_Number (Buffer, Unsigned_64 (Name'Length));
+      Append (Buffer, Name);
+   end Append_Name;
+
+   -------------------
+   -- Append_Number --
+   -------------------
+
+   procedure Append_Number (Buffer : in out Unbounded_String; N : Unsigned_64)
+   is
+      Rest : Unsigned_64 := N;
+   begin
+      while Rest >= 16#80# loop
+         Append (Buffer, Character'Val ((Rest and 16#7F#) or 16#80#));
+         Rest := Shift_Right (Rest, 7);
+      end loop;
+      Append (Buffer, Character'Val (Rest));
+   end Append_Number;
+
+   -----------------
+   -- Append_Word --
+   -----------------
+
+   procedure Append_Word (Buffer : in out Unbounded_String; N : Natural) is
+      Rest : Unsigned_32 := Unsigned_32 (N);
+   begin
+      for J in 1 .. 4 loop
+         Append (Buffer, Character'Val (Rest and 16#FF#));
+         Rest := Shift_Right (Rest, 8);
+      end loop;
+   end Append_Word;
+
+   ----------
+   -- Link --
+   ----------
+
+   procedure Link
+     (GG_File_Names : String_Lists.List;
+      Database      : String;
+      Version       : String)
+   is
+      package Name_Numbering is new
+        Ada.Containers.Indefinite_Hashed_Maps
+          (Key_Type        => String,
+           Element_Type    => Natural,
+           Hash            => Ada.Strings.Hash,
+           Equivalent_Keys => "=");
+
+      package Unit_Sets is new
+        Ada.Containers.Indefinite_Hashed_Sets
+          (Element_Type        => String,
+           Hash                => Ada.Strings.Hash,
+           Equivalent_Elements => "=");
+
+      Name_Numbers : Name_Numbering.Map;
+      Name_Table   : Unbounded_String;
+      --  Table of names shared by all units, as in a GG file
+
+      Units     : Unit_Sets.Set;
+      Directory : Unbounded_String;
+      Entries   : Unbounded_String;
+      --  Units linked so far, with their directory and entries
+
+      Ambiguous : Unit_Sets.Set;
+      --  Units whose name is shared by several GG files, e.g. from different
+      --  projects of an aggregate project; they are left out of the database
+      --  since gnat2why looks units up by name.
+
+      function Intern (Name : String) return Natural;
+      --  Returns the number of Name in the shared table of names, after
+      --  adding it if needed.
+
+      procedure Link_File (File_Name : String);
+      --  Adds the unit of the GG file File_Name to the database, unless it is
+      --  ambiguous or the file is not for the expected version.
+
+      procedure Write_Database;
+      --  Writes the database through a temporary file, so that gnat2why
+      --  never sees a partial database.
+
+      ------------
+      -- Intern --
+      ------------
+
+      function Intern (Name : String) return Natural is
+         Position : Name_Numbering.Cursor;
+         Inserted : Boolean;
+      begin
+         Name_Numbers.Insert
+           (Key      => Name,
+            New_Item => Natural (Name_Numbers.Length),
+            Position => Position,
+            Inserted => Inserted);
+
+         if Inserted then
+            Append_Name (Name_Table, Name);
+         end if;
+
+         return Name_Numbering.Element (Position);
+      end Intern;
+
+      ---------------
+      -- Link_File --
+      ---------------
+
+      procedure Link_File (File_Name : String) is
+         Unit   : constant String := Unit_Name (File_Name);
+         File   : Mapped_File;
+         Region : Mapped_Region;
+
+      begin
+         if Ambiguous.Contains (Unit) or else not Is_Regular_File (File_Name)
+         then
+            return;
+         end if;
+
+         File := Open_Read (File_Name);
+
+         if Length (File) = 0 then
+            Close (File);
+            return;
+         end if;
+
+         Read (File, Region);
+
+         declare
+            Data : String (1 .. Integer (Length (File)));
+            for Data'Address use GNATCOLL.Mmap.Data (Region).all'Address;
+            --  A fake string directly mapped onto the file contents
+
+            Position       : Positive := GG_File_Magic'Length + 1;
+            Version_Length : Natural;
+            Name_Count     : Natural;
+            Table_Length   : Natural;
+            Table_Last     : Natural;
+            Unit_Entries   : Unbounded_String;
+            Item           : Unsigned_64;
+
+         begin
+            if Data'Last < GG_File_Magic'Length
+              or else Data (1 .. GG_File_Magic'Length) /= GG_File_Magic
+            then
+               raise GG_File_Error;
+            end if;
+
+            Version_Length := Read_Natural (Data, Data'Last, Position);
+
+            if Position + Version_Length - 1 > Data'Last
+              or else Data (Position .. Position + Version_Length - 1)
+                      /= Version
+            then
+               raise GG_File_Error;
+            end if;
+
+            Position := Position + Version_Length;
+            Name_Count := Read_Natural (Data, Data'Last, Position);
+            Table_Length := Read_Natural (Data, Data'Last, Position);
+            Table_Last := Position + Table_Length - 1;
+
+            if Table_Last > Data'Last then
+               raise GG_File_Error;
+            end if;
+
+            declare
+               Global_Number : array (0 .. Name_Count - 1) of Natural;
+               --  Numbers of the names of the file in the shared table
+
+               First     : Positive;
+               Name_Last : Natural;
+
+            begin
+               for J in Global_Number'Range loop
+                  Read_Name (Data, Table_Last, Position, First, Name_Last);
+                  Global_Number (J) := Intern (Data (First .. Name_Last));
+               end loop;
+
+               if Position /= Table_Last + 1 then
+                  raise GG_File_Error;
+               end if;
+
+               --  Copy the entries, renumbering references to names
+
+               while Position <= Data'Last loop
+                  Read_Number (Data, Data'Last, Position, Item);
+
+                  if Item mod 2 = 1 then
+                     if Item / 2 >= Unsigned_64 (Name_Count) then
+                        raise GG_File_Error;
+                     end if;
+
+                     Item :=
+                       2 * Unsigned_64 (Global_Number (Natural (Item / 2)))
+                       + 1;
+                  end if;
+
+                  Append_Number (Unit_Entries, Item);
+               end loop;
+            end;
+
+            Units.Insert (Unit);
+            Append_Word (Directory, Intern (Unit));
+            Append_Word (Directory, Length (Entries));
+            Append_Word (Directory, Length (Unit_Entries));
+            Append (Entries, Unit_Entries);
+
+         exception
+            --  Leave malformed files and files from another version out of
+            --  the database; gnat2why will then read them directly and
+            --  report the problem.
+
+            when GG_File_Error =>
+               null;
+         end;
+
+         Free (Region);
+         Close (File);
+      end Link_File;
+
+      --------------------
+      -- Write_Database --
+      --------------------
+
+      procedure Write_Database is
+         Tmp     : constant String := Database & ".tmp";
+         Header  : Unbounded_String;
+         FD      : File_Descriptor;
+         Success : Boolean := True;
+
+         procedure Write_Buffer (Buffer : Unbounded_String);
+         --  Writes the contents of Buffer to FD
+
+         ------------------
+         -- Write_Buffer --
+         ------------------
+
+         procedure Write_Buffer (Buffer : Unbounded_String) is
+            S : constant String := To_String (Buffer);
+         begin
+            if Success then
+               Success := Write (FD, S'Address, S'Length) = S'Length;
+            end if;
+         end Write_Buffer;
+
+         --  Start of processing for Write_Database
+
+      begin
+         Append (Header, GG_Database_Magic);
+         Append_Number (Header, Unsigned_64 (Version'Length));
+         Append (Header, Version);
+         Append_Number (Header, Unsigned_64 (Name_Numbers.Length));
+         Append_Number (Header, Unsigned_64 (Length (Name_Table)));
+         Append_Number (Header, Unsigned_64 (Units.Length));
+
+         FD := Create_File (Tmp, Binary);
+
+         if FD = Invalid_FD then
+            return;
+         end if;
+
+         Write_Buffer (Header);
+         Write_Buffer (Name_Table);
+         Write_Buffer (Directory);
+         Write_Buffer (Entries);
+
+         Close (FD);
+
+         if Success then
+            Rename_File (Tmp, Database, Success);
+         end if;
+
+         if not Success then
+            Delete_File (Tmp, Success);
+         end if;
+      end Write_Database;
+
+      --  Start of processing for Link
+
+   begin
+      for File_Name of GG_File_Names loop
+         declare
+            Unit     : constant String := Unit_Name (File_Name);
+            Position : Unit_Sets.Cursor;
+            Inserted : Boolean;
+         begin
+            Units.Insert (Unit, Position, Inserted);
+
+            if not Inserted then
+               Ambiguous.Include (Unit);
+            end if;
+         end;
+      end loop;
+
+      Units.Clear;
+
+      for File_Name of GG_File_Names loop
+         Link_File (File_Name);
+      end loop;
+
+      --  Remove any previous database first, so that a stale one is never
+      --  used if the new one cannot be written.
+
+      if Is_Regular_File (Database) then
+         declare
+            Unused : Boolean;
+         begin
+            Delete_File (Database, Unused);
+         end;
+      end if;
+
+      Write_Database;
+   end Link;
+
+   ---------------
+   -- Read_Name --
+   ---------------
+
+   procedure Read_Name
+     (Data      : String;
+      Last      : Natural;
+      Position  : in out Positive;
+      First     : out Positive;
+      Name_Last : out Natural)
+   is
+      Name_Length : constant Natural := Read_Natural (Data, Last, Position);
+   begin
+      if Name_Length = 0 or else Name_Length > Last - Position + 1 then
+         raise GG_File_Error;
+      end if;
+
+      First := Position;
+      Name_Last := Position + Name_Length - 1;
+      Position := Name_Last + 1;
+   end Read_Name;
+
+   ------------------
+   -- Read_Natural --
+   ------------------
+
+   function Read_Natural
+     (Data : String; Last : Natural; Position : in out Positive)
+      return Natural
+   is
+      N : Unsigned_64;
+   begin
+      Read_Number (Data, Last, Position, N);
+
+      if N > Unsigned_64 (Natural'Last) then
+         raise GG_File_Error;
+      end if;
+
+      return Natural (N);
+   end Read_Natural;
+
+   -----------------
+   -- Read_Number --
+   -----------------
+
+   procedure Read_Number
+     (Data     : String;
+      Last     : Natural;
+      Position : in out Positive;
+      N        : out Unsigned_64)
+   is
+      Shift : Natural := 0;
+      Byte  : Unsigned_64;
+
+   begin
+      N := 0;
+
+      loop
+         if Position > Last or else Shift > 63 then
+            raise GG_File_Error;
+         end if;
+
+         Byte := Character'Pos (Data (Position));
+         Position := Position + 1;
+
+         N := N or Shift_Left (Byte and 16#7F#, Shift);
+         exit when Byte < 16#80#;
+         Shift := Shift + 7;
+      end loop;
+   end Read_Number;
+
+   ---------------
+   -- Read_Word --
+   ---------------
+
+   function Read_Word
+     (Data : String; Last : Natural; At_Position : Positive) return Natural
+   is
+      Result : Unsigned_32 := 0;
+   begin
+      if At_Position + 3 > Last then
+         raise GG_File_Error;
+      end if;
+
+      for J in reverse 0 .. 3 loop
+         Result :=
+           Shift_Left (Result, 8) or Character'Pos (Data (At_Position + J));
+      end loop;
+
+      if Result > Unsigned_32 (Natural'Last) then
+         raise GG_File_Error;
+      end if;
+
+      return Natural (Result);
+   end Read_Word;
+
+   ---------------
+   -- Unit_Name --
+   ---------------
+
+   function Unit_Name (File_Name : String) return String
+   is (Ada.Directories.Base_Name (File_Name));
+
+end GG_Files;
@@ -40,6 +40,9 @@ procedure Close_Semaphore_C (S : Semaphore)
    procedure Wait_Semaphore_C (S : Semaphore)
    with Import, Convention => C, External_Name => "wait_semaphore";
 
+   function Try_Wait_Semaphore_C (S : Semaphore) return int
+   with Import, Convention => C, External_Name => "try_wait_semaphore";
+
    procedure Release_Semaphore_C (S : Semaphore)
    with Import, Convention => C, External_Name => "release_semaphore";
 
@@ -91,6 +94,15 @@ procedure Release (S : in out Semaphore) is
       Release_Semaphore_C (S);
    end Release;
 
+   --------------
+   -- Try_Wait --
+   --------------
+
+   procedure Try_Wait (S : in out Semaphore; Success : out Boolean) is
+   begin
+      Success := Try_Wait_Semaphore_C (S) /= 0;
+   end Try_Wait;
+
    ----------
    -- Wait --
    ----------
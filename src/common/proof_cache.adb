@@ -0,0 +1,412 @@
+------------------------------------------------------------------------------
+--                                                                          --
+--                            GNATPROVE COMPONENTS                          --
+--                                                                          --
+--                          P R O O F _ C A C H E                           --
+--                                                                          --
+--                                 B o d y                                  --
+--                                                                          --
+--                       Copyright (C) 2025, AdaCore                        --
+--                                                                          --
+-- gnatprove is  free  software;  you can redistribute it and/or  modify it --
+-- under terms of the  GNU General Public License as published  by the Free --
+-- Software  Foundation;  either version 3,  or (at your option)  any later --
+-- version.  gnatprove is distributed  in the hope that  it will be useful, --
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- --
+-- TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public --
+-- License for  more details.  You should have  received  a copy of the GNU --
+-- General Public License  distributed with  gnatprove;  see file COPYING3. --
+-- If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the --
+-- license.                                                                 --
+--                                                                          --
+-- gnatprove is maintained by AdaCore (http://www.adacore.com)              --
+--                                                                          --
+------------------------------------------------------------------------------
+
+with Ada.Containers.Indefinite_Hashed_Maps;
+with Ada.Directories;
+with Ada.Strings.Fixed;
+with Ada.Strings.Hash;
+with GNAT.OS_Lib;     use GNAT.OS_Lib;
+with GNAT.SHA256;
+with GNATCOLL.Mmap;
+
+package body Proof_Cache is
+
+   function Parse_Cache_Spec (Info : String) return Cache_Spec;
+   --  @param Info a cache of the form file:directory or hostname:port
+   --  @return the corresponding cache specification. Raise Invalid_Cache_Spec
+   --    if Info is ill-formed.
+
+   procedure Hash_Commandline
+     (C : in out GNAT.SHA256.Context; Command : String_Lists.List);
+   --  @param C the hash context to be updated
+   --  @param Command the command name followed by its arguments
+   --  Compute a hash of the command line. This procedure only has special
+   --  handling for arguments of gnatwhy3 currently. This means that some
+   --  arguments which can be ignored are skipped, for others, instead of
+   --  the argument some other content is hashed.
+
+   procedure Hash_Binary (C : in out GNAT.SHA256.Context; Execname : String);
+   --  If the binary Fn is on the PATH and there is a file Fn.hash next to it,
+   --  we read that file and add it to the context.
+
+   procedure Hash_File (C : in out GNAT.SHA256.Context; Fn : String);
+   --  @param C the hash context to be updated
+   --  @param Fn the file to be hashed
+   --  Compute a hash of the file in argument
+
+   procedure Hash_Provers (C : in out GNAT.SHA256.Context; Provers : String);
+   --  @param C the hash context to be updated
+   --  @param Provers the value of switch --prover of gnatwhy3, a
+   --    comma-separated list of prover shortcuts
+   --  Hash the binary of each prover in the list as done for gnatwhy3 in
+   --  Hash_Binary, so that results are not reused after a prover upgrade.
+
+   package Digest_Maps is new
+     Ada.Containers.Indefinite_Hashed_Maps
+       (Key_Type        => String,
+        Element_Type    => GNAT.SHA256.Message_Digest,
+        Hash            => Ada.Strings.Hash,
+        Equivalent_Keys => "=");
+
+   Digests : Digest_Maps.Map;
+   --  Digests of the files hashed by Memoized_File_Digest in this process
+
+   function Memoized_File_Digest
+     (Fn : String) return GNAT.SHA256.Message_Digest;
+   --  @param Fn the file to be hashed
+   --  @return the digest of the contents of Fn, which is only computed once
+   --    per process. This is used for files which are hashed for every
+   --    proof job of a unit, like the why3 configuration file. They are not
+   --    expected to change during the analysis of the unit.
+
+   -----------------
+   -- Compute_Key --
+   -----------------
+
+   function Compute_Key
+     (Salt : String; Command : String_Lists.List; File : String)
+      return String
+   is
+      C : GNAT.SHA256.Context := GNAT.SHA256.Initial_Context;
+   begin
+
+      --  We first hash the salt
+
+      GNAT.SHA256.Update (C, Salt);
+
+      --  The file is hashed separately here, it always comes last on the
+      --  command line.
+
+      Hash_File (C, File);
+
+      --  Hash the rest of the command line
+
+      Hash_Commandline (C, Command);
+
+      --  Read the binary hash if present
+
+      if not Command.Is_Empty then
+         Hash_Binary (C, Command.First_Element);
+      end if;
+      return GNAT.SHA256.Digest (C);
+   end Compute_Key;
+
+   --------------------
+   -- File_Cache_Dir --
+   --------------------
+
+   function File_Cache_Dir (Info : String) return String is
+   begin
+      for Spec of Parse_Cache_Specs (Info) loop
+         if Spec.Is_File then
+            return To_String (Spec.Name);
+         end if;
+      end loop;
+      return "";
+   exception
+      when Invalid_Cache_Spec =>
+         return "";
+   end File_Cache_Dir;
+
+   -----------------
+   -- File_Digest --
+   -----------------
+
+   function File_Digest (Fn : String) return String is
+      C : GNAT.SHA256.Context := GNAT.SHA256.Initial_Context;
+   begin
+      Hash_File (C, Fn);
+      return GNAT.SHA256.Digest (C);
+   end File_Digest;
+
+   -----------------
+   -- Hash_Binary --
+   -----------------
+
+   procedure Hash_Binary (C : in out GNAT.SHA256.Context; Execname : String) is
+
+      function Compute_Hash_Filename (Exec : String) return String;
+      --  Compute the hashfile name from the executable name by locating the
+      --  file in the PATH, then adding ".hash", or replacing the suffix with
+      --  ".hash", if any.
+
+      ---------------------------
+      -- Compute_Hash_Filename --
+      ---------------------------
+
+      function Compute_Hash_Filename (Exec : String) return String is
+         Fn : String_Access := GNAT.OS_Lib.Locate_Exec_On_Path (Exec);
+      begin
+         if Fn = null then
+            return "";
+         end if;
+         declare
+            Ext : constant String := Ada.Directories.Extension (Fn.all);
+         begin
+            return
+               Result : constant String :=
+                 (if Ext = ""
+                  then Fn.all & ".hash"
+                  else Fn (Fn'First .. Fn'Last - Ext'Length) & ".hash")
+            do
+               Free (Fn);
+            end return;
+         end;
+      end Compute_Hash_Filename;
+
+      Hash_Fn : constant String := Compute_Hash_Filename (Execname);
+   begin
+      if Hash_Fn /= "" and then Ada.Directories.Exists (Hash_Fn) then
+         GNAT.SHA256.Update (C, Memoized_File_Digest (Hash_Fn));
+      end if;
+   end Hash_Binary;
+
+   ----------------------
+   -- Hash_Commandline --
+   ----------------------
+
+   procedure Hash_Commandline
+     (C : in out GNAT.SHA256.Context; Command : String_Lists.List)
+   is
+      use String_Lists;
+      Position : Cursor := Command.First;
+   begin
+      while Has_Element (Position) loop
+         declare
+            Arg : constant String := Element (Position);
+         begin
+            Next (Position);
+            if Arg = "-j" then
+               Next (Position);
+            elsif Arg = "--debug" or else Arg = "--force" or else Arg = "-f"
+            then
+               null;
+            elsif Arg = "--why3-conf" and then Has_Element (Position) then
+               GNAT.SHA256.Update
+                 (C, Memoized_File_Digest (Element (Position)));
+               Next (Position);
+            elsif Arg = "--prover" and then Has_Element (Position) then
+               GNAT.SHA256.Update (C, Arg);
+               GNAT.SHA256.Update (C, Element (Position));
+               Hash_Provers (C, Element (Position));
+               Next (Position);
+            else
+               GNAT.SHA256.Update (C, Arg);
+            end if;
+         end;
+      end loop;
+   end Hash_Commandline;
+
+   ---------------
+   -- Hash_File --
+   ---------------
+
+   procedure Hash_File (C : in out GNAT.SHA256.Context; Fn : String) is
+      use GNATCOLL.Mmap;
+      File   : Mapped_File;
+      Region : Mapped_Region;
+
+   begin
+      File := Open_Read (Fn);
+
+      Read (File, Region);
+
+      declare
+         S : String (1 .. Integer (Length (File)));
+         for S'Address use Data (Region).all'Address;
+         --  A fake string directly mapped onto the file contents
+
+      begin
+         GNAT.SHA256.Update (C, S);
+      end;
+
+      Free (Region);
+
+      Close (File);
+   end Hash_File;
+
+   ------------------
+   -- Hash_Provers --
+   ------------------
+
+   procedure Hash_Provers (C : in out GNAT.SHA256.Context; Provers : String)
+   is
+      function Executable (Shortcut : String) return String;
+      --  Return the name of the executable of the prover with Shortcut, as
+      --  given in the prover configuration file gnatprove.conf.
+
+      ----------------
+      -- Executable --
+      ----------------
+
+      function Executable (Shortcut : String) return String is
+         Suffix : constant String := "_ce";
+      begin
+         if Shortcut = "altergo" then
+            return "alt-ergo";
+         elsif Shortcut'Length > Suffix'Length
+           and then Ada.Strings.Fixed.Tail (Shortcut, Suffix'Length) = Suffix
+         then
+            return Shortcut (Shortcut'First .. Shortcut'Last - Suffix'Length);
+         else
+            return Shortcut;
+         end if;
+      end Executable;
+
+      First : Positive := Provers'First;
+      Comma : Natural;
+
+      --  Start of processing for Hash_Provers
+
+   begin
+      loop
+         Comma :=
+           Ada.Strings.Fixed.Index (Provers (First .. Provers'Last), ",");
+         declare
+            Last : constant Natural :=
+              (if Comma = 0 then Provers'Last else Comma - 1);
+         begin
+            if Last >= First then
+               Hash_Binary (C, Executable (Provers (First .. Last)));
+            end if;
+         end;
+         exit when Comma = 0;
+         First := Comma + 1;
+      end loop;
+   end Hash_Provers;
+
+   --------------------------
+   -- Memoized_File_Digest --
+   --------------------------
+
+   function Memoized_File_Digest
+     (Fn : String) return GNAT.SHA256.Message_Digest
+   is
+      Position : constant Digest_Maps.Cursor := Digests.Find (Fn);
+   begin
+      if Digest_Maps.Has_Element (Position) then
+         return Digest_Maps.Element (Position);
+      end if;
+
+      declare
+         C : GNAT.SHA256.Context := GNAT.SHA256.Initial_Context;
+      begin
+         Hash_File (C, Fn);
+
+         return Digest : constant GNAT.SHA256.Message_Digest :=
+           GNAT.SHA256.Digest (C)
+         do
+            Digests.Insert (Fn, Digest);
+         end return;
+      end;
+   end Memoized_File_Digest;
+
+   ----------------------
+   -- Parse_Cache_Spec --
+   ----------------------
+
+   function Parse_Cache_Spec (Info : String) return Cache_Spec is
+      Colon : constant Natural := Ada.Strings.Fixed.Index (Info, ":");
+
+      Wrong_Port_Msg : constant String :=
+        ("port value should be an integer between 1 and 65535");
+
+   begin
+      if Colon = 0 then
+         raise Invalid_Cache_Spec
+           with "the expected format of option --memcached-server "
+                & "is hostname:portnumber, but no colon was found";
+      end if;
+      declare
+         First  : String renames Info (Info'First .. Colon - 1);
+         Second : String renames Info (Colon + 1 .. Info'Last);
+         Port   : Natural;
+      begin
+         if First'Length = 4 and then First = "file" then
+            if not Ada.Directories.Exists (Second) then
+               raise Invalid_Cache_Spec
+                 with "file caching: no such directory: " & Second;
+            end if;
+            return
+              (Is_File => True,
+               Name    => To_Unbounded_String (Second),
+               Port    => 0);
+         else
+            begin
+               Port := Natural'Value (Second);
+            exception
+               when Constraint_Error =>
+                  raise Invalid_Cache_Spec with Wrong_Port_Msg;
+            end;
+
+            if Port not in 1 .. 65535 then
+               raise Invalid_Cache_Spec with Wrong_Port_Msg;
+            end if;
+
+            return
+              (Is_File => False,
+               Name    => To_Unbounded_String (First),
+               Port    => Port);
+         end if;
+      end;
+   end Parse_Cache_Spec;
+
+   -----------------------
+   -- Parse_Cache_Specs --
+   -----------------------
+
+   function Parse_Cache_Specs (Info : String) return Cache_Spec_Vectors.Vector
+   is
+      Result     : Cache_Spec_Vectors.Vector;
+      First      : Positive := Info'First;
+      Comma      : Natural;
+      File_Found : Boolean := False;
+   begin
+      loop
+         Comma := Ada.Strings.Fixed.Index (Info (First .. Info'Last), ",");
+         declare
+            Last : constant Natural :=
+              (if Comma = 0 then Info'Last else Comma - 1);
+            Spec : constant Cache_Spec :=
+              Parse_Cache_Spec (Info (First .. Last));
+         begin
+            if Spec.Is_File then
+               if File_Found then
+                  raise Invalid_Cache_Spec
+                    with
+                      "option --memcached-server accepts at most one file "
+                      & "cache";
+               end if;
+               File_Found := True;
+            end if;
+            Result.Append (Spec);
+         end;
+         exit when Comma = 0;
+         First := Comma + 1;
+      end loop;
+      return Result;
+   end Parse_Cache_Specs;
+
+end Proof_Cache;
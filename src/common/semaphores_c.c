@@ -25,6 +25,7 @@
 
 #ifndef _WIN32
 
+#include <errno.h>
 #include <fcntl.h>
 #include <semaphore.h>
 #include <stdio.h>
@@ -62,6 +63,16 @@ void wait_semaphore (sem_t *s) {
   }
 }
 
+int try_wait_semaphore (sem_t *s) {
+  if (sem_trywait(s) == 0) {
+    return 1;
+  } else if (errno == EAGAIN) {
+    return 0;
+  }
+  perror("failed to wait for semaphore");
+  exit(1);
+}
+
 void release_semaphore (sem_t *s) {
   if (sem_post(s) == -1) {
     perror("failed to release semaphore");
@@ -114,6 +125,17 @@ void wait_semaphore (HANDLE s) {
   }
 }
 
+int try_wait_semaphore (HANDLE s) {
+  DWORD waitresult = WaitForSingleObject(s, 0);
+  if (waitresult == WAIT_OBJECT_0) {
+    return 1;
+  } else if (waitresult == WAIT_TIMEOUT) {
+    return 0;
+  }
+  printf("failed to wait for semaphore\n");
+  exit(1);
+}
+
 void release_semaphore (HANDLE s) {
   if (!ReleaseSemaphore(s, 1, NULL)) {
     printf("failed to release semaphore\n");
@@ -353,7 +353,9 @@ function To_String (S : Scopes) return String;
        (Index_Type   => Natural,
         Element_Type => Scopes,
         "="          => "=");
-   --  An execution environment is a stack of scopes
+   --  An execution environment is a stack of scopes. The innermost scope is
+   --  the last element, so that entering and leaving a scope does not move
+   --  (and copy the maps of) the enclosing scopes.
 
    function To_String (E : Environments.Vector) return String
    with Unreferenced;
@@ -615,7 +617,7 @@ function All_Located_Values return Node_To_Node_To_Value.Map is
       use Node_To_Node_To_Value;
    begin
       return Res : Node_To_Node_To_Value.Map do
-         for Scope of Ctx.Env loop
+         for Scope of reverse Ctx.Env loop
             for Cu in Scope.Located_Values.Iterate loop
                Res.Insert (Key (Cu), Element (Cu));
             end loop;
@@ -1570,7 +1572,7 @@ procedure Evaluate_Attribute_Prefix_Values
 
          begin
             if Attr_Name = Name_Old then
-               Ctx.Env (Ctx.Env.First).Old_Attrs.Insert
+               Ctx.Env (Ctx.Env.Last).Old_Attrs.Insert
                  (P, Val, Position, Inserted);
 
                --  Also include values for referenced variables if any, they
@@ -1586,7 +1588,7 @@ procedure Evaluate_Attribute_Prefix_Values
                      Var := Get_Direct_Mapping_Id (V);
                      Val := Find_Binding (Var, False);
                      if Val /= null then
-                        Ctx.Env (Ctx.Env.First).Old_Attrs.Insert
+                        Ctx.Env (Ctx.Env.Last).Old_Attrs.Insert
                           (Var, Val.all, Position, Inserted);
                      end if;
                   end loop;
@@ -1594,7 +1596,7 @@ procedure Evaluate_Attribute_Prefix_Values
 
             else
                pragma Assert (Attr_Name = Name_Loop_Entry);
-               Ctx.Env (Ctx.Env.First).Loop_Entry_Attrs.Insert
+               Ctx.Env (Ctx.Env.Last).Loop_Entry_Attrs.Insert
                  (P, Val, Position, Inserted);
 
                --  Also include values for referenced variables if any, they
@@ -1611,7 +1613,7 @@ procedure Evaluate_Attribute_Prefix_Values
                         Var := Get_Direct_Mapping_Id (V);
                         Val := Find_Binding (Var, False);
                         if Val /= null then
-                           Ctx.Env (Ctx.Env.First).Loop_Entry_Attrs.Insert
+                           Ctx.Env (Ctx.Env.Last).Loop_Entry_Attrs.Insert
                              (Var, Val.all, Position, Inserted);
                         end if;
                      end if;
@@ -1633,7 +1635,7 @@ function Find_Binding
       C : Entity_Bindings.Cursor;
       B : Value_Access;
    begin
-      for Scope of Ctx.Env loop
+      for Scope of reverse Ctx.Env loop
          C := Scope.Bindings.Find (E);
 
          if Entity_Bindings.Has_Element (C) then
@@ -1672,7 +1674,7 @@ function Find_Loop_Entry_Value
       --  first scope of the environment, in case of local declare blocks
       --  inside the loop.
 
-      for Scop of Ctx.Env loop
+      for Scop of reverse Ctx.Env loop
          if Scop.Loop_Id = Loop_Id then
             Pos := Scop.Loop_Entry_Attrs.Find (N);
             if Has_Element (Pos) then
@@ -1693,7 +1695,7 @@ function Find_Loop_Entry_Value
    function Find_Old_Value (N : Node_Id) return Opt_Value_Type is
       use Node_To_Value;
       Pos : constant Node_To_Value.Cursor :=
-        Ctx.Env (Ctx.Env.First).Old_Attrs.Find (N);
+        Ctx.Env (Ctx.Env.Last).Old_Attrs.Find (N);
    begin
       if Has_Element (Pos) then
          return (True, Element (Pos));
@@ -1919,7 +1921,7 @@ procedure Init_Global
               Use_Gnattest => False,
               Origin       => Origin));
 
-      Ctx.Env (Ctx.Env.Last).Bindings.Insert (N, Val);
+      Ctx.Env (Ctx.Env.First).Bindings.Insert (N, Val);
 
       Ctx.Initial_Values.Include (N, Copy (Val.all));
 
@@ -2127,16 +2129,16 @@ procedure Iterate_Scheme_Spec
                      then Array_Val.Array_Values (Curr).all
                      else Array_Val.Array_Others.all));
             begin
-               Set_Value (Ctx.Env (Ctx.Env.First), Id, new Value_Type'(Val));
+               Set_Value (Ctx.Env (Ctx.Env.Last), Id, new Value_Type'(Val));
             end;
 
             Iteration.all;
             Curr := Curr + Step;
          end loop;
-         Ctx.Env (Ctx.Env.First).Bindings.Exclude (Id);
+         Ctx.Env (Ctx.Env.Last).Bindings.Exclude (Id);
       exception
          when Exn_RAC_Exit =>
-            Ctx.Env (Ctx.Env.First).Bindings.Exclude (Id);
+            Ctx.Env (Ctx.Env.Last).Bindings.Exclude (Id);
 
             --  Do not remove the loop parameter from the context in case of
             --  RAC failure, as the value will be needed for counterexample
@@ -2147,7 +2149,7 @@ procedure Iterate_Scheme_Spec
             --  The call to Iteration will raise local exception Break to
             --  return early from the iteration.
          when others =>
-            Ctx.Env (Ctx.Env.First).Bindings.Exclude (Id);
+            Ctx.Env (Ctx.Env.Last).Bindings.Exclude (Id);
             raise;
       end;
    end Iterate_Scheme_Spec;
@@ -2539,7 +2541,7 @@ procedure Rem_Stack_Height_Pop is
             Get_Pragma (E, Pragma_Contract_Cases));
       end if;
 
-      Ctx.Env.Prepend (Sc);
+      Ctx.Env.Append (Sc);
 
       --  Store value of the 'Old prefixes
       Collect_Attr_Parts (Posts, Snames.Name_Old, Old_Nodes);
@@ -2598,7 +2600,7 @@ procedure Rem_Stack_Height_Pop is
 
       --  Add result attribute for checking the postcondition
       if Res.Present then
-         Ctx.Env (Ctx.Env.First).Bindings.Insert
+         Ctx.Env (Ctx.Env.Last).Bindings.Insert
            (E, new Value_Type'(Res.Content));
       end if;
 
@@ -2606,11 +2608,11 @@ procedure Rem_Stack_Height_Pop is
 
       --  Cleanup
       if Res.Present then
-         Ctx.Env (Ctx.Env.First).Bindings.Delete (E);
+         Ctx.Env (Ctx.Env.Last).Bindings.Delete (E);
       end if;
 
-      Sc := Ctx.Env (Ctx.Env.First);
-      Ctx.Env.Delete_First;
+      Sc := Ctx.Env (Ctx.Env.Last);
+      Ctx.Env.Delete_Last;
       if not Is_Main and then Present (N) then
          Copy_Out_Parameters (N, Sc);
 
@@ -2680,7 +2682,7 @@ procedure Process_Param (Formal : Entity_Id; Actual : Node_Id) is
                   end if;
                end;
             end loop;
-            Ctx.Env (Ctx.Env.First).Located_Values.Include (N, Ctx_Values);
+            Ctx.Env (Ctx.Env.Last).Located_Values.Include (N, Ctx_Values);
          end;
       end if;
 
@@ -2808,7 +2810,7 @@ procedure Update_Constrained
                end if;
 
                Set_Value
-                 (Ctx.Env (Ctx.Env.First),
+                 (Ctx.Env (Ctx.Env.Last),
                   Defining_Identifier (Decl),
                   new Value_Type'(V));
 
@@ -2819,7 +2821,7 @@ procedure Update_Constrained
                   Ctx_Values : Node_To_Value.Map;
                begin
                   Ctx_Values.Insert (Defining_Identifier (Decl), Copy (V));
-                  Ctx.Env (Ctx.Env.First).Located_Values.Include
+                  Ctx.Env (Ctx.Env.Last).Located_Values.Include
                     (Decl, Ctx_Values);
                end;
             end;
@@ -3064,7 +3066,7 @@ procedure Iterated_Component
             --  Add a new scope for the for loop in order to store the
             --  iteration variable.
 
-            Ctx.Env.Prepend (Scopes'(others => <>));
+            Ctx.Env.Append (Scopes'(others => <>));
 
             while Present (Choice) loop
                Check_Fuel_Decrease (Ctx.Fuel);
@@ -3089,7 +3091,7 @@ procedure Iterated_Component
                         Iter_Param := Int_Value (Curr, Etype (Def_Id));
 
                         Set_Value
-                          (Ctx.Env (Ctx.Env.First),
+                          (Ctx.Env (Ctx.Env.Last),
                            Def_Id,
                            new Value_Type'(Iter_Param));
 
@@ -3105,7 +3107,7 @@ procedure Iterated_Component
                      Choice_Val : constant Value_Type := RAC_Expr (Choice);
                   begin
                      Set_Value
-                       (Ctx.Env (Ctx.Env.First),
+                       (Ctx.Env (Ctx.Env.Last),
                         Def_Id,
                         new Value_Type'(Choice_Val));
 
@@ -3117,7 +3119,7 @@ procedure Iterated_Component
                Next (Choice);
             end loop;
 
-            Ctx.Env.Delete_First;
+            Ctx.Env.Delete_Last;
          end Iterated_Component;
 
          --  Local variables
@@ -5423,7 +5425,7 @@ procedure Assignment_To_Slice (A, RHS : Value_Access) is
                     Find_Binding (Lhs_Root).all;
                begin
                   Ctx_Values.Insert (Lhs_Root, Copy (Lhs_Value));
-                  Ctx.Env (Ctx.Env.First).Located_Values.Include
+                  Ctx.Env (Ctx.Env.Last).Located_Values.Include
                     (N, Ctx_Values);
                end;
             end;
@@ -5468,7 +5470,7 @@ procedure Iteration is
                   --  Clear counterexample values at each iteration to avoid
                   --  mixing them up.
 
-                  Ctx.Env (Ctx.Env.First).Located_Values.Clear;
+                  Ctx.Env (Ctx.Env.Last).Located_Values.Clear;
                end Iteration;
 
                First_Iter_Save  : constant Boolean := Ctx.First_Loop_Iter;
@@ -5478,7 +5480,7 @@ procedure Iteration is
                --  Add a new scope for the loop in order to store Loop_Entry
                --  attributes.
 
-               Ctx.Env.Prepend
+               Ctx.Env.Append
                  (Scopes'(Loop_Id => Entity (Identifier (N)), others => <>));
 
                --  Collect prefixes of all 'Loop_Entry attribute uses and store
@@ -5547,7 +5549,7 @@ procedure Iteration is
                end if;
 
                Ctx.First_Loop_Iter := First_Iter_Save;
-               Ctx.Env.Delete_First;
+               Ctx.Env.Delete_Last;
             end;
 
          when N_Exit_Statement                                   =>
@@ -5562,10 +5564,10 @@ procedure Iteration is
             end if;
 
          when N_Block_Statement                                  =>
-            Ctx.Env.Prepend (Scopes'(others => <>));
+            Ctx.Env.Append (Scopes'(others => <>));
             RAC_Decls (Declarations (N));
             RAC_Node (Handled_Statement_Sequence (N));
-            Ctx.Env.Delete_First;
+            Ctx.Env.Delete_Last;
 
          when N_Case_Statement                                   =>
             declare
@@ -5812,7 +5814,7 @@ function To_String (E : Environments.Vector) return String is
       Res   : Unbounded_String;
       First : Boolean := True;
    begin
-      for S of E loop
+      for S of reverse E loop
          if not First then
             Append (Res, "; ");
          end if;
@@ -5832,7 +5834,7 @@ procedure Update_Value
    is
       BC : Entity_Bindings.Cursor;
    begin
-      for Scope of Env loop
+      for Scope of reverse Env loop
          BC := Scope.Bindings.Find (E);
 
          if Entity_Bindings.Has_Element (BC) then
@@ -5849,7 +5851,7 @@ procedure Update_Value
                and then not Is_Access_Variable (Etype (E))
              then not Has_Variable_Input (E));
 
-      Env (Env.Last).Bindings.Insert (E, V);
+      Env (Env.First).Bindings.Insert (E, V);
    end Update_Value;
 
    -------------------
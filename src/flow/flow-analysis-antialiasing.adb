@@ -26,6 +26,7 @@
 with Errout_Wrapper;            use Errout_Wrapper;
 with Flow_Classwide;            use Flow_Classwide;
 with Flow_Error_Messages;       use Flow_Error_Messages;
+with Flow_Journal;
 with Flow_Utility;              use Flow_Utility;
 with Namet;                     use Namet;
 with Nlists;                    use Nlists;
@@ -1184,6 +1185,7 @@ function Visible_Globals (FS : Flow_Id_Sets.Set) return Node_Sets.Set is
       end loop;
 
       Aliasing_Status.Insert (N, Status);
+      Flow_Journal.Record_Aliasing_Status (N, Status);
 
    --  ??? Need to check for aliasing between abstract state and computed
    --  globals.
@@ -1205,6 +1207,17 @@ function Get_Aliasing_Status_For_Proof
          else Unchecked);
    end Get_Aliasing_Status_For_Proof;
 
+   -------------------------
+   -- Set_Aliasing_Status --
+   -------------------------
+
+   procedure Set_Aliasing_Status
+     (N : Node_Id; Status : Aliasing_Check_Result)
+   is
+   begin
+      Aliasing_Status.Insert (N, Status);
+   end Set_Aliasing_Status;
+
    --  Debug routines, localised to declutter code coverage analysis
    pragma Annotate (Xcov, Exempt_On, "Compilation-dependent debug code");
    ----------------
@@ -1813,6 +1813,14 @@ function Other_Field_Is_Effective
          return False;
       end Other_Field_Is_Effective;
 
+      Export_Use_Sources : constant Flow_Graphs.Vertex_Bitset :=
+        FA.PDG.Non_Trivial_Path_Sources (Is_Final_Use_Any_Export'Access);
+      Final_Use_Sources  : constant Flow_Graphs.Vertex_Bitset :=
+        FA.PDG.Non_Trivial_Path_Sources (Is_Any_Final_Use'Access);
+      --  Vertices of the PDG with a non-trivial path to a final use of an
+      --  export (or to any final use), computed once for the whole graph
+      --  instead of with a traversal from each vertex.
+
       --  Start of processing for Find_Ineffective_Statements
 
    begin
@@ -1844,8 +1852,7 @@ function Other_Field_Is_Effective
 
                if
                --  Basic check here
-                 not FA.PDG.Non_Trivial_Path_Exists
-                       (V, Is_Final_Use_Any_Export'Access)
+                 not Flow_Graphs.Contains (Export_Use_Sources, V)
                  and then
 
                  --  We only want to find ineffective statements within code
@@ -1864,8 +1871,7 @@ function Other_Field_Is_Effective
                  --  has an effect on any final use (export or otherwise).
                  (if FA.Kind = Kind_Package and then No (FA.Initializes_N)
                   then
-                    not FA.PDG.Non_Trivial_Path_Exists
-                          (V, Is_Any_Final_Use'Access))
+                    not Flow_Graphs.Contains (Final_Use_Sources, V))
                  and then
 
                  --  Suppression for vertices that talk about a variable that
@@ -177,6 +177,26 @@ function Flow_Equivalent (F : Flow_Id) return Flow_Id
 
       DM : Dependency_Maps.Map := Dependency_Maps.Empty_Map;
 
+      function Is_Input (V : Flow_Graphs.Vertex_Id) return Boolean
+      is (In_Vertices.Contains (V));
+
+      function Is_Output (V : Flow_Graphs.Vertex_Id) return Boolean
+      is (Out_Vertices.Contains (V));
+
+      procedure Add_Dependency (V_In, V_Out : Flow_Graphs.Vertex_Id);
+      --  Record that the output of V_Out depends on the input of V_In
+
+      --------------------
+      -- Add_Dependency --
+      --------------------
+
+      procedure Add_Dependency (V_In, V_Out : Flow_Graphs.Vertex_Id) is
+         F_In : constant Flow_Id := Flow_Equivalent (FA.PDG.Get_Key (V_In));
+      begin
+         DM (Flow_Equivalent (FA.PDG.Get_Key (V_Out))).Include (F_In);
+         Unused_Inputs.Exclude (F_In);
+      end Add_Dependency;
+
       --  Start of processing for Compute_Dependency_Relation
 
    begin
@@ -254,37 +274,22 @@ function V_Initial return Flow_Graphs.Vertex_Id
          end;
       end loop;
 
-      --  Determine dependencies
+      --  Initialize map entries with empty sets; several out vertices may
+      --  share the same entry.
 
       for V_Out of Out_Vertices loop
-         declare
-            F_In  : Flow_Id;
-            F_Out : constant Flow_Id :=
-              Flow_Equivalent (FA.PDG.Get_Key (V_Out));
-
-            --  Compute dependencies (and filter out local variables)
-            Deps : constant Vertex_Sets.Set :=
-              Internal_Dependency (FA => FA, V_Final => V_Out, IPFA => False)
-              and In_Vertices;
-
-            F_Out_Position : Dependency_Maps.Cursor;
-            Dummy          : Boolean;
-            --  Dummy variables required by the container API
-
-         begin
-            --  Initialize map entry with empty set or do nothing if an entry
-            --  is already there.
-            DM.Insert
-              (Key => F_Out, Position => F_Out_Position, Inserted => Dummy);
+         DM.Include
+           (Flow_Equivalent (FA.PDG.Get_Key (V_Out)), Flow_Id_Sets.Empty_Set);
+      end loop;
 
-            for V_In of Deps loop
-               F_In := Flow_Equivalent (FA.PDG.Get_Key (V_In));
+      --  Determine dependencies, i.e. the inputs from which there is a path
+      --  to each output (which filters out local variables), for all outputs
+      --  at once rather than with a traversal from each of them.
 
-               DM (F_Out_Position).Include (F_In);
-               Unused_Inputs.Exclude (F_In);
-            end loop;
-         end;
-      end loop;
+      FA.PDG.Non_Trivial_Paths
+        (Is_Source => Is_Input'Access,
+         Is_Target => Is_Output'Access,
+         Process   => Add_Dependency'Access);
 
       DM.Include (Null_Flow_Id, Unused_Inputs - Out_Discrim);
 
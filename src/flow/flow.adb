@@ -45,6 +45,7 @@
 with Flow_Generated_Globals.Traversal; use Flow_Generated_Globals.Traversal;
 with Flow_Generated_Globals.Phase_2;   use Flow_Generated_Globals.Phase_2;
 with Flow_Error_Messages;              use Flow_Error_Messages;
+with Flow_Journal;
 with Flow_Refinement;                  use Flow_Refinement;
 with Flow_Utility;                     use Flow_Utility;
 with Gnat2Why.Assumptions;             use Gnat2Why.Assumptions;
@@ -1504,6 +1505,15 @@ procedure Debug_GG_Source is
          Debug (Debug_Print_Intermediates, FA.CDG, "cdg");
          Debug (Debug_Print_Intermediates, FA.DDG, "ddg");
          Debug (Debug_Print_PDG, FA.PDG, "pdg");
+
+         --  The graphs are complete and analysis only queries them, so
+         --  switch them to the compact layout.
+
+         FA.CFG.Compact;
+         FA.CDG.Compact;
+         FA.DDG.Compact;
+         FA.TDG.Compact;
+         FA.PDG.Compact;
       end if;
 
       pragma Annotate (Xcov, Exempt_On, "Debugging code");
@@ -1706,21 +1716,21 @@ procedure Flow_Analyse_CUnit
       --  All analysis results are stashed here in case we need them later
       --  (e.g. for inter-procedural flow analysis).
 
-      Success : Boolean;
-
-   begin
-      Found_Error := False;
-
-      Check_Handler_Accesses;
-      Check_Specification_Contracts;
+      procedure Analyse (FA : in out Flow_Analysis_Graphs);
+      --  Analyse graphs of a single entity and produce error messages
 
-      --  Process entities and construct graphs if necessary
-      Build_Graphs_For_Analysis (FA_Graphs => FA_Graphs);
+      procedure Analyse_In_Parallel (Success : out Boolean);
+      --  Distribute the analysis of graphs among flow analysis workers, if
+      --  enabled. Success is False if the graphs still need to be analysed
+      --  sequentially.
 
-      --  ??? Perform interprocedural analysis
+      -------------
+      -- Analyse --
+      -------------
 
-      --  Analyse graphs and produce error messages
-      for FA of FA_Graphs loop
+      procedure Analyse (FA : in out Flow_Analysis_Graphs) is
+         Success : Boolean;
+      begin
          pragma Annotate (Xcov, Exempt_On, "Debugging code");
          if Gnat2Why_Args.Flow_Advanced_Debug then
             Write_Line
@@ -1902,11 +1912,91 @@ procedure Flow_Analyse_CUnit
                      Severity => Info_Kind);
                end if;
          end case;
+      end Analyse;
+
+      -------------------------
+      -- Analyse_In_Parallel --
+      -------------------------
+
+      procedure Analyse_In_Parallel (Success : out Boolean) is
+         Count : constant Natural := Natural (FA_Graphs.Length);
+
+         Graphs : array (1 .. Count) of Analysis_Maps.Cursor;
+         --  Graphs in the order in which they are analysed sequentially
+
+         procedure Analyse_Graphs (Index : Positive);
+         --  Analyse graphs with the given index
+
+         --------------------
+         -- Analyse_Graphs --
+         --------------------
+
+         procedure Analyse_Graphs (Index : Positive) is
+         begin
+            Analyse (FA_Graphs (Graphs (Index)));
+         end Analyse_Graphs;
+
+         procedure Analyse_In_Workers is new
+           Flow_Journal.Analyse_In_Workers (Analyse_Graphs);
+
+         C : Analysis_Maps.Cursor := FA_Graphs.First;
+
+         --  Start of processing for Analyse_In_Parallel
+
+      begin
+         --  Debug output is only produced by sequential analysis
+
+         if Gnat2Why_Args.Flow_Jobs = 1
+           or else Count < 2
+           or else Gnat2Why_Args.Debug_Mode
+           or else Gnat2Why_Args.Flow_Advanced_Debug
+         then
+            Success := False;
+            return;
+         end if;
+
+         for Index in Graphs'Range loop
+            Graphs (Index) := C;
+            Analysis_Maps.Next (C);
+         end loop;
+
+         Analyse_In_Workers
+           (Count       => Count,
+            Max_Workers => Positive'Min (Gnat2Why_Args.Flow_Jobs, Count),
+            Success     => Success);
+      end Analyse_In_Parallel;
 
-         --  Keep track of entities whose flow analysis has been "skipped",
-         --  i.e. which actually have been analysed, but we only emitted
-         --  error and not info/warning/check messages.
+      Success : Boolean;
+
+      --  Start of processing for Flow_Analyse_CUnit
 
+   begin
+      Found_Error := False;
+
+      Check_Handler_Accesses;
+      Check_Specification_Contracts;
+
+      --  Process entities and construct graphs if necessary
+      Build_Graphs_For_Analysis (FA_Graphs => FA_Graphs);
+
+      --  ??? Perform interprocedural analysis
+
+      --  Analyse graphs and produce error messages, distributing the work
+      --  among flow analysis workers if possible.
+
+      Analyse_In_Parallel (Success);
+
+      if not Success then
+         for FA of FA_Graphs loop
+            Analyse (FA);
+         end loop;
+      end if;
+
+      --  Keep track of entities whose flow analysis has been "skipped", i.e.
+      --  which actually have been analysed, but we only emitted error and not
+      --  info/warning/check messages.
+
+      for FA of FA_Graphs loop
          if Has_Skip_Flow_And_Proof_Annotation (FA.Spec_Entity) then
             Skipped_Flow_And_Proof.Insert (FA.Spec_Entity);
          end if;
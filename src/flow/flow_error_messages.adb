@@ -37,6 +37,7 @@
 with Errout;
 with Erroutc;
 with Flow_Generated_Globals.Phase_2;
+with Flow_Journal;
 with Flow_Refinement;           use Flow_Refinement;
 with Flow_Utility;              use Flow_Utility;
 with Gnat2Why.Expr.Loops;
@@ -387,6 +388,7 @@ procedure Error_Msg_Flow
         (New_Item => Msg_Str, Position => Dummy, Inserted => Inserted);
 
       if Inserted then
+         Flow_Journal.Start_Flow_Msg (Msg_Str);
 
          --  If we are in mode check_all then we just report messages related
          --  to marking (filtered by Error_Kind severity) and that is why we
@@ -492,6 +494,8 @@ procedure Error_Msg_Flow
             Add_Json_Msg (Flow_Msgs, Result, Msg_Id);
          end if;
 
+         Flow_Journal.End_Flow_Msg;
+
       else
          Suppressed := True;
       end if;
@@ -1012,6 +1016,7 @@ function Fresh_Trace_File return String is
         Unit_Name & "__flow__" & Image (File_Counter, 1) & ".trace";
    begin
       File_Counter := File_Counter + 1;
+      Flow_Journal.Record_Trace_File (Result);
       return Result;
    end Fresh_Trace_File;
 
@@ -3880,6 +3885,8 @@ procedure Wrap_Error_Msg (Msg : Message) is
       --  Beginning of processing for Print_Regular_Msg
 
    begin
+      Flow_Journal.Record_Message_Id (Id);
+
       case Gnat2Why_Args.Output_Mode is
          --  In brief mode, just print the check message
 
@@ -4308,6 +4315,26 @@ function Proved_Message (Node : Node_Id; Kind : VC_Kind) return String is
       return Inst (Node, Kind);
    end Proved_Message;
 
+   -----------------------
+   -- Register_Flow_Msg --
+   -----------------------
+
+   procedure Register_Flow_Msg (Key : String; Inserted : out Boolean) is
+      Dummy : String_Sets.Cursor;
+   begin
+      Flow_Msgs_Set.Insert
+        (New_Item => Key, Position => Dummy, Inserted => Inserted);
+   end Register_Flow_Msg;
+
+   ----------------------
+   -- Skip_Trace_Files --
+   ----------------------
+
+   procedure Skip_Trace_Files (Count : Natural) is
+   begin
+      File_Counter := Natural'Max (File_Counter, Count);
+   end Skip_Trace_Files;
+
    ----------------
    -- Substitute --
    ----------------
@@ -4578,6 +4605,12 @@ function Substitute_Message
       return To_String (M);
    end Substitute_Message;
 
+   ----------------------
+   -- Trace_File_Count --
+   ----------------------
+
+   function Trace_File_Count return Natural is (File_Counter);
+
    -----------------
    -- VC_Messsage --
    -----------------
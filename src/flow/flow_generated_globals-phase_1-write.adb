@@ -21,22 +21,55 @@
 --                                                                          --
 ------------------------------------------------------------------------------
 
+with Ada.Containers.Indefinite_Hashed_Maps;
+with Ada.Strings.Hash;
+with Ada.Strings.Unbounded; use Ada.Strings.Unbounded;
+with GNAT.OS_Lib;           use GNAT.OS_Lib;
+with Interfaces;            use Interfaces;
+
 with Common_Iterators; use Common_Iterators;
 with Elists;           use Elists;
-with Lib.Util;         use Lib.Util;
 with Sem_Util;         use Sem_Util;
 with Stand;            use Stand;
 
+with Call;         use Call;
+with GG_Files;     use GG_Files;
+with SPARK2014VSN; use SPARK2014VSN;
+
 package body Flow_Generated_Globals.Phase_1.Write is
 
+   --  The entries are serialized into an in-memory buffer, while the names
+   --  they refer to are interned into a table; both are written to the GG
+   --  file at the end of phase 1. See GG_Files for the layout of that file.
+
+   package Name_Numbering is new
+     Ada.Containers.Indefinite_Hashed_Maps
+       (Key_Type        => String,
+        Element_Type    => Natural,
+        Hash            => Ada.Strings.Hash,
+        Equivalent_Keys => "=");
+
+   Name_Numbers : Name_Numbering.Map;
+   --  Numbers of the names interned so far, starting from zero
+
+   Name_Table : Unbounded_String;
+   --  Table of the interned names, in the order of their numbers
+
+   Entries : Unbounded_String;
+   --  Serialized entries
+
+   procedure Serialize_Name (S : String)
+   with Pre => S /= "";
+   --  Interns S, unless already done, and appends a reference to it to the
+   --  entries.
+
    -----------------
    -- New_GG_Line --
    -----------------
 
    procedure New_GG_Line (K : ALI_Entry_Kind) is
    begin
-      Write_Info_Str ("GG ");
-      Write_Info_Str (K'Img);
+      Serialize (Int (ALI_Entry_Kind'Pos (K)));
    end New_GG_Line;
 
    ---------------
@@ -45,8 +78,7 @@ procedure New_GG_Line (K : ALI_Entry_Kind) is
 
    procedure Serialize (E : Entity_Id) is
    begin
-      Write_Info_Char (' ');
-      Write_Info_Str
+      Serialize_Name
         (if E = Standard_Standard then "__standard" else Unique_Name (E));
    --  ??? the __standard is also special cased in phase 2; this should be
    --  done in one place only.
@@ -54,16 +86,20 @@ procedure Serialize (E : Entity_Id) is
 
    procedure Serialize (N : Int) is
    begin
-      --  Directly use the frontend API for writing integers, as this seems
-      --  simpler than instantiating the generic serializer for discrete types.
-      Write_Info_Char (' ');
-      Write_Info_Int (N);
+      --  Map 0, -1, 1, -2, 2, ... to 0, 1, 2, 3, 4, ... so that numbers of
+      --  small magnitude take a single byte regardless of their sign; the
+      --  lowest bit of the item is left clear for numbers.
+
+      if N >= 0 then
+         Append_Number (Entries, 4 * Unsigned_64 (N));
+      else
+         Append_Number (Entries, 4 * Unsigned_64 (-(N + 1)) + 2);
+      end if;
    end Serialize;
 
    procedure Serialize (S : String) is
    begin
-      Write_Info_Char (' ');
-      Write_Info_Str (S);
+      Serialize_Name (S);
    end Serialize;
 
    procedure Serialize (Nodes : Node_Lists.List; Label : String := "") is
@@ -111,16 +147,92 @@ procedure Serialize_Discrete (A : T; Label : String := "") is
          Serialize (Label);
       end if;
 
-      Serialize (A'Img);
+      Serialize (Int (T'Pos (A)));
    end Serialize_Discrete;
 
+   --------------------
+   -- Serialize_Name --
+   --------------------
+
+   procedure Serialize_Name (S : String) is
+      Position : Name_Numbering.Cursor;
+      Inserted : Boolean;
+   begin
+      Name_Numbers.Insert
+        (Key      => S,
+         New_Item => Natural (Name_Numbers.Length),
+         Position => Position,
+         Inserted => Inserted);
+
+      if Inserted then
+         Append_Name (Name_Table, S);
+      end if;
+
+      Append_Number
+        (Entries, 2 * Unsigned_64 (Name_Numbering.Element (Position)) + 1);
+   end Serialize_Name;
+
    -----------------------
    -- Terminate_GG_Line --
    -----------------------
 
    procedure Terminate_GG_Line is
    begin
-      Write_Info_Terminate;
+      --  Entries are read back in the same order as they are written, so they
+      --  need no delimiter.
+
+      null;
    end Terminate_GG_Line;
 
+   -------------------
+   -- Write_GG_File --
+   -------------------
+
+   procedure Write_GG_File (File_Name : String) is
+      Header : Unbounded_String;
+      FD     : File_Descriptor;
+
+      procedure Write_Buffer (Buffer : Unbounded_String);
+      --  Writes the contents of Buffer to FD
+
+      ------------------
+      -- Write_Buffer --
+      ------------------
+
+      procedure Write_Buffer (Buffer : Unbounded_String) is
+         S : constant String := To_String (Buffer);
+      begin
+         if Write (FD, S'Address, S'Length) /= S'Length then
+            Close (FD);
+            Abort_With_Message ("cannot write GG file " & File_Name);
+         end if;
+      end Write_Buffer;
+
+      --  Start of processing for Write_GG_File
+
+   begin
+      Append (Header, GG_File_Magic);
+      Append_Number
+        (Header, Unsigned_64 (SPARK2014_Static_Version_String'Length));
+      Append (Header, SPARK2014_Static_Version_String);
+      Append_Number (Header, Unsigned_64 (Name_Numbers.Length));
+      Append_Number (Header, Unsigned_64 (Length (Name_Table)));
+
+      FD := Create_File (File_Name, Binary);
+
+      if FD = Invalid_FD then
+         Abort_With_Message ("cannot create GG file " & File_Name);
+      end if;
+
+      Write_Buffer (Header);
+      Write_Buffer (Name_Table);
+      Write_Buffer (Entries);
+
+      Close (FD);
+
+      Name_Numbers.Clear;
+      Name_Table := Null_Unbounded_String;
+      Entries := Null_Unbounded_String;
+   end Write_GG_File;
+
 end Flow_Generated_Globals.Phase_1.Write;
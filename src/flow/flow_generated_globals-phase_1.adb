@@ -21,6 +21,9 @@
 --                                                                          --
 ------------------------------------------------------------------------------
 
+with Ada.Directories;
+with Ada.Strings.Unbounded; use Ada.Strings.Unbounded;
+
 with Aspects;     use Aspects;
 with Einfo.Utils; use Einfo.Utils;
 with Elists;      use Elists;
@@ -34,6 +37,7 @@
 with Uintp;       use Uintp;
 
 with Common_Iterators;       use Common_Iterators;
+with GG_Files;               use GG_Files;
 with SPARK_Frame_Conditions; use SPARK_Frame_Conditions;
 with SPARK_Util.Subprograms; use SPARK_Util.Subprograms;
 with SPARK2014VSN;           use SPARK2014VSN;
@@ -45,6 +49,9 @@
 
 package body Flow_Generated_Globals.Phase_1 is
 
+   GG_File : Unbounded_String;
+   --  Name of the GG file where the entries are written
+
    Current_Lib_Unit : Entity_Id;
    --  Unique identifier of the top-level entity of the current library unit;
    --  it is the same for the main compilation unit and its subunits (which are
@@ -763,10 +770,15 @@ procedure GG_Write_Finalize is
          Register_Info (Call);
       end loop;
 
-      --  Write the finalization string
+      --  Write the finalization string, both to the GG file and the ALI file,
+      --  as GPRbuild uses the latter to detect corrupted dependencies.
       New_GG_Line (EK_End_Marker);
       Terminate_GG_Line;
 
+      Write_GG_File (To_String (GG_File));
+      Write_Info_Str ("GG " & EK_End_Marker'Img);
+      Write_Info_Terminate;
+
       --  Close file and put the package out of writing mode
       Close_Output_Library_Info;
       Current_Mode := GG_No_Mode;
@@ -778,6 +790,15 @@ procedure GG_Write_Finalize is
 
    procedure GG_Write_Initialize (GNAT_Root : Node_Id) is
    begin
+      --  Put the GG file next to the ALI file of the main unit, where phase 2
+      --  will look for it. Like the ALI file, it is written in the current
+      --  directory and named after the main source file.
+      GG_File :=
+        To_Unbounded_String
+          (GG_File_Name
+             (Ada.Directories.Compose
+                (Name => SPARK_Util.Unit_Name, Extension => "ali")));
+
       --  Open output library info for writing
       Open_Output_Library_Info;
       Write_Info_Str ("QQ SPARKVERSION " & SPARK2014_Static_Version_String);
@@ -21,145 +21,456 @@
 --                                                                          --
 ------------------------------------------------------------------------------
 
-with Ada.Strings;           use Ada.Strings;
-with Ada.Strings.Maps;      use Ada.Strings.Maps;
-with Ada.Strings.Unbounded; use Ada.Strings.Unbounded;
+with Ada.Containers.Indefinite_Hashed_Maps;
+with Ada.Containers.Vectors;
+with Ada.Strings.Hash;
+with GNAT.OS_Lib;
+with GNATCOLL.Mmap; use GNATCOLL.Mmap;
+with Interfaces;    use Interfaces;
+
+with GG_Files;     use GG_Files;
+with SPARK2014VSN; use SPARK2014VSN;
 
 package body Flow_Generated_Globals.Phase_2.Read is
 
-   --  To read the consecutive items from a single line of an ALI file with a
-   --  GG data we first store the entire line in a buffer, and then pick the
-   --  items using the strongly typed interface exposed from the spec of this
-   --  package.
-
-   --  Internally, we maintain a position of where the next string token
-   --  starts and increment it once this token is consumed. Those tokens are
-   --  then converted to the typed values as requested by the users of this
-   --  package.
-
-   Buffer      : Unbounded_String;
-   Token_Start : Positive;
-
-   function Get_Token return String
-   with
-     Pre  => Token_Start <= Length (Buffer),
-     Post => Get_Token'Result'First = 1 and then Get_Token'Result'Length > 0;
-   --  Returns the next token from the current line and increments the position
-   --  of where the next token starts.
+   --  The GG file is mapped into memory and its entries are decoded in place,
+   --  using the typed interface exposed from the spec of this package. See
+   --  GG_Files for the layout of GG files and databases.
+
+   --  All the entries of a file are decoded when it is read. The table of
+   --  names is only scanned to locate the names, which are converted to
+   --  Entity_Names when an entry refers to them for the first time. When the
+   --  entries come from the database, the converted names are kept for the
+   --  next units, since the names are then shared by all of them.
+
+   File    : Mapped_File;
+   Region  : Mapped_Region;
+   Is_Open : Boolean := False;
+   --  The current GG file, if any
+
+   Contents      : Str_Access;
+   Contents_Last : Natural;
+   --  Contents of the current GG file or database
+
+   Position : Positive;
+   --  Position of the next byte to read
+
+   Entries_Last : Natural;
+   --  Position of the last byte of the entries being read
+
+   type Name_Slot is record
+      First : Positive;
+      Last  : Natural;
+      Name  : Any_Entity_Name;
+   end record;
+   --  Bounds of the text of a name in Contents, and its Entity_Name, or
+   --  Null_Entity_Name if it has not been converted yet.
+
+   package Name_Vectors is new
+     Ada.Containers.Vectors
+       (Index_Type   => Natural,
+        Element_Type => Name_Slot);
+
+   Names : Name_Vectors.Vector;
+   --  Names of the entries being read, indexed by their numbers
+
+   --  The attached database, if any
+
+   package Unit_Maps is new
+     Ada.Containers.Indefinite_Hashed_Maps
+       (Key_Type        => String,
+        Element_Type    => Natural,
+        Hash            => Ada.Strings.Hash,
+        Equivalent_Keys => "=");
+
+   Database_File     : Mapped_File;
+   Database_Region   : Mapped_Region;
+   Database_Attached : Boolean := False;
+   In_Database       : Boolean := False;
+   --  Whether the entries being read come from the database
+
+   Database_Contents : Str_Access;
+   Database_Last     : Natural;
+   Entries_Start     : Positive;
+   --  Layout of the database
+
+   Database_Units : Unit_Maps.Map;
+   --  Maps the names of the units in the database to the positions of their
+   --  directory slots.
+
+   Database_Names : Name_Vectors.Vector;
+   --  Names of the database; they are moved to and from Names while the
+   --  entries of a unit from the database are read.
+
+   procedure Check_Label (Label : String);
+   --  Checks that the next item is Label, unless Label is empty, and raises
+   --  GG_File_Error otherwise.
+
+   function Name_Text (Number : Natural) return String;
+   --  Returns the text of the name with the given number
+
+   function Read_Item return Unsigned_64;
+   --  Returns the next item of the entries and increments the position of
+   --  the next byte to read.
    --
-   --  This is intentionally a function and not a procedure to simplify
-   --  implementation of the callers; however, they must be careful about side
-   --  effects and not call it in expressions where calls might be reordered by
-   --  the compiler (e.g. it must not be used in different actual parameters of
-   --  a single subprogram call). Luckily, this package is small enough to
-   --  manually inspect that this doesn't happen.
+   --  Like the other reading functions, this must not be called in
+   --  expressions where calls might be reordered by the compiler.
+
+   function Read_Name_Number return Natural;
+   --  Returns the next item as the number of a name
+
+   procedure Read_Header
+     (Magic        : String;
+      Compatible   : out Boolean;
+      Name_Count   : out Natural;
+      Table_Length : out Natural);
+   --  Checks that Contents starts with Magic and, if it was written by this
+   --  version of SPARK, reads the number of names and the length of their
+   --  table.
+
+   procedure Read_Names (Name_Count, Table_Length : Natural);
+   --  Locates the names of the table of names at Position in Names, and
+   --  moves Position past the table.
+
+   ------------------------
+   -- Attach_GG_Database --
+   ------------------------
+
+   procedure Attach_GG_Database (File_Name : String) is
+      Compatible   : Boolean;
+      Name_Count   : Natural;
+      Table_Length : Natural;
+      Unit_Count   : Natural;
+      Slot         : Positive;
+
+   begin
+      pragma Assert (not Database_Attached and then not Is_Open);
+
+      if not GNAT.OS_Lib.Is_Regular_File (File_Name) then
+         return;
+      end if;
+
+      Database_File := Open_Read (File_Name);
+      Read (Database_File, Database_Region);
+
+      Contents := Data (Database_Region);
+      Contents_Last := Last (Database_Region);
+
+      Read_Header (GG_Database_Magic, Compatible, Name_Count, Table_Length);
+
+      if Compatible then
+         Unit_Count := Read_Natural (Contents.all, Contents_Last, Position);
+         Read_Names (Name_Count, Table_Length);
+
+         Database_Contents := Contents;
+         Database_Last := Contents_Last;
+
+         Slot := Position;
+         Entries_Start := Slot + 12 * Unit_Count;
+
+         if Entries_Start - 1 > Contents_Last then
+            raise GG_File_Error;
+         end if;
+
+         for J in 1 .. Unit_Count loop
+            declare
+               Unit : constant Natural :=
+                 Read_Word (Contents.all, Contents_Last, Slot);
+            begin
+               if Unit >= Name_Count then
+                  raise GG_File_Error;
+               end if;
 
-   Separator : constant Character_Set := To_Set (' ');
-   --  Individual tokens of the ALI line are separated by spaces
+               Database_Units.Include (Name_Text (Unit), Slot);
+            end;
+
+            Slot := Slot + 12;
+         end loop;
+
+         Name_Vectors.Move (Target => Database_Names, Source => Names);
+         Database_Attached := True;
+
+      else
+         Free (Database_Region);
+         Close (Database_File);
+      end if;
+
+   exception
+      --  Fall back to the GG files if the database is malformed
+
+      when GG_File_Error =>
+         Database_Units.Clear;
+         Names.Clear;
+         Free (Database_Region);
+         Close (Database_File);
+   end Attach_GG_Database;
+
+   -----------------
+   -- Check_Label --
+   -----------------
+
+   procedure Check_Label (Label : String) is
+   begin
+      if Label /= "" and then Name_Text (Read_Name_Number) /= Label then
+         raise GG_File_Error;
+      end if;
+   end Check_Label;
+
+   -------------------
+   -- Close_GG_File --
+   -------------------
+
+   procedure Close_GG_File is
+   begin
+      if In_Database then
+         Name_Vectors.Move (Target => Database_Names, Source => Names);
+         In_Database := False;
+
+      elsif Is_Open then
+         Free (Region);
+         Close (File);
+         Names.Clear;
+         Is_Open := False;
+      end if;
+   end Close_GG_File;
+
+   --------------------
+   -- End_Of_GG_File --
+   --------------------
+
+   function End_Of_GG_File return Boolean
+   is (Position > Entries_Last);
 
    ---------------
-   -- Get_Token --
+   -- Name_Text --
    ---------------
 
-   function Get_Token return String is
-      First  : Positive;
-      Last   : Natural;
-      Length : Positive;
+   function Name_Text (Number : Natural) return String
+   is (Contents (Names (Number).First .. Names (Number).Last));
+
+   ------------------
+   -- Open_GG_File --
+   ------------------
+
+   procedure Open_GG_File (File_Name : String; Status : out GG_File_Status) is
+      Compatible   : Boolean;
+      Name_Count   : Natural;
+      Table_Length : Natural;
 
    begin
-      Ada.Strings.Unbounded.Find_Token
-        (Source => Buffer,
-         Set    => Separator,
-         From   => Token_Start,
-         Test   => Outside,
-         First  => First,
-         Last   => Last);
+      pragma Assert (not Is_Open and then not In_Database);
+
+      --  Prefer the database, where the names of the unit may already have
+      --  been converted while reading other units.
+
+      if Database_Attached then
+         declare
+            C : constant Unit_Maps.Cursor :=
+              Database_Units.Find (Unit_Name (File_Name));
+         begin
+            if Unit_Maps.Has_Element (C) then
+               declare
+                  Slot   : constant Positive := Unit_Maps.Element (C);
+                  Offset : constant Natural :=
+                    Read_Word
+                      (Database_Contents.all, Database_Last, Slot + 4);
+                  Length : constant Natural :=
+                    Read_Word
+                      (Database_Contents.all, Database_Last, Slot + 8);
+               begin
+                  Contents := Database_Contents;
+                  Contents_Last := Database_Last;
+                  Position := Entries_Start + Offset;
+                  Entries_Last := Position + Length - 1;
+
+                  if Entries_Last > Contents_Last then
+                     raise GG_File_Error;
+                  end if;
+
+                  Name_Vectors.Move
+                    (Target => Names, Source => Database_Names);
+                  In_Database := True;
+
+                  Status := Valid;
+                  return;
+               end;
+            end if;
+         end;
+      end if;
+
+      if not GNAT.OS_Lib.Is_Regular_File (File_Name) then
+         Status := Missing;
+         return;
+      end if;
 
-      pragma Assert (Last /= 0);
+      File := Open_Read (File_Name);
+      Read (File, Region);
+      Is_Open := True;
 
-      Length := Last - First + 1;
+      Contents := Data (Region);
+      Contents_Last := Last (Region);
 
-      Token_Start := Last + 1;
+      Read_Header (GG_File_Magic, Compatible, Name_Count, Table_Length);
+
+      if not Compatible then
+         Close_GG_File;
+         Status := Incompatible;
+         return;
+      end if;
 
-      declare
-         subtype Token is String (1 .. Length);
+      Read_Names (Name_Count, Table_Length);
+      Entries_Last := Contents_Last;
 
-         Match : constant String :=
-           Ada.Strings.Unbounded.Slice
-             (Source => Buffer, Low => First, High => Last);
-      begin
-         return Token (Match);
-      end;
-   end Get_Token;
+      Status := Valid;
+   end Open_GG_File;
 
    -----------------
-   -- New_GG_Line --
+   -- Read_Header --
    -----------------
 
-   procedure New_GG_Line (Line : String) is
+   procedure Read_Header
+     (Magic        : String;
+      Compatible   : out Boolean;
+      Name_Count   : out Natural;
+      Table_Length : out Natural)
+   is
+      Version_Length : Natural;
+   begin
+      if Contents_Last < Magic'Length
+        or else Contents (1 .. Magic'Length) /= Magic
+      then
+         raise GG_File_Error;
+      end if;
+
+      Position := Magic'Length + 1;
+      Version_Length := Read_Natural (Contents.all, Contents_Last, Position);
+
+      Compatible :=
+        Position + Version_Length - 1 <= Contents_Last
+        and then Contents (Position .. Position + Version_Length - 1)
+                 = SPARK2014_Static_Version_String;
+
+      if Compatible then
+         Position := Position + Version_Length;
+         Name_Count := Read_Natural (Contents.all, Contents_Last, Position);
+         Table_Length := Read_Natural (Contents.all, Contents_Last, Position);
+      else
+         Name_Count := 0;
+         Table_Length := 0;
+      end if;
+   end Read_Header;
+
+   ---------------
+   -- Read_Item --
+   ---------------
+
+   function Read_Item return Unsigned_64 is
+      Item : Unsigned_64;
+   begin
+      Read_Number (Contents.all, Entries_Last, Position, Item);
+      return Item;
+   end Read_Item;
+
+   ----------------------
+   -- Read_Name_Number --
+   ----------------------
+
+   function Read_Name_Number return Natural is
+      Item : constant Unsigned_64 := Read_Item;
    begin
-      --  Copy line into the internal buffer but skip the "GG " prefix
-      Set_Unbounded_String (Buffer, Line (Line'First + 3 .. Line'Last));
-      Token_Start := 1;
-   end New_GG_Line;
+      if Item mod 2 = 0 or else Item / 2 >= Unsigned_64 (Names.Length) then
+         raise GG_File_Error;
+      end if;
 
-   -----------------------
-   -- Terminate_GG_Line --
-   -----------------------
+      return Natural (Item / 2);
+   end Read_Name_Number;
 
-   procedure Terminate_GG_Line is
+   ----------------
+   -- Read_Names --
+   ----------------
+
+   procedure Read_Names (Name_Count, Table_Length : Natural) is
+      Table_Last : constant Natural := Position + Table_Length - 1;
+      First      : Positive;
+      Name_Last  : Natural;
    begin
-      --  Check that entire line has been consumed and release the buffer
-      pragma Assert (Token_Start = Length (Buffer) + 1);
+      --  Each name takes at least two bytes, its length and its text
 
-      Set_Unbounded_String (Buffer, "");
-   end Terminate_GG_Line;
+      if Table_Last > Contents_Last or else Name_Count > Table_Length / 2 then
+         raise GG_File_Error;
+      end if;
+
+      Names.Clear;
+      Names.Reserve_Capacity (Count_Type (Name_Count));
+
+      for J in 1 .. Name_Count loop
+         Read_Name (Contents.all, Table_Last, Position, First, Name_Last);
+         Names.Append ((First, Name_Last, Null_Entity_Name));
+      end loop;
+
+      if Position /= Table_Last + 1 then
+         raise GG_File_Error;
+      end if;
+   end Read_Names;
 
    ---------------
    -- Serialize --
    ---------------
 
    procedure Serialize (E : out Entity_Name) is
+      Number : constant Natural := Read_Name_Number;
    begin
-      E := To_Entity_Name (Get_Token);
-   end Serialize;
+      if Names (Number).Name = Null_Entity_Name then
+         Names (Number).Name := To_Entity_Name (Name_Text (Number));
+      end if;
 
-   ---------------
-   -- Serialize --
-   ---------------
+      E := Names (Number).Name;
+   end Serialize;
 
    procedure Serialize (Names : in out Name_Sets.Set; Label : String := "") is
-      Size : Natural;
+      Size : Int;
+      E    : Entity_Name;
    begin
-      if Label /= "" and then Get_Token /= Label then
-         raise Program_Error;
-      end if;
+      Check_Label (Label);
 
-      Size := Natural'Value (Get_Token);
+      Serialize (Size);
 
       for J in 1 .. Size loop
-         Names.Include (To_Entity_Name (Get_Token));
+         Serialize (E);
+         Names.Include (E);
       end loop;
    end Serialize;
 
    procedure Serialize (Names : in out Name_Lists.List; Label : String := "")
    is
-      Size : Natural;
+      Size : Int;
+      E    : Entity_Name;
    begin
-      if Label /= "" and then Get_Token /= Label then
-         raise Program_Error;
-      end if;
+      Check_Label (Label);
 
-      Size := Natural'Value (Get_Token);
+      Serialize (Size);
 
       for J in 1 .. Size loop
-         Names.Append (To_Entity_Name (Get_Token));
+         Serialize (E);
+         Names.Append (E);
       end loop;
    end Serialize;
 
    procedure Serialize (N : out Int) is
+      Item   : constant Unsigned_64 := Read_Item;
+      Number : constant Unsigned_64 := Item / 2;
    begin
-      N := Int'Value (Get_Token);
+      if Item mod 2 = 1 or else Number > 2 * Unsigned_64 (Int'Last) + 1 then
+         raise GG_File_Error;
+      end if;
+
+      --  Undo the mapping of 0, -1, 1, -2, 2, ... to 0, 1, 2, 3, 4, ...
+
+      if Number mod 2 = 0 then
+         N := Int (Number / 2);
+      else
+         N := -Int (Number / 2) - 1;
+      end if;
    end Serialize;
 
    ------------------------
@@ -167,12 +478,13 @@ procedure Serialize (N : out Int) is
    ------------------------
 
    procedure Serialize_Discrete (A : out T; Label : String := "") is
+      N : Int;
    begin
-      if Label /= "" and then Get_Token /= Label then
-         raise Program_Error;
-      end if;
+      Check_Label (Label);
+
+      Serialize (N);
 
-      A := T'Value (Get_Token);
+      A := T'Val (N);
    end Serialize_Discrete;
 
 end Flow_Generated_Globals.Phase_2.Read;
@@ -26,7 +26,7 @@
 with Ada.Containers.Hashed_Sets;
 with Ada.Strings.Fixed;
 with Ada.Strings.Unbounded; use Ada.Strings.Unbounded;
-with Ada.Text_IO;           use Ada.Text_IO;
+with Ada.Text_IO;
 
 with Assumption_Types; use Assumption_Types;
 
@@ -38,8 +38,8 @@
 
 with Call;                      use Call;
 with Debug.Timing;              use Debug.Timing;
+with GG_Files;
 with Gnat2Why_Args;
-with SPARK2014VSN;              use SPARK2014VSN;
 with SPARK_Definition.Annotate; use SPARK_Definition.Annotate;
 with SPARK_Frame_Conditions;    use SPARK_Frame_Conditions;
 with SPARK_Xrefs;               use SPARK_Xrefs;
@@ -806,6 +806,7 @@ procedure Add_Edges is
 
             --  Transitive closure
             Tasking_Call_Graph.Close;
+            Tasking_Call_Graph.Compact;
          end Add_Tasking_Edges;
 
          --  To detect potentially blocking operations in protected actions,
@@ -878,6 +879,7 @@ procedure Add_Edges is
 
             --  Close the call graph; for an empty graph it will be a no-op
             Call_Graph.Close;
+            Call_Graph.Compact;
          end Add_Protected_Operation_Edges;
 
          --  To detect if a subprogram is recursive we create a call graph
@@ -942,6 +944,7 @@ procedure Add_Edges is
 
             --  Close the call graph
             Call_Graph.Close;
+            Call_Graph.Compact;
          end Add_Subprogram_Edges;
 
          --  To detect if proof modules are inter-dependent, we create a call
@@ -1047,6 +1050,11 @@ procedure Add_Edges is
             --  Close the call graph
 
             Lemma_Module_Dependency_Graph.Close;
+
+            --  Both module dependency graphs are now complete
+
+            Proof_Module_Dependency_Graph.Compact;
+            Lemma_Module_Dependency_Graph.Compact;
          end Add_Lemma_Subprogram_Edges;
 
          Add_Ceiling_Priority_Edges :
@@ -1176,6 +1184,9 @@ procedure Add_Edges is
             Original_Priority_Call_Graph := Call_Graph;
             Call_Graph.Close;
 
+            Original_Priority_Call_Graph.Compact;
+            Call_Graph.Compact;
+
          end Add_Ceiling_Priority_Edges;
       end Add_Edges;
 
@@ -1364,51 +1375,52 @@ procedure Load_GG_Info_From_ALI
       is
          pragma Unreferenced (For_Current_CUnit);
 
+         use Flow_Generated_Globals.Phase_2.Read;
+
          ALI_File_Name_Str : constant String :=
            Get_Name_String (Full_Lib_File_Name (ALI_File_Name));
 
-         ALI_File : Ada.Text_IO.File_Type;
+         GG_File_Name_Str : constant String :=
+           GG_Files.GG_File_Name (ALI_File_Name_Str);
 
          type GG_Parsing_Status is (Before, Started, Finished);
 
          GG_Parsing_State : GG_Parsing_Status := Before;
-         Found_Version    : Boolean := False;
-         --  This will be set to True once we find the end marker
+         Status           : GG_File_Status;
 
-         procedure Corrupted_ALI_File (Msg : String)
+         procedure Corrupted_GG_File (Msg : String)
          with No_Return;
-         --  Issues an error about the ALI file being corrupted and suggests
+         --  Issues an error about the GG file being corrupted and suggests
          --  the usage of "gnatprove --clean".
 
-         procedure Parse_GG_Line (Line : String)
-         with
-           Pre =>
-             Line'Length >= 3
-             and then Line (Line'First .. Line'First + 2) = "GG ";
-         --  Parse single line of the GG section
+         function Written_By_Phase_1 return Boolean;
+         --  Returns True if the ALI file was written by phase 1 of gnat2why,
+         --  which then also wrote a GG file, i.e. if it contains the SPARK
+         --  version line.
 
-         ------------------------
-         -- Corrupted_ALI_File --
-         ------------------------
+         procedure Parse_GG_Entry;
+         --  Parse single entry of the GG file
 
-         procedure Corrupted_ALI_File (Msg : String) is
+         -----------------------
+         -- Corrupted_GG_File --
+         -----------------------
+
+         procedure Corrupted_GG_File (Msg : String) is
          begin
-            Close (ALI_File);
+            Close_GG_File;
             Abort_With_Message
-              ("Corrupted ali file detected ("
-               & ALI_File_Name_Str
+              ("Corrupted gg file detected ("
+               & GG_File_Name_Str
                & "): "
                & Msg
                & ". Call gnatprove with ""--clean"".");
-         end Corrupted_ALI_File;
+         end Corrupted_GG_File;
 
-         -------------------
-         -- Parse_GG_Line --
-         -------------------
+         --------------------
+         -- Parse_GG_Entry --
+         --------------------
 
-         procedure Parse_GG_Line (Line : String) is
-
-            use Flow_Generated_Globals.Phase_2.Read;
+         procedure Parse_GG_Entry is
 
             procedure Serialize is new Serialize_Discrete (ALI_Entry_Kind);
 
@@ -1549,17 +1561,16 @@ procedure Clear (G : in out Flow_Names) is
 
             K : ALI_Entry_Kind;
 
-            --  Parse_GG_Line
+            --  Start of processing for Parse_GG_Entry
 
          begin
-            New_GG_Line (Line);
             Serialize (K);
             case K is
                when EK_End_Marker              =>
                   if GG_Parsing_State = Started then
                      GG_Parsing_State := Finished;
                   else
-                     Corrupted_ALI_File ("unexpected GG end marker");
+                     Corrupted_GG_File ("unexpected GG end marker");
                   end if;
 
                when EK_State_Map               =>
@@ -1972,59 +1983,80 @@ procedure Clear (G : in out Flow_Names) is
                      Register_Name_Scope (Entity, Info);
                   end;
             end case;
+         end Parse_GG_Entry;
+
+         ------------------------
+         -- Written_By_Phase_1 --
+         ------------------------
+
+         function Written_By_Phase_1 return Boolean is
+            use Ada.Text_IO;
 
-            Terminate_GG_Line;
-         end Parse_GG_Line;
+            ALI_File : File_Type;
+            Found    : Boolean := False;
+         begin
+            Open (ALI_File, In_File, ALI_File_Name_Str);
+
+            while not Found and then not End_Of_File (ALI_File) loop
+               declare
+                  Line : constant String := Get_Line (ALI_File);
+               begin
+                  Found :=
+                    Line'Length >= 16
+                    and then Line (Line'First .. Line'First + 15)
+                             = "QQ SPARKVERSION ";
+               end;
+            end loop;
+
+            Close (ALI_File);
+            return Found;
+         end Written_By_Phase_1;
 
          --  Start of processing for Load_GG_Info_From_ALI
 
       begin
-         Open (ALI_File, In_File, ALI_File_Name_Str);
-
-         while not End_Of_File (ALI_File) loop
-            declare
-               Line : constant String := Get_Line (ALI_File);
+         Open_GG_File (GG_File_Name_Str, Status);
 
-            begin
-               if Line'Length >= 3 then
-                  declare
-                     Header : String renames Line (1 .. 3);
+         case Status is
+            when Missing      =>
+               --  There is no GG info for units which are not analyzed by
+               --  gnat2why, e.g. externally built ones. Otherwise the GG file
+               --  has been deleted or was not copied, and the generated
+               --  globals of the unit would silently be lost.
 
-                  begin
-                     if Header = "QQ " then
-                        Found_Version :=
-                          Line
-                          = "QQ SPARKVERSION "
-                            & SPARK2014_Static_Version_String;
-
-                     elsif Header = "GG " then
-                        if Found_Version then
-                           case GG_Parsing_State is
-                              when Before | Started =>
-                                 GG_Parsing_State := Started;
-                                 Parse_GG_Line (Line);
-
-                              when Finished         =>
-                                 Corrupted_ALI_File
-                                   ("GG data after GG end marker");
-
-                           end case;
-
-                        else
-                           Corrupted_ALI_File ("inconsistent spark version");
-                        end if;
-                     end if;
-                  end;
+               if Written_By_Phase_1 then
+                  Corrupted_GG_File ("missing GG file");
                end if;
-            end;
+               return;
+
+            when Incompatible =>
+               Corrupted_GG_File ("inconsistent spark version");
+
+            when Valid        =>
+               null;
+         end case;
+
+         while not End_Of_GG_File loop
+            case GG_Parsing_State is
+               when Before | Started =>
+                  GG_Parsing_State := Started;
+                  Parse_GG_Entry;
+
+               when Finished         =>
+                  Corrupted_GG_File ("GG data after GG end marker");
+            end case;
          end loop;
 
          if GG_Parsing_State = Started then
             --  If we started but not finished then the file is corrupted
-            Corrupted_ALI_File ("missing end marker");
+            Corrupted_GG_File ("missing end marker");
          end if;
 
-         Close (ALI_File);
+         Close_GG_File;
+
+      exception
+         when GG_File_Error =>
+            Corrupted_GG_File ("truncated GG data");
       end Load_GG_Info_From_ALI;
 
       ---------------
@@ -2047,6 +2079,16 @@ procedure Note_Time (Message : String) is
 
       Timing_Start (Timing);
 
+      --  Attach the database of generated globals linked by gnatprove, if
+      --  any, from which the information of most units is then loaded. It
+      --  only holds the raw entries of the GG files, so their resolution,
+      --  here and in GG_Complete, is still done in every process.
+
+      if Gnat2Why_Args.GG_Database /= Null_Unbounded_String then
+         Flow_Generated_Globals.Phase_2.Read.Attach_GG_Database
+           (To_String (Gnat2Why_Args.GG_Database));
+      end if;
+
       --  Load information from all ALI files
       for Index in ALIs.First .. ALIs.Last loop
          Load_GG_Info_From_ALI
@@ -2923,6 +2965,7 @@ procedure Seed (Constants : Name_Sets.Set) is
             Print (Constant_Graph);
 
             Constant_Graph.Close;
+            Constant_Graph.Compact;
          end Resolve_Constants;
 
          ------------------------
@@ -0,0 +1,747 @@
+------------------------------------------------------------------------------
+--                                                                          --
+--                            GNAT2WHY COMPONENTS                           --
+--                                                                          --
+--                         F L O W _ J O U R N A L                          --
+--                                                                          --
+--                                 B o d y                                  --
+--                                                                          --
+--                       Copyright (C) 2025, AdaCore                        --
+--                                                                          --
+-- gnat2why is  free  software;  you can redistribute  it and/or  modify it --
+-- under terms of the  GNU General Public License as published  by the Free --
+-- Software  Foundation;  either version 3,  or (at your option)  any later --
+-- version.  gnat2why is distributed  in the hope that  it will be  useful, --
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- --
+-- TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public --
+-- License for  more details.  You should have  received  a copy of the GNU --
+-- General  Public License  distributed with  gnat2why;  see file COPYING3. --
+-- If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the --
+-- license.                                                                 --
+--                                                                          --
+-- gnat2why is maintained by AdaCore (http://www.adacore.com)               --
+--                                                                          --
+------------------------------------------------------------------------------
+
+with Ada.Containers.Indefinite_Hashed_Maps;
+with Ada.Containers.Ordered_Maps;
+with Ada.Directories;
+with Ada.Environment_Variables;
+with Ada.Strings.Fixed;
+with Ada.Strings.Hash;
+with Ada.Text_IO;
+with Call;                      use Call;
+with Errout;
+with Erroutc;
+with Flow_Error_Messages;       use Flow_Error_Messages;
+with GNATCOLL.JSON;             use GNATCOLL.JSON;
+with GNATCOLL.Utils;            use GNATCOLL.Utils;
+with Interfaces.C;              use Interfaces.C;
+with Named_Semaphores;          use Named_Semaphores;
+with SPARK_Definition.Annotate; use SPARK_Definition.Annotate;
+with SPARK_Util;                use SPARK_Util;
+
+package body Flow_Journal is
+
+   type Entry_Kind is
+     (Errout_Msg,
+      Flow_Msg_Start,
+      Flow_Msg_End,
+      Flow_Msgs_Entry,
+      Warnings_Errors_Entry,
+      Message_Id_Entry,
+      Trace_File_Entry,
+      Claim_Entry,
+      Aliasing_Entry,
+      Annotation_Use,
+      Warnings_Use);
+   --  Kinds of entries in the journal
+
+   Worker_Stride : constant := 1_000_000;
+   --  Message ids and trace file numbers used by each worker start at a
+   --  multiple of this value, so that they do not clash with those of other
+   --  workers, nor with those given to them by the parent during the replay.
+
+   package Message_Id_Maps is new
+     Ada.Containers.Ordered_Maps
+       (Key_Type     => Message_Id,
+        Element_Type => Message_Id);
+
+   package Trace_File_Maps is new
+     Ada.Containers.Indefinite_Hashed_Maps
+       (Key_Type        => String,
+        Element_Type    => String,
+        Hash            => Ada.Strings.Hash,
+        Equivalent_Keys => "=");
+
+   Message_Ids : Message_Id_Maps.Map;
+   Trace_Files : Trace_File_Maps.Map;
+   --  Message ids and trace files of the workers, mapped to those allocated
+   --  in their place by the parent during the replay
+
+   Entity_Entries : JSON_Array;
+   --  Entries recorded for the entity being analysed
+
+   Entities : JSON_Array;
+   --  Entries recorded for all the entities analysed by this worker, as an
+   --  array of arrays.
+
+   Flow_Msgs_Mark       : Natural := 0;
+   Warnings_Errors_Mark : Natural := 0;
+   --  Length of the JSON arrays of messages when they were last journaled
+
+   Job_Slots_Variable : constant String := "GNATPROVE_FLOW_SEMAPHORE";
+   --  Environment variable holding the name of the semaphore from which job
+   --  slots are taken, when gnatprove shares them among gnat2why processes
+
+   Job_Slots      : Semaphore;
+   Job_Slots_Open : Boolean := False;
+   --  The semaphore of job slots, opened on first use
+
+   procedure Acquire_Job_Slots (Max : Positive; Slots : out Natural);
+   --  Take up to Max job slots, without waiting for other processes to
+   --  release them. All the Max slots are granted when gnatprove does not
+   --  share job slots.
+
+   procedure Release_Job_Slots (Slots : Natural);
+   --  Give back Slots job slots taken by Acquire_Job_Slots
+
+   function Fork return int
+   with Import, Convention => C, External_Name => "gnat2why_fork";
+   --  Fork the current process; return -1 if this is not possible
+
+   function Wait (Pid : int) return int
+   with Import, Convention => C, External_Name => "gnat2why_wait";
+   --  Wait for process Pid to terminate and return its exit status, or -1 if
+   --  it did not exit normally.
+
+   procedure Exit_Worker (Status : int)
+   with
+     No_Return,
+     Import,
+     Convention    => C,
+     External_Name => "gnat2why_exit";
+   --  Terminate the worker process without finalization, so that the buffers
+   --  and files inherited from the parent are left untouched.
+
+   procedure Append_Entry (Kind : Entry_Kind; Obj : JSON_Value);
+   --  Append entry Obj of the given kind to the journal of the current entity
+
+   procedure End_Entity;
+   --  Close the journal of the current entity
+
+   function Journal_File (Worker : Positive) return String
+   is (Unit_Name & "__flow__journal_" & Image (Worker, 1) & ".json");
+   --  Name of the file in which Worker saves its journal
+
+   procedure Replay_Entity (Entries : JSON_Array);
+   --  Replay the effects of the analysis of an entity
+
+   procedure Replay_Errout_Msg (Obj : JSON_Value);
+   --  Replay a call to Errout
+
+   procedure Replay_Flow_Msgs_Entry (Obj : JSON_Value);
+   --  Replay the addition of Obj to the flow messages of the .spark file
+
+   procedure Replay_Trace_File (Name : String);
+   --  Replay the creation of the trace file Name by a worker, by renaming it
+   --  after the next trace file of the parent.
+
+   procedure Save_Journal (File_Name : String);
+   --  Write the journal of the current worker to File_Name
+
+   procedure Start_Worker (Worker : Positive);
+   --  Set up a forked process to analyse entities as the given worker
+
+   procedure Sync_Messages;
+   --  Journal the JSON entries for the .spark file which have been added
+   --  since the last call.
+
+   -----------------------
+   -- Acquire_Job_Slots --
+   -----------------------
+
+   procedure Acquire_Job_Slots (Max : Positive; Slots : out Natural) is
+      Success : Boolean;
+   begin
+      if not Ada.Environment_Variables.Exists (Job_Slots_Variable) then
+         Slots := Max;
+         return;
+      end if;
+
+      if not Job_Slots_Open then
+         Open
+           (Ada.Environment_Variables.Value (Job_Slots_Variable), Job_Slots);
+         Job_Slots_Open := True;
+      end if;
+
+      Slots := 0;
+      while Slots < Max loop
+         Try_Wait (Job_Slots, Success);
+         exit when not Success;
+         Slots := Slots + 1;
+      end loop;
+   end Acquire_Job_Slots;
+
+   ------------------------
+   -- Analyse_In_Workers --
+   ------------------------
+
+   procedure Analyse_In_Workers
+     (Count : Natural; Max_Workers : Positive; Success : out Boolean)
+   is
+      Workers : Natural;
+
+   begin
+      Success := False;
+
+      Acquire_Job_Slots (Max_Workers, Workers);
+
+      if Workers < 2 then
+         Release_Job_Slots (Workers);
+         return;
+      end if;
+
+      declare
+         Pids     : array (1 .. Workers) of int := (others => -1);
+         Journals : array (1 .. Workers) of JSON_Value;
+
+      begin
+         for Worker in 1 .. Workers loop
+            Pids (Worker) := Fork;
+
+            if Pids (Worker) = 0 then
+               begin
+                  Start_Worker (Worker);
+
+                  for Index in 1 .. Count loop
+                     if (Index - 1) mod Workers = Worker - 1 then
+                        Entity_Entries := Empty_Array;
+                        Analyse (Index);
+                        End_Entity;
+                     end if;
+                  end loop;
+
+                  Save_Journal (Journal_File (Worker));
+
+               exception
+                  when others =>
+                     Exit_Worker (1);
+               end;
+
+               Exit_Worker (0);
+
+            elsif Pids (Worker) < 0 then
+               exit;
+            end if;
+         end loop;
+
+         --  Wait for all the workers that have been forked, even if some could
+         --  not be, so that none of them is left running.
+
+         Success := True;
+         for Worker in 1 .. Workers loop
+            if Pids (Worker) <= 0 or else Wait (Pids (Worker)) /= 0 then
+               Success := False;
+            end if;
+         end loop;
+
+         --  The slots are free again once the workers have terminated
+
+         Release_Job_Slots (Workers);
+
+         if Success then
+            for Worker in 1 .. Workers loop
+               Journals (Worker) :=
+                 Read_File_Into_JSON (Journal_File (Worker));
+            end loop;
+
+            Message_Ids.Clear;
+            Trace_Files.Clear;
+
+            for Index in 1 .. Count loop
+               declare
+                  Worker   : constant Positive := (Index - 1) mod Workers + 1;
+                  Analysed : constant JSON_Array :=
+                    Get (Journals (Worker), "entities");
+               begin
+                  Replay_Entity
+                    (Get (Get (Analysed, (Index - 1) / Workers + 1)));
+               end;
+            end loop;
+
+            for Journal of Journals loop
+               if Get (Journal, "flow_error") then
+                  Found_Flow_Error := True;
+               end if;
+            end loop;
+         end if;
+
+         for Worker in 1 .. Workers loop
+            if Ada.Directories.Exists (Journal_File (Worker)) then
+               Ada.Directories.Delete_File (Journal_File (Worker));
+            end if;
+         end loop;
+      end;
+   end Analyse_In_Workers;
+
+   ------------------
+   -- Append_Entry --
+   ------------------
+
+   procedure Append_Entry (Kind : Entry_Kind; Obj : JSON_Value) is
+   begin
+      Sync_Messages;
+      Set_Field (Obj, "kind", Entry_Kind'Image (Kind));
+      Append (Entity_Entries, Obj);
+   end Append_Entry;
+
+   ------------------
+   -- End_Flow_Msg --
+   ------------------
+
+   procedure End_Flow_Msg is
+   begin
+      if Recording then
+         Append_Entry (Flow_Msg_End, Create_Object);
+      end if;
+   end End_Flow_Msg;
+
+   ----------------
+   -- End_Entity --
+   ----------------
+
+   procedure End_Entity is
+   begin
+      Sync_Messages;
+      Append (Entities, Create (Entity_Entries));
+   end End_Entity;
+
+   ----------------------------
+   -- Record_Aliasing_Status --
+   ----------------------------
+
+   procedure Record_Aliasing_Status
+     (N : Node_Id; Status : Aliasing_Check_Result)
+   is
+      Obj : JSON_Value;
+   begin
+      if Recording then
+         Obj := Create_Object;
+         Set_Field (Obj, "node", Integer (N));
+         Set_Field (Obj, "status", Aliasing_Check_Result'Image (Status));
+         Append_Entry (Aliasing_Entry, Obj);
+      end if;
+   end Record_Aliasing_Status;
+
+   ---------------------------
+   -- Record_Annotation_Use --
+   ---------------------------
+
+   procedure Record_Annotation_Use
+     (Node : Node_Id; Msg : String; Check : Boolean)
+   is
+      Obj : JSON_Value;
+   begin
+      if Recording then
+         Obj := Create_Object;
+         Set_Field (Obj, "node", Integer (Node));
+         Set_Field (Obj, "msg", Msg);
+         Set_Field (Obj, "check", Check);
+         Append_Entry (Annotation_Use, Obj);
+      end if;
+   end Record_Annotation_Use;
+
+   ------------------
+   -- Record_Claim --
+   ------------------
+
+   procedure Record_Claim (C : Claim) is
+      Obj : JSON_Value;
+   begin
+      if Recording then
+         Obj := Create_Object;
+         Set_Field (Obj, "claim", Claim_Kind'Image (C.Kind));
+         Set_Field (Obj, "entity", Integer (C.E));
+         Append_Entry (Claim_Entry, Obj);
+      end if;
+   end Record_Claim;
+
+   -----------------------
+   -- Record_Errout_Msg --
+   -----------------------
+
+   procedure Record_Errout_Msg (Msg : String; Span : Source_Span) is
+      Obj : JSON_Value;
+   begin
+      if Recording then
+         Obj := Create_Object;
+         Set_Field (Obj, "msg", Msg);
+         Set_Field (Obj, "ptr", Integer (Span.Ptr));
+         Set_Field (Obj, "first", Integer (Span.First));
+         Set_Field (Obj, "last", Integer (Span.Last));
+         Set_Field (Obj, "sloc", Integer (Errout.Error_Msg_Sloc));
+         Set_Field (Obj, "node_1", Integer (Errout.Error_Msg_Node_1));
+         Set_Field (Obj, "node_2", Integer (Errout.Error_Msg_Node_2));
+         Set_Field (Obj, "node_3", Integer (Errout.Error_Msg_Node_3));
+         Set_Field (Obj, "node_4", Integer (Errout.Error_Msg_Node_4));
+         Append_Entry (Errout_Msg, Obj);
+      end if;
+   end Record_Errout_Msg;
+
+   procedure Record_Errout_Msg
+     (Msg : String; N : Node_Id; First_Node : Node_Id; First : Boolean)
+   is
+      Obj : JSON_Value;
+   begin
+      if Recording then
+         Obj := Create_Object;
+         Set_Field (Obj, "msg", Msg);
+         Set_Field (Obj, "node", Integer (N));
+         Set_Field (Obj, "first_node", Integer (First_Node));
+         Set_Field (Obj, "use_first", First);
+         Set_Field (Obj, "sloc", Integer (Errout.Error_Msg_Sloc));
+         Set_Field (Obj, "node_1", Integer (Errout.Error_Msg_Node_1));
+         Set_Field (Obj, "node_2", Integer (Errout.Error_Msg_Node_2));
+         Set_Field (Obj, "node_3", Integer (Errout.Error_Msg_Node_3));
+         Set_Field (Obj, "node_4", Integer (Errout.Error_Msg_Node_4));
+         Append_Entry (Errout_Msg, Obj);
+      end if;
+   end Record_Errout_Msg;
+
+   -----------------------
+   -- Record_Message_Id --
+   -----------------------
+
+   procedure Record_Message_Id (Id : Message_Id) is
+      Obj : JSON_Value;
+   begin
+      if Recording then
+         Obj := Create_Object;
+         Set_Field (Obj, "id", Integer (Id));
+         Append_Entry (Message_Id_Entry, Obj);
+      end if;
+   end Record_Message_Id;
+
+   -----------------------
+   -- Record_Trace_File --
+   -----------------------
+
+   procedure Record_Trace_File (Name : String) is
+      Obj : JSON_Value;
+   begin
+      if Recording then
+         Obj := Create_Object;
+         Set_Field (Obj, "file", Name);
+         Append_Entry (Trace_File_Entry, Obj);
+      end if;
+   end Record_Trace_File;
+
+   -------------------------
+   -- Record_Warnings_Use --
+   -------------------------
+
+   procedure Record_Warnings_Use (Loc : Source_Ptr; Msg : String) is
+      Obj : JSON_Value;
+   begin
+      if Recording then
+         Obj := Create_Object;
+         Set_Field (Obj, "loc", Integer (Loc));
+         Set_Field (Obj, "msg", Msg);
+         Append_Entry (Warnings_Use, Obj);
+      end if;
+   end Record_Warnings_Use;
+
+   -----------------------
+   -- Release_Job_Slots --
+   -----------------------
+
+   procedure Release_Job_Slots (Slots : Natural) is
+   begin
+      if Job_Slots_Open then
+         for J in 1 .. Slots loop
+            Release (Job_Slots);
+         end loop;
+      end if;
+   end Release_Job_Slots;
+
+   -------------------
+   -- Replay_Entity --
+   -------------------
+
+   procedure Replay_Entity (Entries : JSON_Array) is
+      Skip : Boolean := False;
+      --  True while replaying the effects of a flow message that has already
+      --  been issued.
+
+   begin
+      for Index in 1 .. Length (Entries) loop
+         declare
+            Obj  : constant JSON_Value := Get (Entries, Index);
+            Kind : constant Entry_Kind := Entry_Kind'Value (Get (Obj, "kind"));
+
+         begin
+            if Kind = Flow_Msg_End then
+               Skip := False;
+
+            elsif not Skip then
+               case Kind is
+                  when Errout_Msg            =>
+                     Replay_Errout_Msg (Obj);
+
+                  when Flow_Msg_Start        =>
+                     declare
+                        Inserted : Boolean;
+                     begin
+                        Register_Flow_Msg (Get (Obj, "key"), Inserted);
+                        Skip := not Inserted;
+                     end;
+
+                  when Flow_Msg_End          =>
+                     raise Program_Error;
+
+                  when Flow_Msgs_Entry       =>
+                     Replay_Flow_Msgs_Entry (Get (Obj, "value"));
+
+                  when Warnings_Errors_Entry =>
+                     Append (Warnings_Errors, Get (Obj, "value"));
+
+                  when Message_Id_Entry      =>
+                     Message_Ids.Insert
+                       (Message_Id (Integer'(Get (Obj, "id"))),
+                        Next_Message_Id);
+
+                  when Trace_File_Entry      =>
+                     Replay_Trace_File (Get (Obj, "file"));
+
+                  when Claim_Entry           =>
+                     Register_Claim
+                       (Claim'
+                          (Kind => Claim_Kind'Value (Get (Obj, "claim")),
+                           E    =>
+                             Entity_Id (Integer'(Get (Obj, "entity")))));
+
+                  when Aliasing_Entry        =>
+                     Set_Aliasing_Status
+                       (Node_Id (Integer'(Get (Obj, "node"))),
+                        Aliasing_Check_Result'Value (Get (Obj, "status")));
+
+                  when Annotation_Use        =>
+                     declare
+                        Unused_Info : Annotated_Range;
+                     begin
+                        Check_Is_Annotated
+                          (Node  => Node_Id (Integer'(Get (Obj, "node"))),
+                           Msg   => Get (Obj, "msg"),
+                           Check => Get (Obj, "check"),
+                           Info  => Unused_Info);
+                     end;
+
+                  when Warnings_Use          =>
+                     declare
+                        Msg          : aliased constant String :=
+                          Get (Obj, "msg");
+                        Unused_Suppr : constant String_Id :=
+                          Erroutc.Warning_Specifically_Suppressed
+                            (Loc => Source_Ptr (Integer'(Get (Obj, "loc"))),
+                             Msg => Msg'Unrestricted_Access);
+                     begin
+                        null;
+                     end;
+               end case;
+            end if;
+         end;
+      end loop;
+   end Replay_Entity;
+
+   -----------------------
+   -- Replay_Errout_Msg --
+   -----------------------
+
+   procedure Replay_Errout_Msg (Obj : JSON_Value) is
+
+      function Renumber (Msg : String) return String;
+      --  Replace the id of the message inserted in Msg in IDE mode, of the
+      --  form ['#<id>], by the id allocated by the parent.
+
+      --------------
+      -- Renumber --
+      --------------
+
+      function Renumber (Msg : String) return String is
+         First : constant Natural := Ada.Strings.Fixed.Index (Msg, "['#");
+         Last  : constant Natural :=
+           (if First = 0
+            then 0
+            else Ada.Strings.Fixed.Index (Msg, "]", From => First));
+      begin
+         if Last > First + 3
+           and then (for all C of Msg (First + 3 .. Last - 1) =>
+                       C in '0' .. '9')
+         then
+            declare
+               Id : constant Message_Id :=
+                 Message_Id'Value (Msg (First + 3 .. Last - 1));
+            begin
+               if Message_Ids.Contains (Id) then
+                  return
+                    Msg (Msg'First .. First + 2)
+                    & Image (Integer (Message_Ids.Element (Id)), 1)
+                    & Msg (Last .. Msg'Last);
+               end if;
+            end;
+         end if;
+
+         return Msg;
+      end Renumber;
+
+      Msg : constant String := Renumber (Get (Obj, "msg"));
+
+      function Get_Node (Field : String) return Node_Id
+      is (Node_Id (Integer'(Get (Obj, Field))));
+
+      function Get_Sloc (Field : String) return Source_Ptr
+      is (Source_Ptr (Integer'(Get (Obj, Field))));
+
+      --  Start of processing for Replay_Errout_Msg
+
+   begin
+      Errout.Error_Msg_Sloc := Get_Sloc ("sloc");
+      Errout.Error_Msg_Node_1 := Get_Node ("node_1");
+      Errout.Error_Msg_Node_2 := Get_Node ("node_2");
+      Errout.Error_Msg_Node_3 := Get_Node ("node_3");
+      Errout.Error_Msg_Node_4 := Get_Node ("node_4");
+
+      if Has_Field (Obj, "ptr") then
+         Errout.Error_Msg
+           (Msg,
+            Source_Span'
+              (Ptr   => Get_Sloc ("ptr"),
+               First => Get_Sloc ("first"),
+               Last  => Get_Sloc ("last")));
+      elsif Get (Obj, "use_first") then
+         Errout.Error_Msg_FE (Msg, Get_Node ("node"), Get_Node ("first_node"));
+      else
+         Errout.Error_Msg_NE (Msg, Get_Node ("node"), Get_Node ("first_node"));
+      end if;
+   end Replay_Errout_Msg;
+
+   ----------------------------
+   -- Replay_Flow_Msgs_Entry --
+   ----------------------------
+
+   procedure Replay_Flow_Msgs_Entry (Obj : JSON_Value) is
+   begin
+      if Has_Field (Obj, "msg_id") then
+         Set_Field
+           (Obj,
+            "msg_id",
+            Integer
+              (Message_Ids.Element
+                 (Message_Id (Integer'(Get (Obj, "msg_id"))))));
+      end if;
+
+      if Has_Field (Obj, "tracefile") then
+         Set_Field
+           (Obj,
+            "tracefile",
+            Trace_Files.Element (String'(Get (Obj, "tracefile"))));
+      end if;
+
+      Append (Flow_Msgs, Obj);
+   end Replay_Flow_Msgs_Entry;
+
+   -----------------------
+   -- Replay_Trace_File --
+   -----------------------
+
+   procedure Replay_Trace_File (Name : String) is
+      Renamed : constant String := Fresh_Trace_File;
+   begin
+      if Ada.Directories.Exists (Renamed) then
+         Ada.Directories.Delete_File (Renamed);
+      end if;
+
+      Ada.Directories.Rename (Name, Renamed);
+      Trace_Files.Insert (Name, Renamed);
+   end Replay_Trace_File;
+
+   ------------------
+   -- Save_Journal --
+   ------------------
+
+   procedure Save_Journal (File_Name : String) is
+      Journal : constant JSON_Value := Create_Object;
+      File    : Ada.Text_IO.File_Type;
+   begin
+      Set_Field (Journal, "entities", Entities);
+      Set_Field (Journal, "flow_error", Found_Flow_Error);
+
+      Ada.Text_IO.Create (File, Ada.Text_IO.Out_File, File_Name);
+      Ada.Text_IO.Put (File, Write (Journal, Compact => True));
+      Ada.Text_IO.Close (File);
+   end Save_Journal;
+
+   --------------------
+   -- Start_Flow_Msg --
+   --------------------
+
+   procedure Start_Flow_Msg (Key : String) is
+      Obj : JSON_Value;
+   begin
+      if Recording then
+         Obj := Create_Object;
+         Set_Field (Obj, "key", Key);
+         Append_Entry (Flow_Msg_Start, Obj);
+      end if;
+   end Start_Flow_Msg;
+
+   ------------------
+   -- Start_Worker --
+   ------------------
+
+   procedure Start_Worker (Worker : Positive) is
+   begin
+      Recording := True;
+      Flow_Msgs_Mark := Length (Flow_Msgs);
+      Warnings_Errors_Mark := Length (Warnings_Errors);
+      Skip_Message_Ids (Next_Message_Id + Message_Id (Worker_Stride * Worker));
+      Skip_Trace_Files (Trace_File_Count + Worker_Stride * Worker);
+   end Start_Worker;
+
+   -------------------
+   -- Sync_Messages --
+   -------------------
+
+   procedure Sync_Messages is
+
+      procedure Sync
+        (Msgs : JSON_Array; Mark : in out Natural; Kind : Entry_Kind);
+      --  Journal the entries of Msgs which come after Mark
+
+      ----------
+      -- Sync --
+      ----------
+
+      procedure Sync
+        (Msgs : JSON_Array; Mark : in out Natural; Kind : Entry_Kind)
+      is
+         Obj : JSON_Value;
+      begin
+         for Index in Mark + 1 .. Length (Msgs) loop
+            Obj := Create_Object;
+            Set_Field (Obj, "kind", Entry_Kind'Image (Kind));
+            Set_Field (Obj, "value", Get (Msgs, Index));
+            Append (Entity_Entries, Obj);
+         end loop;
+         Mark := Length (Msgs);
+      end Sync;
+
+      --  Start of processing for Sync_Messages
+
+   begin
+      Sync (Flow_Msgs, Flow_Msgs_Mark, Flow_Msgs_Entry);
+      Sync (Warnings_Errors, Warnings_Errors_Mark, Warnings_Errors_Entry);
+   end Sync_Messages;
+
+end Flow_Journal;
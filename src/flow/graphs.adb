@@ -22,12 +22,15 @@
 ------------------------------------------------------------------------------
 
 with Ada.Containers.Doubly_Linked_Lists;
+with Ada.Containers.Generic_Sort;
 with Ada.Integer_Text_IO; use Ada.Integer_Text_IO;
 with Ada.Text_IO;         use Ada.Text_IO;
+with Ada.Unchecked_Deallocation;
 with GNAT.OS_Lib;         use GNAT.OS_Lib;
 with GNAT.Strings;
 
-with Hashing; use Hashing;
+with Dense_Bitsets;
+with Hashing;       use Hashing;
 
 use type Ada.Containers.Count_Type;
 
@@ -50,6 +53,34 @@ function Dominator_Tree_Internal
    --  function calls this, and so does Dominance_Frontier as its
    --  easier to work with the array representation.
 
+   procedure Build_In_Edges (E : in out Compact_Edges);
+   --  Compute the in-edges of the compact layout E from its out-edges
+
+   function Find_Out_Edge
+     (G : Graph; V_1, V_2 : Valid_Vertex_Id) return Edge_Count
+   with Pre => G.Compacted;
+   --  Return the position of the edge from V_1 to V_2 in the compact layout
+   --  of G, or zero if there is no such edge.
+
+   procedure Move_Edges (Target, Source : in out Compact_Edges);
+   --  Move (not copy) the compact layout from Source to Target
+
+   procedure Sort_Out_Edges (E : in out Compact_Edges);
+   --  Fill in the Out_Sorted vector of the compact layout E
+
+   generic
+      with procedure Process (W : Valid_Vertex_Id);
+   procedure Visit_Neighbours
+     (G : Graph; V : Valid_Vertex_Id; Reversed : Boolean);
+   --  Call Process on each out-neighbour of V, or on each in-neighbour if
+   --  Reversed is True, in the order in which G stores them.
+
+   generic
+      with procedure Process (W : Valid_Vertex_Id; Atr : Edge_Attributes);
+   procedure Visit_Out_Edges (G : Graph; V : Valid_Vertex_Id);
+   --  Call Process on each out-neighbour of V together with the attributes
+   --  of the edge leading to it.
+
    ---------------
    -- Is_Frozen --
    ---------------
@@ -57,6 +88,13 @@ function Dominator_Tree_Internal
    function Is_Frozen (G : Graph) return Boolean
    is (G.Frozen);
 
+   ----------------
+   -- Is_Compact --
+   ----------------
+
+   function Is_Compact (G : Graph) return Boolean
+   is (G.Compacted);
+
    --------------
    -- Add_Edge --
    --------------
@@ -192,24 +230,27 @@ procedure Enqueue (A : Valid_Vertex_Id; B : Valid_Vertex_Id; D : Natural)
       ----------------------
 
       procedure Enqueue_Children (V : Valid_Vertex_Id; D : Natural) is
+
+         procedure Enqueue_Child (W : Valid_Vertex_Id);
+         --  Add the link V -> W to the queue, unless W is already queued
+
+         -------------------
+         -- Enqueue_Child --
+         -------------------
+
+         procedure Enqueue_Child (W : Valid_Vertex_Id) is
+         begin
+            if not Marked (W) then
+               Enqueue (A => V, B => W, D => D + 1);
+            end if;
+         end Enqueue_Child;
+
+         procedure Enqueue_All is new Visit_Neighbours (Enqueue_Child);
+
+         --  Start of processing for Enqueue_Children
+
       begin
-         if Reversed then
-            for W of G.Vertices (V).In_Neighbours loop
-               if not Marked (W) then
-                  Enqueue (A => V, B => W, D => D + 1);
-               end if;
-            end loop;
-         else
-            for C in G.Vertices (V).Out_Neighbours.Iterate loop
-               declare
-                  W : constant Valid_Vertex_Id := Key (C);
-               begin
-                  if not Marked (W) then
-                     Enqueue (A => V, B => W, D => D + 1);
-                  end if;
-               end;
-            end loop;
-         end if;
+         Enqueue_All (G, V, Reversed);
       end Enqueue_Children;
 
       --  Start of processing for BFS
@@ -247,13 +288,60 @@ procedure Enqueue_Children (V : Valid_Vertex_Id; D : Natural) is
 
    end BFS;
 
+   --------------------
+   -- Build_In_Edges --
+   --------------------
+
+   procedure Build_In_Edges (E : in out Compact_Edges) is
+      Last : constant Vertex_Id := E.Out_Offsets.Last_Index - 1;
+      Next : Edge_Offset_Vectors.Vector;
+      --  Next free position for an in-edge of each vertex
+   begin
+      --  Count the in-edges of each vertex V in In_Offsets (V + 1) and then
+      --  accumulate the counts into offsets.
+
+      E.In_Offsets :=
+        Edge_Offset_Vectors.To_Vector
+          (0, Ada.Containers.Count_Type (Last + 1));
+
+      for W of E.Out_Targets loop
+         E.In_Offsets (W + 1) := E.In_Offsets (W + 1) + 1;
+      end loop;
+
+      E.In_Offsets (1) := 1;
+      for V in Valid_Vertex_Id range 2 .. Last + 1 loop
+         E.In_Offsets (V) := E.In_Offsets (V) + E.In_Offsets (V - 1);
+      end loop;
+
+      --  Then walk the out-edges again to fill in the sources, which are
+      --  thus listed in increasing order for each vertex.
+
+      Next := E.In_Offsets;
+      E.In_Sources := Edge_Vertex_Vectors.To_Vector (1, E.Out_Targets.Length);
+
+      for V in Valid_Vertex_Id range 1 .. Last loop
+         for P in E.Out_Offsets (V) .. E.Out_Offsets (V + 1) - 1 loop
+            declare
+               W : constant Valid_Vertex_Id := E.Out_Targets (P);
+            begin
+               E.In_Sources (Next (W)) := V;
+               Next (W) := Next (W) + 1;
+            end;
+         end loop;
+      end loop;
+   end Build_In_Edges;
+
    -----------
    -- Child --
    -----------
 
    function Child (G : Graph; V : Vertex_Id) return Vertex_Id is
    begin
-      return EAM.Key (G.Vertices (V).Out_Neighbours.First);
+      if G.Compacted then
+         return G.Edges.Out_Targets (G.Edges.Out_Offsets (V));
+      else
+         return EAM.Key (G.Vertices (V).Out_Neighbours.First);
+      end if;
    end Child;
 
    ------------------
@@ -285,16 +373,17 @@ procedure Clear_Vertex (G : in out Graph; V : Vertex_Id) is
    -----------
 
    procedure Close (G : in out Graph) is
+      Dense_Closure_Limit : constant := 2 ** 14;
+      --  Successor sets are bitsets for graphs with up to this many vertices,
+      --  which bounds their total size to 32MB; larger graphs use hashed
+      --  sets, whose size only depends on the number of edges of the closure.
+
       type Component is new Natural;
 
       type V_To_V is
         array (Valid_Vertex_Id range 1 .. G.Vertices.Last_Index)
         of Valid_Vertex_Id;
 
-      type V_To_VIS is
-        array (Valid_Vertex_Id range 1 .. G.Vertices.Last_Index)
-        of Vertex_Index_Set;
-
       type V_To_Comp is
         array (Valid_Vertex_Id range 1 .. G.Vertices.Last_Index) of Component;
 
@@ -308,87 +397,345 @@ procedure Close (G : in out Graph) is
       type V_To_Index is
         array (Valid_Vertex_Id range 1 .. G.Vertices.Last_Index) of Index;
 
-      Stack   : Vertex_Index_List := VIL.Empty_Vector;
-      Root    : V_To_Index := V_To_Index'(others => 0);
-      Comp    : V_To_Comp := V_To_Comp'(others => 0);
-      Succ    : V_To_V;
-      Sets    : V_To_VIS;
-      Counter : Index := 0;
+      generic
+         type Successor_Set is private;
+         with function New_Set return Successor_Set;
+         with procedure Include
+           (S : in out Successor_Set; V : Valid_Vertex_Id);
+         with procedure Union
+           (Target : in out Successor_Set; Source : Successor_Set);
+         with procedure Release (S : in out Successor_Set);
+         with procedure Iterate
+           (S       : Successor_Set;
+            Process : not null access procedure (W : Valid_Vertex_Id));
+      procedure Generic_Close;
+      --  Compute the transitive closure with sets of successors of the given
+      --  type, then add the missing edges to G.
+
+      -------------------
+      -- Generic_Close --
+      -------------------
+
+      procedure Generic_Close is
+         type V_To_Set is
+           array (Valid_Vertex_Id range 1 .. G.Vertices.Last_Index)
+           of Successor_Set;
+
+         Stack   : Vertex_Index_List := VIL.Empty_Vector;
+         Root    : V_To_Index := V_To_Index'(others => 0);
+         Comp    : V_To_Comp := V_To_Comp'(others => 0);
+         Succ    : V_To_V;
+         Sets    : V_To_Set;
+         Counter : Index := 0;
+
+         Current_Component : Component := 0;
+
+         procedure SIMPLE_TC (V : Valid_Vertex_Id);
+         --  See Nuutila's PhD thesis.
+
+         ---------------
+         -- SIMPLE_TC --
+         ---------------
+
+         procedure SIMPLE_TC (V : Valid_Vertex_Id) is
+            Me : constant Index := Counter + 1;
+
+            procedure Add_Successor (W : Valid_Vertex_Id);
+            --  Record W as a successor of V
+
+            procedure Visit_Successor (W : Valid_Vertex_Id);
+            --  Close W and merge its successors into those of V
+
+            -------------------
+            -- Add_Successor --
+            -------------------
+
+            procedure Add_Successor (W : Valid_Vertex_Id) is
+            begin
+               Include (Sets (Succ (V)), W);
+            end Add_Successor;
 
-      Current_Component : Component := 0;
+            ---------------------
+            -- Visit_Successor --
+            ---------------------
 
-      procedure SIMPLE_TC (V : Valid_Vertex_Id);
-      --  See Nuutila's PhD thesis.
+            procedure Visit_Successor (W : Valid_Vertex_Id) is
+            begin
+               if Root (W) = 0 then
+                  SIMPLE_TC (W);
+               end if;
+               if Comp (W) = 0 then
+                  Root (V) := Index'Min (Root (V), Root (W));
+               end if;
+               if Succ (W) /= Succ (V) then
+                  Union (Sets (Succ (V)), Sets (Succ (W)));
+               end if;
+            end Visit_Successor;
 
-      ---------------
-      -- SIMPLE_TC --
-      ---------------
+            procedure Add_Successors is new Visit_Neighbours (Add_Successor);
 
-      procedure SIMPLE_TC (V : Valid_Vertex_Id) is
-         Me : constant Index := Counter + 1;
-      begin
-         Root (V) := Me;
+            procedure Visit_Successors is new
+              Visit_Neighbours (Visit_Successor);
 
-         Counter := Counter + 1;
+            --  Start of processing for SIMPLE_TC
 
-         Stack.Append (V);
+         begin
+            Root (V) := Me;
 
-         Succ (V) := V;
-         for C in G.Vertices (V).Out_Neighbours.Iterate loop
-            declare
-               W : Valid_Vertex_Id renames Key (C);
-            begin
-               Sets (Succ (V)).Insert (W);
-            end;
+            Counter := Counter + 1;
+
+            Stack.Append (V);
+
+            Succ (V) := V;
+            Sets (V) := New_Set;
+            Add_Successors (G, V, Reversed => False);
+
+            Visit_Successors (G, V, Reversed => False);
+
+            if Root (V) = Me then
+               Current_Component := Current_Component + 1;
+               loop
+                  declare
+                     W : constant Valid_Vertex_Id := Stack.Last_Element;
+                  begin
+                     Stack.Delete_Last;
+
+                     Comp (W) := Current_Component;
+
+                     --  The successors of W have been merged into those of
+                     --  V, so its own set is no longer needed.
+
+                     if W /= V then
+                        Release (Sets (W));
+                     end if;
+                     Succ (W) := Succ (V); --  Pointer copy
+
+                     exit when W = V;
+                  end;
+               end loop;
+            end if;
+         end SIMPLE_TC;
+
+      --  Start of processing for Generic_Close
+
+      begin
+         for V in Valid_Vertex_Id range 1 .. G.Vertices.Last_Index loop
+            if Root (V) = 0 then
+               SIMPLE_TC (V);
+            end if;
          end loop;
 
-         for C in G.Vertices (V).Out_Neighbours.Iterate loop
+         if G.Compacted then
+
+            --  Build a new compact layout, appending the missing edges of
+            --  each vertex after its existing ones.
+
             declare
-               W : Valid_Vertex_Id renames Key (C);
+               Closed : Compact_Edges;
+               E      : Compact_Edges renames G.Edges;
             begin
-               if Root (W) = 0 then
-                  SIMPLE_TC (W);
-               end if;
-               if Comp (W) = 0 then
-                  Root (V) := Index'Min (Root (V), Root (W));
-               end if;
-               Sets (Succ (V)).Union (Sets (Succ (W)));
+               for V in Valid_Vertex_Id range 1 .. G.Vertices.Last_Index loop
+                  Closed.Out_Offsets.Append
+                    (Edge_Count (Closed.Out_Targets.Length) + 1);
+
+                  for P in E.Out_Offsets (V) .. E.Out_Offsets (V + 1) - 1 loop
+                     Closed.Out_Targets.Append (E.Out_Targets (P));
+                     Closed.Out_Attributes.Append (E.Out_Attributes (P));
+                  end loop;
+
+                  declare
+                     procedure Append_Missing_Edge (W : Valid_Vertex_Id);
+                     --  Append the edge from V to W unless it already exists
+
+                     -------------------------
+                     -- Append_Missing_Edge --
+                     -------------------------
+
+                     procedure Append_Missing_Edge (W : Valid_Vertex_Id) is
+                     begin
+                        if Find_Out_Edge (G, V, W) = 0 then
+                           Closed.Out_Targets.Append (W);
+                           Closed.Out_Attributes.Append
+                             (Edge_Attributes'
+                                (Marked => False, Colour => G.Default_Colour));
+                        end if;
+                     end Append_Missing_Edge;
+
+                  begin
+                     Iterate (Sets (Succ (V)), Append_Missing_Edge'Access);
+                  end;
+               end loop;
+               Closed.Out_Offsets.Append
+                 (Edge_Count (Closed.Out_Targets.Length) + 1);
+
+               Sort_Out_Edges (Closed);
+               Build_In_Edges (Closed);
+
+               Move_Edges (Target => G.Edges, Source => Closed);
             end;
-         end loop;
 
-         if Root (V) = Me then
-            Current_Component := Current_Component + 1;
-            loop
+         else
+            for V in Valid_Vertex_Id range 1 .. G.Vertices.Last_Index loop
                declare
-                  W : constant Valid_Vertex_Id := Stack.Last_Element;
-               begin
-                  Stack.Delete_Last;
+                  procedure Add_Missing_Edge (W : Valid_Vertex_Id);
+                  --  Add the edge from V to W unless it already exists
 
-                  Comp (W) := Current_Component;
-                  Succ (W) := Succ (V); --  Pointer copy
+                  ----------------------
+                  -- Add_Missing_Edge --
+                  ----------------------
 
-                  exit when W = V;
+                  procedure Add_Missing_Edge (W : Valid_Vertex_Id) is
+                  begin
+                     if not G.Edge_Exists (V, W) then
+                        G.Add_Edge (V, W, G.Default_Colour);
+                     end if;
+                  end Add_Missing_Edge;
+
+               begin
+                  Iterate (Sets (Succ (V)), Add_Missing_Edge'Access);
                end;
             end loop;
          end if;
-      end SIMPLE_TC;
 
-      --  Start of processing for Close
+         for V in Valid_Vertex_Id range 1 .. G.Vertices.Last_Index loop
+            if Succ (V) = V then
+               Release (Sets (V));
+            end if;
+         end loop;
+      end Generic_Close;
 
-   begin
-      for V in Valid_Vertex_Id range 1 .. G.Vertices.Last_Index loop
-         if Root (V) = 0 then
-            SIMPLE_TC (V);
-         end if;
-      end loop;
+      --  Dense successor sets
 
-      for V in Valid_Vertex_Id range 1 .. G.Vertices.Last_Index loop
-         for W of Sets (Succ (V)) loop
-            if not G.Edge_Exists (V, W) then
-               G.Add_Edge (V, W, G.Default_Colour);
-            end if;
+      type Bitset_Access is access Dense_Bitsets.Bitset;
+
+      procedure Free is new
+        Ada.Unchecked_Deallocation (Dense_Bitsets.Bitset, Bitset_Access);
+
+      function New_Bitset return Bitset_Access
+      is (new Dense_Bitsets.Bitset'
+            (Dense_Bitsets.Empty_Set (Natural (G.Vertices.Last_Index))));
+
+      procedure Include (S : in out Bitset_Access; V : Valid_Vertex_Id);
+
+      procedure Union (Target : in out Bitset_Access; Source : Bitset_Access);
+
+      procedure Iterate
+        (S       : Bitset_Access;
+         Process : not null access procedure (W : Valid_Vertex_Id));
+
+      -------------
+      -- Include --
+      -------------
+
+      procedure Include (S : in out Bitset_Access; V : Valid_Vertex_Id) is
+      begin
+         Dense_Bitsets.Include (S.all, Natural (V));
+      end Include;
+
+      -------------
+      -- Iterate --
+      -------------
+
+      procedure Iterate
+        (S       : Bitset_Access;
+         Process : not null access procedure (W : Valid_Vertex_Id))
+      is
+         procedure Process_Element (Element : Natural);
+         --  Call Process on the vertex numbered Element
+
+         ---------------------
+         -- Process_Element --
+         ---------------------
+
+         procedure Process_Element (Element : Natural) is
+         begin
+            Process (Valid_Vertex_Id (Element));
+         end Process_Element;
+
+         procedure Iterate_Elements is new
+           Dense_Bitsets.Iterate (Process_Element);
+
+      begin
+         Iterate_Elements (S.all);
+      end Iterate;
+
+      -----------
+      -- Union --
+      -----------
+
+      procedure Union (Target : in out Bitset_Access; Source : Bitset_Access)
+      is
+      begin
+         Dense_Bitsets.Union (Target.all, Source.all);
+      end Union;
+
+      procedure Dense_Close is new
+        Generic_Close
+          (Successor_Set => Bitset_Access,
+           New_Set       => New_Bitset,
+           Include       => Include,
+           Union         => Union,
+           Release       => Free,
+           Iterate       => Iterate);
+
+      --  Sparse successor sets
+
+      procedure Include (S : in out Vertex_Index_Set; V : Valid_Vertex_Id);
+
+      procedure Release (S : in out Vertex_Index_Set);
+
+      procedure Iterate
+        (S       : Vertex_Index_Set;
+         Process : not null access procedure (W : Valid_Vertex_Id));
+
+      -------------
+      -- Include --
+      -------------
+
+      procedure Include (S : in out Vertex_Index_Set; V : Valid_Vertex_Id) is
+      begin
+         S.Include (V);
+      end Include;
+
+      -------------
+      -- Iterate --
+      -------------
+
+      procedure Iterate
+        (S       : Vertex_Index_Set;
+         Process : not null access procedure (W : Valid_Vertex_Id)) is
+      begin
+         for W of S loop
+            Process (W);
          end loop;
-      end loop;
+      end Iterate;
+
+      -------------
+      -- Release --
+      -------------
+
+      procedure Release (S : in out Vertex_Index_Set) is
+      begin
+         S.Clear;
+      end Release;
+
+      procedure Sparse_Close is new
+        Generic_Close
+          (Successor_Set => Vertex_Index_Set,
+           New_Set       => VIS.Empty_Set,
+           Include       => Include,
+           Union         => VIS.Union,
+           Release       => Release,
+           Iterate       => Iterate);
+
+      --  Start of processing for Close
+
+   begin
+      if G.Vertices.Last_Index <= Dense_Closure_Limit then
+         Dense_Close;
+      else
+         Sparse_Close;
+      end if;
    end Close;
 
    ---------
@@ -428,12 +775,38 @@ procedure VISIT (V : Valid_Vertex_Id);
       --  Tarjan's algorithm for strongly connected components, as described in
       --  Nuutila's PhD thesis.
 
+      procedure Add_Component_Edges (V : Valid_Vertex_Id);
+      --  Add the edges from the component of V to the components of its
+      --  out-neighbours, except for self-loops.
+
       -----------
       -- VISIT --
       -----------
 
       procedure VISIT (V : Valid_Vertex_Id) is
          Me : constant Index := Counter + 1;
+
+         procedure Visit_Successor (W : Valid_Vertex_Id);
+         --  Visit W and update the root of V
+
+         ---------------------
+         -- Visit_Successor --
+         ---------------------
+
+         procedure Visit_Successor (W : Valid_Vertex_Id) is
+         begin
+            if Root (W) = 0 then
+               VISIT (W);
+            end if;
+            if Comp (W) = 0 then
+               Root (V) := Index'Min (Root (V), Root (W));
+            end if;
+         end Visit_Successor;
+
+         procedure Visit_Successors is new Visit_Neighbours (Visit_Successor);
+
+         --  Start of processing for VISIT
+
       begin
          Root (V) := Me;
 
@@ -441,18 +814,7 @@ procedure VISIT (V : Valid_Vertex_Id) is
 
          Stack.Append (V);
 
-         for C in G.Vertices (V).Out_Neighbours.Iterate loop
-            declare
-               W : Valid_Vertex_Id renames Key (C);
-            begin
-               if Root (W) = 0 then
-                  VISIT (W);
-               end if;
-               if Comp (W) = 0 then
-                  Root (V) := Index'Min (Root (V), Root (W));
-               end if;
-            end;
-         end loop;
+         Visit_Successors (G, V, Reversed => False);
 
          if Root (V) = Me then
             Current_Component := Current_Component + 1;
@@ -478,6 +840,35 @@ procedure VISIT (V : Valid_Vertex_Id) is
         Components.Component_Graph;
       --  Condensation graph and its transitive closure, respectively
 
+      -------------------------
+      -- Add_Component_Edges --
+      -------------------------
+
+      procedure Add_Component_Edges (V : Valid_Vertex_Id) is
+
+         procedure Add_Component_Edge (W : Valid_Vertex_Id);
+         --  Add the edge from the component of V to that of W
+
+         ------------------------
+         -- Add_Component_Edge --
+         ------------------------
+
+         procedure Add_Component_Edge (W : Valid_Vertex_Id) is
+         begin
+            if Comp (V) /= Comp (W) then
+               --  avoid self-loops
+               CG (Component_Id (Comp (V))).Include (Component_Id (Comp (W)));
+            end if;
+         end Add_Component_Edge;
+
+         procedure Add_All is new Visit_Neighbours (Add_Component_Edge);
+
+         --  Start of processing for Add_Component_Edges
+
+      begin
+         Add_All (G, V, Reversed => False);
+      end Add_Component_Edges;
+
       --  Start of processing for SCC
 
    begin
@@ -502,17 +893,7 @@ procedure VISIT (V : Valid_Vertex_Id) is
 
          --  Store edges between strongly connected components but avoid loops
 
-         for C in G.Vertices (V).Out_Neighbours.Iterate loop
-            declare
-               W : Valid_Vertex_Id renames Key (C);
-            begin
-               if Comp (V) /= Comp (W) then
-                  --  avoid self-loops
-                  CG (Component_Id (Comp (V))).Include
-                    (Component_Id (Comp (W)));
-               end if;
-            end;
-         end loop;
+         Add_Component_Edges (V);
       end loop;
 
       --  Tarjan's algorithm enumerates strongly connected components in
@@ -556,6 +937,51 @@ function Cluster_To_Natural (G : Graph; C : Cluster_Id) return Natural is
       return Natural (C);
    end Cluster_To_Natural;
 
+   -------------
+   -- Compact --
+   -------------
+
+   procedure Compact (G : in out Graph) is
+      E : Compact_Edges renames G.Edges;
+   begin
+      G.Frozen := True;
+
+      if G.Compacted then
+         return;
+      end if;
+
+      E.Out_Targets.Reserve_Capacity (Ada.Containers.Count_Type (G.Num_Edges));
+      E.Out_Attributes.Reserve_Capacity (E.Out_Targets.Capacity);
+      E.In_Sources.Reserve_Capacity (E.Out_Targets.Capacity);
+
+      for V in Valid_Vertex_Id range 1 .. G.Vertices.Last_Index loop
+         E.Out_Offsets.Append (Edge_Count (E.Out_Targets.Length) + 1);
+         E.In_Offsets.Append (Edge_Count (E.In_Sources.Length) + 1);
+
+         --  Keep the neighbours in the order of the hashed containers, so
+         --  that traversals visit vertices in the same order as before.
+
+         for C in G.Vertices (V).Out_Neighbours.Iterate loop
+            E.Out_Targets.Append (Key (C));
+            E.Out_Attributes.Append (Element (C));
+         end loop;
+
+         for W of G.Vertices (V).In_Neighbours loop
+            E.In_Sources.Append (W);
+         end loop;
+
+         G.Vertices (V).Out_Neighbours := EAM.Empty_Map;
+         G.Vertices (V).In_Neighbours := VIS.Empty_Set;
+      end loop;
+
+      E.Out_Offsets.Append (Edge_Count (E.Out_Targets.Length) + 1);
+      E.In_Offsets.Append (Edge_Count (E.In_Sources.Length) + 1);
+
+      Sort_Out_Edges (E);
+
+      G.Compacted := True;
+   end Compact;
+
    --------------
    -- Contains --
    --------------
@@ -565,27 +991,43 @@ function Contains (G : Graph; V : Vertex_Key) return Boolean is
       return Get_Vertex (G, V) /= Null_Vertex;
    end Contains;
 
+   function Contains (S : Vertex_Bitset; V : Vertex_Id) return Boolean
+   is (Contains (S, Natural (V)));
+
    ------------------
    --  Copy_Edges  --
    ------------------
 
    procedure Copy_Edges (G : in out Graph; O : Graph) is
+      V_A : Valid_Vertex_Id;
+      --  Source of the edges being copied
+
+      procedure Copy_Edge (V_B : Valid_Vertex_Id; Atr : Edge_Attributes);
+      --  Copy the edge from V_A to V_B
+
+      ---------------
+      -- Copy_Edge --
+      ---------------
+
+      procedure Copy_Edge (V_B : Valid_Vertex_Id; Atr : Edge_Attributes) is
+      begin
+         G.Add_Edge (V_A, V_B, Atr.Colour);
+         if Atr.Marked then
+            G.Mark_Edge (V_A, V_B);
+         end if;
+      end Copy_Edge;
+
+      procedure Copy_Out_Edges is new Visit_Out_Edges (Copy_Edge);
+
+      --  Start of processing for Copy_Edges
+
    begin
       --  Sanity check the length of the two graphs.
       pragma Assert (G.Vertices.Length = O.Vertices.Length);
 
-      for V_A in Valid_Vertex_Id range 1 .. O.Vertices.Last_Index loop
-         for C in O.Vertices (V_A).Out_Neighbours.Iterate loop
-            declare
-               V_B : constant Valid_Vertex_Id := Key (C);
-               Atr : constant Edge_Attributes := Element (C);
-            begin
-               G.Add_Edge (V_A, V_B, Atr.Colour);
-               if Atr.Marked then
-                  G.Mark_Edge (V_A, V_B);
-               end if;
-            end;
-         end loop;
+      for V in Valid_Vertex_Id range 1 .. O.Vertices.Last_Index loop
+         V_A := V;
+         Copy_Out_Edges (O, V_A);
       end loop;
    end Copy_Edges;
 
@@ -600,6 +1042,8 @@ function Create (Colour : Edge_Colours := Edge_Colours'First) return Graph
         (Vertices       => VL.Empty_Vector,
          Default_Colour => Colour,
          Frozen         => False,
+         Compacted      => False,
+         Edges          => <>,
          Clusters       => 0,
          Key_To_Id      => Key_To_Id_Maps.Empty_Map);
    end Create;
@@ -675,30 +1119,31 @@ procedure Schedule_Vertex (V : Valid_Vertex_Id) is
       -----------------------
 
       procedure Schedule_Children (V : Valid_Vertex_Id) is
+
+         procedure Schedule_Child (Out_Node : Valid_Vertex_Id);
+         --  Schedule Out_Node, unless it is already scheduled or the edge
+         --  leading to it is not selected.
+
+         --------------------
+         -- Schedule_Child --
+         --------------------
+
+         procedure Schedule_Child (Out_Node : Valid_Vertex_Id) is
+         begin
+            if not Will_Visit (Out_Node) and then Should_Visit (V, Out_Node)
+            then
+               Schedule_Vertex (Out_Node);
+            end if;
+         end Schedule_Child;
+
+         procedure Schedule_All is new Visit_Neighbours (Schedule_Child);
+
+         --  Start of processing for Schedule_Children
+
       begin
-         if Reversed then
-            --  If we're in reversed mode we just go through the in
-            --  neighbours instead of the out neighbours. No other
-            --  difference.
-            for Out_Node of G.Vertices (V).In_Neighbours loop
-               if not Will_Visit (Out_Node) and then Should_Visit (V, Out_Node)
-               then
-                  Schedule_Vertex (Out_Node);
-               end if;
-            end loop;
-         else
-            for C in G.Vertices (V).Out_Neighbours.Iterate loop
-               declare
-                  Out_Node : constant Valid_Vertex_Id := Key (C);
-               begin
-                  if not Will_Visit (Out_Node)
-                    and then Should_Visit (V, Out_Node)
-                  then
-                     Schedule_Vertex (Out_Node);
-                  end if;
-               end;
-            end loop;
-         end if;
+         --  If we're in reversed mode we just go through the in neighbours
+         --  instead of the out neighbours. No other difference.
+         Schedule_All (G, V, Reversed);
       end Schedule_Children;
 
       ------------------
@@ -760,21 +1205,39 @@ function Should_Visit (A : Vertex_Id; B : Vertex_Id) return Boolean is
    function Dominance_Frontier (G : Graph; R : Vertex_Id) return Graph is
       Dom : constant Vertex_To_Vertex_T := Dominator_Tree_Internal (G, R);
       DF  : Graph := Create (G);
+      B   : Valid_Vertex_Id;
+      --  Join point whose predecessors are being processed
+
+      procedure Run_From (P : Valid_Vertex_Id);
+      --  Walk up the dominator tree from predecessor P of B
+
+      --------------
+      -- Run_From --
+      --------------
+
+      procedure Run_From (P : Valid_Vertex_Id) is
+      begin
+         if Dom (P) in Valid_Vertex_Id then
+            declare
+               Runner : Valid_Vertex_Id := P;
+            begin
+               while Runner /= Dom (B) loop
+                  DF.Add_Edge (B, Runner, DF.Default_Colour);
+                  Runner := Dom (Runner);
+               end loop;
+            end;
+         end if;
+      end Run_From;
+
+      procedure Run_From_All is new Visit_Neighbours (Run_From);
+
+      --  Start of processing for Dominance_Frontier
+
    begin
-      for B in Valid_Vertex_Id range 1 .. G.Vertices.Last_Index loop
-         if G.Vertices (B).In_Neighbours.Length >= 2 then
-            for P of G.Vertices (B).In_Neighbours loop
-               if Dom (P) in Valid_Vertex_Id then
-                  declare
-                     Runner : Valid_Vertex_Id := P;
-                  begin
-                     while Runner /= Dom (B) loop
-                        DF.Add_Edge (B, Runner, DF.Default_Colour);
-                        Runner := Dom (Runner);
-                     end loop;
-                  end;
-               end if;
-            end loop;
+      for V in Valid_Vertex_Id range 1 .. G.Vertices.Last_Index loop
+         if G.In_Neighbour_Count (V) >= 2 then
+            B := V;
+            Run_From_All (G, B, Reversed => True);
          end if;
       end loop;
 
@@ -814,11 +1277,35 @@ function Eval (V : Valid_Vertex_Id) return Vertex_Id;
       procedure Link (V, W : Valid_Vertex_Id);
       --  See paper by Tarjan and Lengauer.
 
+      procedure Update_Semi (W : Valid_Vertex_Id);
+      --  Step 2 of the paper by Tarjan and Lengauer for vertex W
+
       ------------
       -- DT_DFS --
       ------------
 
       procedure DT_DFS (V : Valid_Vertex_Id) is
+
+         procedure Visit_Successor (W : Valid_Vertex_Id);
+         --  Visit W if it has not been numbered yet
+
+         ---------------------
+         -- Visit_Successor --
+         ---------------------
+
+         procedure Visit_Successor (W : Valid_Vertex_Id) is
+         begin
+            if Semi (W) = 0 then
+               Parent (W) := V;
+               DT_DFS (W);
+            end if;
+            --  In_Neighbours is our version of Pred
+         end Visit_Successor;
+
+         procedure Visit_Successors is new Visit_Neighbours (Visit_Successor);
+
+         --  Start of processing for DT_DFS
+
       begin
          N := N + 1;
          Label (V) := V;
@@ -829,17 +1316,7 @@ procedure DT_DFS (V : Valid_Vertex_Id) is
          Ancestor (V) := 0;
          Size (V) := 1;
 
-         for C in G.Vertices (V).Out_Neighbours.Iterate loop
-            declare
-               W : Valid_Vertex_Id renames Key (C);
-            begin
-               if Semi (W) = 0 then
-                  Parent (W) := V;
-                  DT_DFS (W);
-               end if;
-            --  In_Neighbours is our version of Pred
-            end;
-         end loop;
+         Visit_Successors (G, V, Reversed => False);
       end DT_DFS;
 
       --------------
@@ -923,6 +1400,35 @@ procedure Swap (A, B : in out Vertex_Id) is
          end loop;
       end Link;
 
+      -----------------
+      -- Update_Semi --
+      -----------------
+
+      procedure Update_Semi (W : Valid_Vertex_Id) is
+
+         procedure Update_From (V : Valid_Vertex_Id);
+         --  Update the semidominator of W from its predecessor V
+
+         -----------------
+         -- Update_From --
+         -----------------
+
+         procedure Update_From (V : Valid_Vertex_Id) is
+            U : constant Vertex_Id := Eval (V);
+         begin
+            if Semi (U) < Semi (W) then
+               Semi (W) := Semi (U);
+            end if;
+         end Update_From;
+
+         procedure Update_From_All is new Visit_Neighbours (Update_From);
+
+         --  Start of processing for Update_Semi
+
+      begin
+         Update_From_All (G, W, Reversed => True);
+      end Update_Semi;
+
       --  Start of processing for Dominator_Tree_Internal
 
    begin
@@ -940,15 +1446,7 @@ procedure Swap (A, B : in out Vertex_Id) is
             W : constant Valid_Vertex_Id := Vertex (J);
          begin
             --  Step 2
-            for V of G.Vertices (W).In_Neighbours loop
-               declare
-                  U : constant Vertex_Id := Eval (V);
-               begin
-                  if Semi (U) < Semi (W) then
-                     Semi (W) := Semi (U);
-                  end if;
-               end;
-            end loop;
+            Update_Semi (W);
             Bucket (Vertex (Semi (W))).Append (W);
             Link (Parent (W), W);
 
@@ -1012,7 +1510,11 @@ function Dominator_Tree (G : Graph; R : Vertex_Id) return Graph is
    function Edge_Colour (G : Graph; V_1, V_2 : Vertex_Id) return Edge_Colours
    is
    begin
-      return G.Vertices (V_1).Out_Neighbours (V_2).Colour;
+      if G.Compacted then
+         return G.Edges.Out_Attributes (Find_Out_Edge (G, V_1, V_2)).Colour;
+      else
+         return G.Vertices (V_1).Out_Neighbours (V_2).Colour;
+      end if;
    end Edge_Colour;
 
    -----------------
@@ -1025,7 +1527,11 @@ function Edge_Exists (G : Graph; V_1, V_2 : Vertex_Id) return Boolean is
       pragma
         Assert (V_1 <= G.Vertices.Last_Index and V_2 <= G.Vertices.Last_Index);
 
-      return G.Vertices (V_1).Out_Neighbours.Contains (V_2);
+      if G.Compacted then
+         return Find_Out_Edge (G, V_1, V_2) /= 0;
+      else
+         return G.Vertices (V_1).Out_Neighbours.Contains (V_2);
+      end if;
    end Edge_Exists;
 
    function Edge_Exists (G : Graph; V_1, V_2 : Vertex_Key) return Boolean is
@@ -1058,6 +1564,37 @@ function Edge_Exists
       return SCC.Component_Graph (C_1).Contains (C_2);
    end Edge_Exists;
 
+   -------------------
+   -- Find_Out_Edge --
+   -------------------
+
+   function Find_Out_Edge
+     (G : Graph; V_1, V_2 : Valid_Vertex_Id) return Edge_Count
+   is
+      E    : Compact_Edges renames G.Edges;
+      Low  : Edge_Count := E.Out_Offsets (V_1);
+      High : Edge_Count := E.Out_Offsets (V_1 + 1) - 1;
+   begin
+      --  Binary search among the out-edges of V_1, ordered by target
+
+      while Low <= High loop
+         declare
+            Mid : constant Edge_Index := (Low + High) / 2;
+            P   : constant Edge_Index := E.Out_Sorted (Mid);
+         begin
+            if E.Out_Targets (P) = V_2 then
+               return P;
+            elsif E.Out_Targets (P) < V_2 then
+               Low := Mid + 1;
+            else
+               High := Mid - 1;
+            end if;
+         end;
+      end loop;
+
+      return 0;
+   end Find_Out_Edge;
+
    ------------------
    -- First_Cursor --
    ------------------
@@ -1071,14 +1608,22 @@ function First_Cursor (Coll : Vertex_Collection_T) return Cursor is
               Cursor'
                 (Collection_Type   => In_Neighbours,
                  VIS_Native_Cursor =>
-                   G.Vertices (Coll.Id).In_Neighbours.First);
+                   (if G.Compacted
+                    then VIS.No_Element
+                    else G.Vertices (Coll.Id).In_Neighbours.First),
+                 In_Position       =>
+                   (if G.Compacted then G.Edges.In_Offsets (Coll.Id) else 0));
 
          when Out_Neighbours =>
             return
               Cursor'
                 (Collection_Type   => Out_Neighbours,
                  EAM_Native_Cursor =>
-                   G.Vertices (Coll.Id).Out_Neighbours.First);
+                   (if G.Compacted
+                    then EAM.No_Element
+                    else G.Vertices (Coll.Id).Out_Neighbours.First),
+                 Out_Position      =>
+                   (if G.Compacted then G.Edges.Out_Offsets (Coll.Id) else 0));
 
          when All_Vertices   =>
             return
@@ -1141,10 +1686,18 @@ function Get_Element
    begin
       case Coll.The_Type is
          when In_Neighbours  =>
-            return Element (C.VIS_Native_Cursor);
+            if Coll.The_Graph.Compacted then
+               return Coll.The_Graph.Edges.In_Sources (C.In_Position);
+            else
+               return Element (C.VIS_Native_Cursor);
+            end if;
 
          when Out_Neighbours =>
-            return Key (C.EAM_Native_Cursor);
+            if Coll.The_Graph.Compacted then
+               return Coll.The_Graph.Edges.Out_Targets (C.Out_Position);
+            else
+               return Key (C.EAM_Native_Cursor);
+            end if;
 
          when All_Vertices   =>
             return To_Index (C.VL_Native_Cursor);
@@ -1177,8 +1730,15 @@ function Get_Vertex (G : Graph; V : Vertex_Key) return Vertex_Id is
 
    function Has_Element (Coll : Vertex_Collection_T; C : Cursor) return Boolean
    is (case Coll.The_Type is
-         when In_Neighbours  => Has_Element (C.VIS_Native_Cursor),
-         when Out_Neighbours => Has_Element (C.EAM_Native_Cursor),
+         when In_Neighbours  =>
+           (if Coll.The_Graph.Compacted
+            then C.In_Position < Coll.The_Graph.Edges.In_Offsets (Coll.Id + 1)
+            else Has_Element (C.VIS_Native_Cursor)),
+         when Out_Neighbours =>
+           (if Coll.The_Graph.Compacted
+            then
+              C.Out_Position < Coll.The_Graph.Edges.Out_Offsets (Coll.Id + 1)
+            else Has_Element (C.EAM_Native_Cursor)),
          when All_Vertices   => Has_Element (C.VL_Native_Cursor));
 
    ----------
@@ -1221,24 +1781,34 @@ procedure Include_Vertex (G : in out Graph; V : Vertex_Key) is
    function Invert (G : Graph) return Graph is
       R : Graph := Create (G);
       --  Start with an empty graph, with the same vertices.
+
+      V_1 : Valid_Vertex_Id;
+      --  Source of the edges being reversed
+
+      procedure Add_Reversed_Edge
+        (V_2 : Valid_Vertex_Id; Atr : Edge_Attributes);
+      --  Add the edge from V_2 to V_1 to R
+
+      -----------------------
+      -- Add_Reversed_Edge --
+      -----------------------
+
+      procedure Add_Reversed_Edge
+        (V_2 : Valid_Vertex_Id; Atr : Edge_Attributes) is
+      begin
+         R.Vertices (V_2).Out_Neighbours.Insert (V_1, Atr);
+         R.Vertices (V_1).In_Neighbours.Insert (V_2);
+      end Add_Reversed_Edge;
+
+      procedure Add_Reversed_Edges is new Visit_Out_Edges (Add_Reversed_Edge);
+
+      --  Start of processing for Invert
+
    begin
       --  Add reversed edges.
-      for V_1 in Valid_Vertex_Id range 1 .. G.Vertices.Last_Index loop
-         declare
-            Out_Neighbours : Edge_Attribute_Map renames
-              G.Vertices (V_1).Out_Neighbours;
-
-         begin
-            for C in Out_Neighbours.Iterate loop
-               declare
-                  V_2 : Valid_Vertex_Id renames Key (C);
-                  Atr : Edge_Attributes renames Out_Neighbours (C);
-               begin
-                  R.Vertices (V_2).Out_Neighbours.Insert (V_1, Atr);
-                  R.Vertices (V_1).In_Neighbours.Insert (V_2);
-               end;
-            end loop;
-         end;
+      for V in Valid_Vertex_Id range 1 .. G.Vertices.Last_Index loop
+         V_1 := V;
+         Add_Reversed_Edges (G, V_1);
       end loop;
 
       return R;
@@ -1249,7 +1819,9 @@ function Invert (G : Graph) return Graph is
    --------------------------
 
    function In_Neighbour_Count (G : Graph; V : Vertex_Id) return Natural
-   is (Natural (G.Vertices (V).In_Neighbours.Length));
+   is (if G.Compacted
+       then Natural (G.Edges.In_Offsets (V + 1) - G.Edges.In_Offsets (V))
+       else Natural (G.Vertices (V).In_Neighbours.Length));
 
    ---------------
    -- Mark_Edge --
@@ -1262,7 +1834,11 @@ procedure Mark_Edge (G : in out Graph; V_1, V_2 : Vertex_Id) is
         Assert (V_1 <= G.Vertices.Last_Index and V_2 <= G.Vertices.Last_Index);
 
       --  Mark the edge
-      G.Vertices (V_1).Out_Neighbours (V_2).Marked := True;
+      if G.Compacted then
+         G.Edges.Out_Attributes (Find_Out_Edge (G, V_1, V_2)).Marked := True;
+      else
+         G.Vertices (V_1).Out_Neighbours (V_2).Marked := True;
+      end if;
    end Mark_Edge;
 
    ----------
@@ -1274,10 +1850,28 @@ procedure Move (Target : in out Graph; Source : in out Graph) is
       VL.Move (Target.Vertices, Source.Vertices);
       Target.Default_Colour := Source.Default_Colour;
       Target.Frozen := Source.Frozen;
+      Target.Compacted := Source.Compacted;
+      Move_Edges (Target.Edges, Source.Edges);
       Target.Clusters := Source.Clusters;
       Key_To_Id_Maps.Move (Target.Key_To_Id, Source.Key_To_Id);
+      Source.Compacted := False;
    end Move;
 
+   ----------------
+   -- Move_Edges --
+   ----------------
+
+   procedure Move_Edges (Target, Source : in out Compact_Edges) is
+   begin
+      Edge_Offset_Vectors.Move (Target.Out_Offsets, Source.Out_Offsets);
+      Edge_Vertex_Vectors.Move (Target.Out_Targets, Source.Out_Targets);
+      Edge_Attribute_Vectors.Move
+        (Target.Out_Attributes, Source.Out_Attributes);
+      Edge_Position_Vectors.Move (Target.Out_Sorted, Source.Out_Sorted);
+      Edge_Offset_Vectors.Move (Target.In_Offsets, Source.In_Offsets);
+      Edge_Vertex_Vectors.Move (Target.In_Sources, Source.In_Sources);
+   end Move_Edges;
+
    -----------------
    -- New_Cluster --
    -----------------
@@ -1295,13 +1889,29 @@ procedure New_Cluster (G : in out Graph; C : out Cluster_Id) is
    function Next_Cursor (Coll : Vertex_Collection_T; C : Cursor) return Cursor
    is (case Coll.The_Type is
          when In_Neighbours  =>
-           Cursor'
-             (Collection_Type   => In_Neighbours,
-              VIS_Native_Cursor => Next (C.VIS_Native_Cursor)),
+           (if Coll.The_Graph.Compacted
+            then
+              Cursor'
+                (Collection_Type   => In_Neighbours,
+                 VIS_Native_Cursor => VIS.No_Element,
+                 In_Position       => C.In_Position + 1)
+            else
+              Cursor'
+                (Collection_Type   => In_Neighbours,
+                 VIS_Native_Cursor => Next (C.VIS_Native_Cursor),
+                 In_Position       => 0)),
          when Out_Neighbours =>
-           Cursor'
-             (Collection_Type   => Out_Neighbours,
-              EAM_Native_Cursor => Next (C.EAM_Native_Cursor)),
+           (if Coll.The_Graph.Compacted
+            then
+              Cursor'
+                (Collection_Type   => Out_Neighbours,
+                 EAM_Native_Cursor => EAM.No_Element,
+                 Out_Position      => C.Out_Position + 1)
+            else
+              Cursor'
+                (Collection_Type   => Out_Neighbours,
+                 EAM_Native_Cursor => Next (C.EAM_Native_Cursor),
+                 Out_Position      => 0)),
          when All_Vertices   =>
            Cursor'
              (Collection_Type  => All_Vertices,
@@ -1387,6 +1997,200 @@ procedure Are_We_There_Yet
       return Path_Exists;
    end Non_Trivial_Path_Exists;
 
+   ------------------------------
+   -- Non_Trivial_Path_Sources --
+   ------------------------------
+
+   function Non_Trivial_Path_Sources
+     (G        : Graph;
+      F        : not null access function (V : Vertex_Id) return Boolean;
+      Reversed : Boolean := False) return Vertex_Bitset
+   is
+      Reaches : Vertex_Bitset := Empty_Set (Natural (G.Vertices.Last_Index));
+      --  Vertices from which a vertex satisfying F can be reached in zero or
+      --  more steps.
+
+      Sources : Vertex_Bitset := Empty_Set (Natural (G.Vertices.Last_Index));
+      --  Vertices from which it can be reached in one or more steps, i.e.
+      --  those with an edge into Reaches.
+
+      Stack : Vertex_Index_List := VIL.Empty_Vector;
+
+      procedure Visit_Predecessor (W : Valid_Vertex_Id);
+      --  Record W as a source and schedule it, unless already scheduled
+
+      -----------------------
+      -- Visit_Predecessor --
+      -----------------------
+
+      procedure Visit_Predecessor (W : Valid_Vertex_Id) is
+      begin
+         Include (Sources, Natural (W));
+         if not Contains (Reaches, Natural (W)) then
+            Include (Reaches, Natural (W));
+            Stack.Append (W);
+         end if;
+      end Visit_Predecessor;
+
+      procedure Visit_Predecessors is new Visit_Neighbours (Visit_Predecessor);
+
+      --  Start of processing for Non_Trivial_Path_Sources
+
+   begin
+      --  Walk the graph backwards from all vertices satisfying F at once
+
+      for V in Valid_Vertex_Id range 1 .. G.Vertices.Last_Index loop
+         if F (V) then
+            Include (Reaches, Natural (V));
+            Stack.Append (V);
+         end if;
+      end loop;
+
+      while not Stack.Is_Empty loop
+         declare
+            V : constant Valid_Vertex_Id := Stack.Last_Element;
+         begin
+            Stack.Delete_Last;
+            Visit_Predecessors (G, V, Reversed => not Reversed);
+         end;
+      end loop;
+
+      return Sources;
+   end Non_Trivial_Path_Sources;
+
+   -----------------------
+   -- Non_Trivial_Paths --
+   -----------------------
+
+   procedure Non_Trivial_Paths
+     (G         : Graph;
+      Is_Source : not null access function (V : Vertex_Id) return Boolean;
+      Is_Target : not null access function (V : Vertex_Id) return Boolean;
+      Process   : not null access procedure (Source, Target : Vertex_Id))
+   is
+      type Bitset_Access is access Dense_Bitsets.Bitset;
+
+      procedure Free is new
+        Ada.Unchecked_Deallocation (Dense_Bitsets.Bitset, Bitset_Access);
+
+      type Bitset_Array is
+        array (Valid_Vertex_Id range 1 .. G.Vertices.Last_Index)
+        of Bitset_Access;
+
+      type Flag_Array is
+        array (Valid_Vertex_Id range 1 .. G.Vertices.Last_Index) of Boolean;
+
+      Sources : Vertex_Index_List := VIL.Empty_Vector;
+      --  Vertices satisfying Is_Source; the sets below hold their positions
+      --  in this list, starting from zero.
+
+      Reached : Bitset_Array := (others => null);
+      --  Sources with a non-trivial path to each vertex, allocated when the
+      --  vertex is first reached.
+
+      Queued : Flag_Array := (others => False);
+      Stack  : Vertex_Index_List := VIL.Empty_Vector;
+      --  Vertices whose set grew since their successors were last updated
+
+      From : Bitset_Access;
+      --  Set being propagated to the successors of a vertex
+
+      Target : Valid_Vertex_Id;
+      --  Vertex whose sources are being processed
+
+      procedure Process_Source (Position : Natural);
+      --  Call Process on the source at Position and Target
+
+      procedure Reach (W : Valid_Vertex_Id);
+      --  Add the sources of From to the set of W, and schedule W if its set
+      --  grew.
+
+      --------------------
+      -- Process_Source --
+      --------------------
+
+      procedure Process_Source (Position : Natural) is
+      begin
+         Process (Sources (Position + 1), Target);
+      end Process_Source;
+
+      -----------
+      -- Reach --
+      -----------
+
+      procedure Reach (W : Valid_Vertex_Id) is
+      begin
+         if Reached (W) = null then
+            Reached (W) :=
+              new Dense_Bitsets.Bitset'
+                (Dense_Bitsets.Empty_Set (Natural (Sources.Length) - 1));
+         end if;
+
+         if not Dense_Bitsets.Is_Subset (From.all, Reached (W).all) then
+            Dense_Bitsets.Union (Reached (W).all, From.all);
+            if not Queued (W) then
+               Queued (W) := True;
+               Stack.Append (W);
+            end if;
+         end if;
+      end Reach;
+
+      procedure Reach_Successors is new Visit_Neighbours (Reach);
+
+      procedure Process_Sources is new Dense_Bitsets.Iterate (Process_Source);
+
+      --  Start of processing for Non_Trivial_Paths
+
+   begin
+      for V in Valid_Vertex_Id range 1 .. G.Vertices.Last_Index loop
+         if Is_Source (V) then
+            Sources.Append (V);
+         end if;
+      end loop;
+
+      if Sources.Is_Empty then
+         return;
+      end if;
+
+      --  Seed the successors of each source with that source alone
+
+      From :=
+        new Dense_Bitsets.Bitset'
+          (Dense_Bitsets.Empty_Set (Natural (Sources.Length) - 1));
+
+      for Position in Sources.First_Index .. Sources.Last_Index loop
+         Dense_Bitsets.Include (From.all, Position - 1);
+         Reach_Successors (G, Sources (Position), Reversed => False);
+         Dense_Bitsets.Exclude (From.all, Position - 1);
+      end loop;
+
+      Free (From);
+
+      --  Propagate the sets until they are stable; each set only grows, so
+      --  a vertex is scheduled at most once per source.
+
+      while not Stack.Is_Empty loop
+         declare
+            V : constant Valid_Vertex_Id := Stack.Last_Element;
+         begin
+            Stack.Delete_Last;
+            Queued (V) := False;
+            From := Reached (V);
+            Reach_Successors (G, V, Reversed => False);
+         end;
+      end loop;
+
+      for V in Reached'Range loop
+         if Reached (V) /= null then
+            if Is_Target (V) then
+               Target := V;
+               Process_Sources (Reached (V).all);
+            end if;
+            Free (Reached (V));
+         end if;
+      end loop;
+   end Non_Trivial_Paths;
+
    ---------------
    -- Num_Edges --
    ---------------
@@ -1394,6 +2198,10 @@ procedure Are_We_There_Yet
    function Num_Edges (G : Graph) return Natural is
       Count : Natural := 0;
    begin
+      if G.Compacted then
+         return Natural (G.Edges.Out_Targets.Length);
+      end if;
+
       for E of G.Vertices loop
          Count := Count + Natural (E.In_Neighbours.Length);
       end loop;
@@ -1412,16 +2220,21 @@ function Num_Vertices (G : Graph) return Natural
    ---------------------------
 
    function Out_Neighbour_Count (G : Graph; V : Vertex_Id) return Natural
-   is (Natural (G.Vertices (V).Out_Neighbours.Length));
+   is (if G.Compacted
+       then Natural (G.Edges.Out_Offsets (V + 1) - G.Edges.Out_Offsets (V))
+       else Natural (G.Vertices (V).Out_Neighbours.Length));
 
    ------------
    -- Parent --
    ------------
 
    function Parent (G : Graph; V : Vertex_Id) return Vertex_Id is
-      C : constant VIS.Cursor := G.Vertices (V).In_Neighbours.First;
    begin
-      return Element (C);
+      if G.Compacted then
+         return G.Edges.In_Sources (G.Edges.In_Offsets (V));
+      else
+         return Element (G.Vertices (V).In_Neighbours.First);
+      end if;
    end Parent;
 
    -----------------
@@ -1538,6 +2351,57 @@ procedure Make_Tree
 
    end Shortest_Path;
 
+   --------------------
+   -- Sort_Out_Edges --
+   --------------------
+
+   procedure Sort_Out_Edges (E : in out Compact_Edges) is
+   begin
+      E.Out_Sorted.Clear;
+      E.Out_Sorted.Reserve_Capacity (E.Out_Targets.Length);
+      for P in Edge_Index range 1 .. Edge_Count (E.Out_Targets.Length) loop
+         E.Out_Sorted.Append (P);
+      end loop;
+
+      for V in Valid_Vertex_Id range 1 .. E.Out_Offsets.Last_Index - 1 loop
+         declare
+            function Before (Left, Right : Edge_Count) return Boolean;
+            --  Compare the targets of the edges at Left and Right
+
+            procedure Swap (Left, Right : Edge_Count);
+            --  Swap the edges at Left and Right
+
+            ------------
+            -- Before --
+            ------------
+
+            function Before (Left, Right : Edge_Count) return Boolean
+            is (E.Out_Targets (E.Out_Sorted (Left))
+                < E.Out_Targets (E.Out_Sorted (Right)));
+
+            ----------
+            -- Swap --
+            ----------
+
+            procedure Swap (Left, Right : Edge_Count) is
+               Tmp : constant Edge_Index := E.Out_Sorted (Left);
+            begin
+               E.Out_Sorted (Left) := E.Out_Sorted (Right);
+               E.Out_Sorted (Right) := Tmp;
+            end Swap;
+
+            procedure Sort is new
+              Ada.Containers.Generic_Sort
+                (Index_Type => Edge_Count,
+                 Before     => Before,
+                 Swap       => Swap);
+
+         begin
+            Sort (E.Out_Offsets (V), E.Out_Offsets (V + 1) - 1);
+         end;
+      end loop;
+   end Sort_Out_Edges;
+
    -----------------
    -- Vertex_Hash --
    -----------------
@@ -1555,6 +2419,56 @@ function Vertex_To_Natural (G : Graph; V : Vertex_Id) return Natural is
       return Natural (V);
    end Vertex_To_Natural;
 
+   ----------------------
+   -- Visit_Neighbours --
+   ----------------------
+
+   procedure Visit_Neighbours
+     (G : Graph; V : Valid_Vertex_Id; Reversed : Boolean)
+   is
+      E : Compact_Edges renames G.Edges;
+   begin
+      if G.Compacted then
+         if Reversed then
+            for P in E.In_Offsets (V) .. E.In_Offsets (V + 1) - 1 loop
+               Process (E.In_Sources (P));
+            end loop;
+         else
+            for P in E.Out_Offsets (V) .. E.Out_Offsets (V + 1) - 1 loop
+               Process (E.Out_Targets (P));
+            end loop;
+         end if;
+
+      elsif Reversed then
+         for W of G.Vertices (V).In_Neighbours loop
+            Process (W);
+         end loop;
+
+      else
+         for C in G.Vertices (V).Out_Neighbours.Iterate loop
+            Process (Key (C));
+         end loop;
+      end if;
+   end Visit_Neighbours;
+
+   ---------------------
+   -- Visit_Out_Edges --
+   ---------------------
+
+   procedure Visit_Out_Edges (G : Graph; V : Valid_Vertex_Id) is
+      E : Compact_Edges renames G.Edges;
+   begin
+      if G.Compacted then
+         for P in E.Out_Offsets (V) .. E.Out_Offsets (V + 1) - 1 loop
+            Process (E.Out_Targets (P), E.Out_Attributes (P));
+         end loop;
+      else
+         for C in G.Vertices (V).Out_Neighbours.Iterate loop
+            Process (Key (C), Element (C));
+         end loop;
+      end if;
+   end Visit_Out_Edges;
+
    --------------------
    -- Write_Dot_File --
    --------------------
@@ -1602,6 +2516,45 @@ function Escape (S : Unbounded_String) return String is
 
       FD : File_Type;
 
+      V_1 : Valid_Vertex_Id;
+      --  Source of the edges being written
+
+      procedure Write_Edge (V_2 : Valid_Vertex_Id; Atr : Edge_Attributes);
+      --  Write the edge from V_1 to V_2
+
+      ----------------
+      -- Write_Edge --
+      ----------------
+
+      procedure Write_Edge (V_2 : Valid_Vertex_Id; Atr : Edge_Attributes) is
+         Info : constant Edge_Display_Info :=
+           Edge_Info (G, V_1, V_2, Atr.Marked, Atr.Colour);
+      begin
+         if Info.Show then
+            Put (FD, "   ");
+            Put (FD, Valid_Vertex_Id'Image (V_1));
+            Put (FD, " -> ");
+            Put (FD, Valid_Vertex_Id'Image (V_2));
+            Put (FD, " [");
+            case Info.Shape is
+               when Edge_Normal =>
+                  Put (FD, "arrowType=""normal""");
+            end case;
+            if Info.Colour /= Null_Unbounded_String then
+               Put (FD, ",color=""" & To_String (Info.Colour) & """");
+               Put (FD, ",fontcolor=""" & To_String (Info.Colour) & """");
+            end if;
+            if Info.Label /= Null_Unbounded_String then
+               Put (FD, ",label=""" & Escape (Info.Label) & """");
+            end if;
+            Put (FD, "]");
+            Put (FD, ";");
+            New_Line (FD);
+         end if;
+      end Write_Edge;
+
+      procedure Write_Out_Edges is new Visit_Out_Edges (Write_Edge);
+
       --  Start of processing for Write_Dot_File
 
    begin
@@ -1668,38 +2621,9 @@ function Escape (S : Unbounded_String) return String is
          New_Line (FD);
       end loop;
 
-      for V_1 in Valid_Vertex_Id range 1 .. G.Vertices.Last_Index loop
-         for C in G.Vertices (V_1).Out_Neighbours.Iterate loop
-            declare
-               V_2  : Valid_Vertex_Id renames Key (C);
-               Atr  : Edge_Attributes renames Element (C);
-               Info : constant Edge_Display_Info :=
-                 Edge_Info (G, V_1, V_2, Atr.Marked, Atr.Colour);
-            begin
-               if Info.Show then
-                  Put (FD, "   ");
-                  Put (FD, Valid_Vertex_Id'Image (V_1));
-                  Put (FD, " -> ");
-                  Put (FD, Valid_Vertex_Id'Image (V_2));
-                  Put (FD, " [");
-                  case Info.Shape is
-                     when Edge_Normal =>
-                        Put (FD, "arrowType=""normal""");
-                  end case;
-                  if Info.Colour /= Null_Unbounded_String then
-                     Put (FD, ",color=""" & To_String (Info.Colour) & """");
-                     Put
-                       (FD, ",fontcolor=""" & To_String (Info.Colour) & """");
-                  end if;
-                  if Info.Label /= Null_Unbounded_String then
-                     Put (FD, ",label=""" & Escape (Info.Label) & """");
-                  end if;
-                  Put (FD, "]");
-                  Put (FD, ";");
-                  New_Line (FD);
-               end if;
-            end;
-         end loop;
+      for V in Valid_Vertex_Id range 1 .. G.Vertices.Last_Index loop
+         V_1 := V;
+         Write_Out_Edges (G, V_1);
       end loop;
 
       Put_Line (FD, "}");
@@ -0,0 +1,80 @@
+/*****************************************************************************
+ *                                                                           *
+ *                            GNATPROVE COMPONENTS                           *
+ *                                                                           *
+ *                            C L O N E _ F I L E                            *
+ *                                                                           *
+ *                            C Implementation file                          *
+ *                                                                           *
+ *                        Copyright (C) 2026, AdaCore                        *
+ *                                                                           *
+ * gnatprove is  free  software;  you can redistribute it and/or  modify it  *
+ * under terms of the  GNU General Public License as published  by the Free  *
+ * Software  Foundation;  either version 3,  or (at your option)  any later  *
+ * version.  gnatprove is distributed  in the hope that  it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN-  *
+ * TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public  *
+ * License for  more details.  You should have  received  a copy of the GNU  *
+ * General Public License  distributed with  gnatprove;  see file COPYING3.  *
+ * If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the  *
+ * license.                                                                  *
+ *                                                                           *
+ * gnatprove is maintained by AdaCore (http://www.adacore.com)               *
+ *                                                                           *
+ *****************************************************************************/
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <sys/clonefile.h>
+#include <unistd.h>
+#endif
+
+// Create target as a copy-on-write clone of source, which shares the data
+// blocks of source until either file is modified, with the same permissions
+// and timestamps as source. Return 0 if the file system or the OS does not
+// support cloning, or if cloning fails, in which case target does not exist.
+
+int clone_file (const char *source, const char *target) {
+#if defined(__linux__) && defined(FICLONE)
+   struct stat st;
+   int in, out, ok;
+
+   in = open (source, O_RDONLY);
+   if (in == -1) return 0;
+
+   if (fstat (in, &st) == -1) {
+      close (in);
+      return 0;
+   }
+
+   out = open (target, O_WRONLY | O_CREAT | O_EXCL, st.st_mode & 07777);
+   if (out == -1) {
+      close (in);
+      return 0;
+   }
+
+   ok = ioctl (out, FICLONE, in) != -1;
+
+   if (ok) {
+      struct timespec times[2] = { st.st_atim, st.st_mtim };
+      ok = futimens (out, times) != -1;
+   }
+
+   close (in);
+   if (close (out) == -1) ok = 0;
+
+   if (!ok) unlink (target);
+   return ok;
+#elif defined(__APPLE__)
+   return clonefile (source, target, 0) == 0;
+#else
+   (void) source;
+   (void) target;
+   return 0;
+#endif
+}
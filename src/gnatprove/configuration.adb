@@ -2940,12 +2940,30 @@ procedure Set_Warning_Mode is
            "why3server_"
            & PID_String (PID_String'First + 1 .. PID_String'Last)
            & ".sock";
+         Broker_Base : constant String :=
+           "spark_cache_"
+           & PID_String (PID_String'First + 1 .. PID_String'Last)
+           & ".sock";
+         Sched_Base  : constant String :=
+           "spark_sched_"
+           & PID_String (PID_String'First + 1 .. PID_String'Last)
+           & ".sock";
       begin
          Socket_Name :=
            new String'
              ((if Socket_Dir = ""
                then Socket_Base
                else Ada.Directories.Compose (Socket_Dir, Socket_Base)));
+         Cache_Broker_Socket_Name :=
+           new String'
+             ((if Socket_Dir = ""
+               then Broker_Base
+               else Ada.Directories.Compose (Socket_Dir, Broker_Base)));
+         Scheduler_Socket_Name :=
+           new String'
+             ((if Socket_Dir = ""
+               then Sched_Base
+               else Ada.Directories.Compose (Socket_Dir, Sched_Base)));
          if Has_Coq_Prover then
             Prepare_Prover_Lib
               (Tree
@@ -3066,6 +3084,51 @@ procedure Succeed is
       raise GNATprove_Success with "";
    end Succeed;
 
+   ----------------------
+   -- Use_Cache_Broker --
+   ----------------------
+
+   function Use_Cache_Broker return Boolean is
+      Server : GNAT.Strings.String_Access renames CL_Switches.Memcached_Server;
+   begin
+      --  The broker listens on a Unix domain socket, and is only useful for
+      --  a single memcached server, not for a file cache or a tiered cache.
+
+      return
+        not Null_Or_Empty_String (Server)
+        and then not GNATCOLL.Utils.Starts_With (Server.all, "file:")
+        and then Index (Server.all, ",") = 0
+        and then Get_OS_Flavor not in X86_Windows | X86_64_Windows;
+   end Use_Cache_Broker;
+
+   ----------------------
+   -- Use_Flow_Workers --
+   ----------------------
+
+   function Use_Flow_Workers return Boolean is
+   begin
+      --  Worker processes are forked, which is not possible on Windows
+
+      return
+        Use_Semaphores
+        and then Parallel > 1
+        and then Get_OS_Flavor not in X86_Windows | X86_64_Windows;
+   end Use_Flow_Workers;
+
+   -------------------------
+   -- Use_Proof_Scheduler --
+   -------------------------
+
+   function Use_Proof_Scheduler return Boolean is
+   begin
+      --  The scheduler listens on a Unix domain socket, so the semaphore is
+      --  still used on Windows.
+
+      return
+        Use_Semaphores
+        and then Get_OS_Flavor not in X86_Windows | X86_64_Windows;
+   end Use_Proof_Scheduler;
+
    -----------------------
    -- Compute_Why3_Args --
    -----------------------
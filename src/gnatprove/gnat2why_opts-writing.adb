@@ -29,6 +29,7 @@
 with Ada.Text_IO;     use Ada.Text_IO;
 with GNATCOLL.JSON;   use GNATCOLL.JSON;
 with GNAT.SHA1;
+with GG_Files;        use GG_Files;
 with String_Utils;    use String_Utils;
 with VC_Kinds;        use VC_Kinds;
 
@@ -39,7 +40,8 @@ package body Gnat2Why_Opts.Writing is
    ------------------------------------
 
    function Pass_Extra_Options_To_Gnat2why
-     (Translation_Phase : Boolean; Obj_Dir : String) return String
+     (Translation_Phase : Boolean; Obj_Dir : String; Flow_Jobs : Positive)
+      return String
    is
       function Write_To_File (V : JSON_Value) return String;
       --  Write a textual representation of V to file
@@ -167,8 +169,11 @@ function To_JSON (SL : String_Lists.List) return JSON_Array is
          Set_Field (Obj, Ide_Mode_Name, Configuration.IDE_Mode);
          Set_Field (Obj, CWE_Name, CL_Switches.CWE);
          Set_Field (Obj, Parallel_Why3_Name, Use_Semaphores);
+         Set_Field (Obj, Flow_Jobs_Name, Flow_Jobs);
 
          Set_Field (Obj, Why3_Dir_Name, Obj_Dir);
+         Set_Field
+           (Obj, GG_Database_Name, Compose (Obj_Dir, GG_Database_File_Name));
       end if;
 
       --  File-specific options
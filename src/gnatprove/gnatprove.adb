@@ -71,7 +71,9 @@
 with Ada.Text_IO;      use Ada.Text_IO;
 with Call;             use Call;
 with Configuration;    use Configuration;
+with GG_Files;
 with GNAT.OS_Lib;
+with GNAT.SHA1;
 with GNAT.Strings;     use GNAT.Strings;
 with Gnat2Why_Opts;
 with Gnat2Why_Opts.Writing;
@@ -80,16 +82,31 @@
 with GNATCOLL.Utils;   use GNATCOLL.Utils;
 with GNATCOLL.VFS;     use GNATCOLL.VFS;
 with GPR2;             use GPR2;
+with GPR2.Build.Compilation_Unit;
+with GPR2.Build.Compilation_Unit.Maps;
 with GPR2.Project.Attribute;
 with GPR2.Project.Tree;
 with GPR2.Project.View;
+with Interfaces.C;
 with Named_Semaphores; use Named_Semaphores;
+with SPARK2014VSN;     use SPARK2014VSN;
 with String_Utils;     use String_Utils;
 with VC_Kinds;         use VC_Kinds;
 
 procedure Gnatprove with SPARK_Mode is
 
    type Gnatprove_Step is (GS_Data_Representation, GS_ALI, GS_Gnat2Why);
+   --  Steps of the analysis, each of which is a separate invocation of
+   --  gprbuild over the whole project. GS_Data_Representation only reads the
+   --  sources, so it runs in the background during GS_ALI. The other steps
+   --  are run one after the other: phase 2 of gnat2why (GS_Gnat2Why) on a
+   --  unit reads the ALI and GG files written by phase 1 (GS_ALI) for all the
+   --  units of its closure, including the bodies of withed units, and it is
+   --  gprbuild that schedules units and knows their dependencies. Starting
+   --  phase 2 on a unit before phase 1 is complete would require gnatprove to
+   --  schedule gnat2why itself, or phase 2 to wait for the files of its
+   --  closure, which it only discovers after its ALI files have been copied
+   --  by Copy_ALI_Files.
 
    type Plan_Type is array (Positive range <>) of Gnatprove_Step;
 
@@ -98,6 +115,30 @@ procedure Gnatprove with SPARK_Mode is
    --  success. This variable is changed to indicate some error situations that
    --  are not signalled via the GNATprove_Failure exception.
 
+   Data_Representation_Process : GNAT.OS_Lib.Process_Id :=
+     GNAT.OS_Lib.Invalid_Pid;
+   --  Process of the gprbuild call which generates data representation
+   --  information, while it runs concurrently with the generation of ALI
+   --  information.
+
+   Data_Representation_Key   : Ada.Strings.Unbounded.Unbounded_String;
+   Data_Representation_Stamp : Ada.Strings.Unbounded.Unbounded_String;
+   --  Key of the target configuration for which data representation
+   --  information is generated, and file in which it is recorded once the
+   --  generation is complete. Gprbuild only regenerates the information of
+   --  units whose sources or switches changed, so the generation is forced
+   --  when the key differs from the recorded one.
+
+   procedure Append_Gprbuild_Args
+     (Project_File      : String;
+      DB_Dir            : String;
+      Translation_Phase : Gnatprove_Step;
+      Opt_File          : String;
+      Args              : in out String_Lists.List);
+   --  Append to Args the arguments of gprbuild which are common to all steps.
+   --  Opt_File is the file of extra options passed to gnat2why; it is not
+   --  used when generating data representation information.
+
    procedure Call_Gprbuild
      (Project_File      : String;
       Tree              : Project.Tree.Object;
@@ -105,8 +146,9 @@ procedure Call_Gprbuild
       Translation_Phase : Gnatprove_Step;
       Args              : in out String_Lists.List;
       Status            : out Integer);
-   --  Call gprbuild with the given arguments. DB_Dir is the directory
-   --  which contains the information to configure gprbuild correctly.
+   --  Call gprbuild with the given arguments for one of the steps which call
+   --  gnat2why. DB_Dir is the directory which contains the information to
+   --  configure gprbuild correctly.
 
    procedure Create_Dir_And_Parents (Dir : Virtual_File);
    --  Create the directory and necessary parent directories. Do nothing if the
@@ -117,9 +159,26 @@ procedure Compute_ALI_Information
      (Project_File : String; Tree : Project.Tree.Object; Status : out Integer);
    --  Compute ALI information for all source units, using gprbuild
 
-   procedure Compute_Data_Representation
-     (Project_File : String; Tree : Project.Tree.Object; Status : out Integer);
-   --  Compute data representation for all source units, using gprbuild
+   function Data_Representation_Key_Of
+     (Tree : Project.Tree.Object) return String;
+   --  Return the key of the target configuration which data representation
+   --  depends on: the version of the tool, the target, the runtime, and the
+   --  contents of the target configuration file passed by gnatprove if any.
+
+   procedure Start_Data_Representation
+     (Project_File : String; Tree : Project.Tree.Object);
+   --  Start computing data representation for all source units, using
+   --  gprbuild in the background, so that it runs concurrently with the
+   --  generation of ALI information. The output of gprbuild goes to the file
+   --  data_representation_generation.log in the artifact directory. Units
+   --  are only recompiled if they are out of date, or if the key of the
+   --  target configuration changed since the last generation.
+
+   procedure Wait_For_Data_Representation (Kill : Boolean);
+   --  Wait for the end of the generation of data representation information
+   --  started by Start_Data_Representation, if any. Kill it first if Kill is
+   --  True. A failure is reported but is not an error, as this step is
+   --  optional.
 
    procedure Execute_Step
      (Plan         : Plan_Type;
@@ -129,7 +188,16 @@ procedure Execute_Step
 
    procedure Copy_ALI_Files (Tree : Project.Tree.Object);
    --  To be called between phase 1 and phase2. Copies the ALI files from the
-   --  subdir of the first phase to the one for the second phase.
+   --  subdir of the first phase to the one for the second phase. Files which
+   --  were already copied by a previous run and not regenerated since are
+   --  skipped.
+
+   procedure Link_Generated_Globals (Tree : Project.Tree.Object);
+   --  To be called between phase 1 and phase 2, after Copy_ALI_Files. Links
+   --  the GG files of all units of the project into a single database, which
+   --  the gnat2why processes of phase 2 map into memory instead of each
+   --  decoding the GG files of its own closure. The entries are copied
+   --  as they are; resolving them is still done by each gnat2why process.
 
    procedure Generate_SPARK_Report
      (Tree : Project.Tree.Object; Errors : Boolean);
@@ -145,8 +213,34 @@ procedure Flow_Analysis_And_Proof
    function Spawn_VC_Server_And_Semaphore
      (Tree : Project.Tree.Object) return GNAT.OS_Lib.Process_Id;
    --  Spawn the VC server of Why3 and create the semaphore used for gnatwhy3
-   --  processes. Also set the environment variables used by the binaries that
-   --  access these resources.
+   --  processes, unless the proof scheduler is used. Also set the environment
+   --  variables used by the binaries that access these resources.
+
+   function Spawn_Cache_Broker return GNAT.OS_Lib.Process_Id;
+   --  Spawn the broker which shares persistent connections to the memcached
+   --  server between all spark_memcached_wrapper processes, and set the
+   --  environment variable used by the wrappers to reach it.
+
+   function Spawn_Proof_Scheduler return GNAT.OS_Lib.Process_Id;
+   --  Spawn the scheduler which decides when gnatwhy3 processes can run, and
+   --  set the environment variable used by spark_semaphore_wrapper to reach
+   --  it.
+
+   function Max_Gnatwhy3_Processes return Positive
+   is (if CL_Switches.Debug_Subp_Multi = 0
+       then Parallel
+       else CL_Switches.Debug_Subp_Multi);
+   --  Maximal number of gnatwhy3 processes running at the same time
+
+   function Data_Representation_Jobs return Positive
+   is (Positive'Max (1, Parallel / 2));
+   --  Number of jobs of the gprbuild call which generates data representation
+   --  information. It runs concurrently with the generation of ALI
+   --  information, which gets the rest of the jobs, so that both calls
+   --  together do not run more than Parallel compilations.
+
+   function Gprbuild_Jobs (Translation_Phase : Gnatprove_Step) return Positive;
+   --  Number of jobs passed to gprbuild with -j for the given step
 
    function Text_Of_Step (Step : Gnatprove_Step) return String;
 
@@ -156,9 +250,11 @@ procedure Set_Environment;
    --  GPR_PROJECT_PATH env vars.
 
    function Non_Blocking_Spawn
-     (Command : String; Arguments : String_Lists.List)
-      return GNAT.OS_Lib.Process_Id;
-   --  Spawn a process in a non-blocking way
+     (Command     : String;
+      Arguments   : String_Lists.List;
+      Output_Name : String := "") return GNAT.OS_Lib.Process_Id;
+   --  Spawn a process in a non-blocking way. If Output_Name is not empty, the
+   --  standard output and error of the process are redirected to this file.
 
    procedure Write_Why3_Conf_File (Obj_Dir : String);
    --  Write the Why3 conf file to process prover configuration
@@ -170,36 +266,21 @@ procedure Cleanup
    --  Cleanup procedure that is called at the end of every gnatprove
    --  execution. Delete temporary files.
 
-   -------------------
-   -- Call_Gprbuild --
-   -------------------
+   --------------------------
+   -- Append_Gprbuild_Args --
+   --------------------------
 
-   procedure Call_Gprbuild
+   procedure Append_Gprbuild_Args
      (Project_File      : String;
-      Tree              : Project.Tree.Object;
       DB_Dir            : String;
       Translation_Phase : Gnatprove_Step;
-      Args              : in out String_Lists.List;
-      Status            : out Integer)
+      Opt_File          : String;
+      Args              : in out String_Lists.List)
    is
       --  In the first step, gprbuild calls gcc to generate data representation
       --  information. In the second and third steps, it calls gnat2why.
       Call_Gnat2Why : constant Boolean :=
         Translation_Phase /= GS_Data_Representation;
-      Obj_Dir       : constant String := Artifact_Dir (Tree).Display_Full_Name;
-      Opt_File      : constant String :=
-        Gnat2Why_Opts.Writing.Pass_Extra_Options_To_Gnat2why
-          (Translation_Phase => Translation_Phase = GS_Gnat2Why,
-           Obj_Dir           => Obj_Dir);
-      Output_Name   : constant String :=
-        (if Call_Gnat2Why
-         then ""
-         else
-           Ada.Directories.Compose
-             (Configuration.Artifact_Dir (Tree).Display_Full_Name,
-              "data_representation_generation",
-              "log"));
-      Del_Succ      : Boolean;
 
    begin
       Args.Append ("--restricted-to-languages=ada");
@@ -227,7 +308,8 @@ procedure Call_Gprbuild
          Args.Append ("--no-exit-message");
       end if;
 
-      Args.Append ("-j" & Image (Parallel, Min_Width => 1));
+      Args.Append
+        ("-j" & Image (Gprbuild_Jobs (Translation_Phase), Min_Width => 1));
 
       if Continue_On_Error then
          Args.Append ("-k");
@@ -311,13 +393,37 @@ procedure Call_Gprbuild
          Args.Append ("-gnatis");  --  Suppress all info messages
 
       end if;
+   end Append_Gprbuild_Args;
+
+   -------------------
+   -- Call_Gprbuild --
+   -------------------
+
+   procedure Call_Gprbuild
+     (Project_File      : String;
+      Tree              : Project.Tree.Object;
+      DB_Dir            : String;
+      Translation_Phase : Gnatprove_Step;
+      Args              : in out String_Lists.List;
+      Status            : out Integer)
+   is
+      Obj_Dir  : constant String := Artifact_Dir (Tree).Display_Full_Name;
+      Opt_File : constant String :=
+        Gnat2Why_Opts.Writing.Pass_Extra_Options_To_Gnat2why
+          (Translation_Phase => Translation_Phase = GS_Gnat2Why,
+           Obj_Dir           => Obj_Dir,
+           Flow_Jobs         => (if Use_Flow_Workers then Parallel else 1));
+      Del_Succ : Boolean;
+
+   begin
+      Append_Gprbuild_Args
+        (Project_File, DB_Dir, Translation_Phase, Opt_File, Args);
 
       Call_With_Status
-        (Command     => "gprbuild",
-         Arguments   => Args,
-         Status      => Status,
-         Output_Name => Output_Name,
-         Verbose     => Verbose);
+        (Command   => "gprbuild",
+         Arguments => Args,
+         Status    => Status,
+         Verbose   => Verbose);
 
       if Status = 0 and then not Debug then
          GNAT.OS_Lib.Delete_File (Opt_File, Del_Succ);
@@ -384,62 +490,21 @@ procedure Compute_ALI_Information
          Status            => Status);
    end Compute_ALI_Information;
 
-   ---------------------------------
-   -- Compute_Data_Representation --
-   ---------------------------------
-
-   procedure Compute_Data_Representation
-     (Project_File : String; Tree : Project.Tree.Object; Status : out Integer)
-   is
-      Args : String_Lists.List;
-   begin
-      declare
-         Subd : constant Virtual_File :=
-           Phase2_Subdir / Data_Representation_Subdir;
-      begin
-         Args.Append ("--subdirs=" & Subd.Display_Full_Name);
-      end;
-      Args.Append ("--no-object-check");
-
-      --  Keep going after a compilation error in 'check' mode
-
-      if Configuration.Mode = GPM_Check then
-         Args.Append ("-k");
-      end if;
-
-      Call_Gprbuild
-        (Project_File,
-         Tree,
-         DB_Dir            => "",
-         Translation_Phase => GS_Data_Representation,
-         Args              => Args,
-         Status            => Status);
-
-      if Status /= 0 then
-         if not Quiet then
-            Ada.Text_IO.Put_Line
-              ("generation of data representation information failed");
-            Ada.Text_IO.Put_Line
-              ("continuing analysis with partial data representation");
-            Ada.Text_IO.Put_Line
-              ("for details, see log file "
-               & "gnatprove/data_representation_generation.log");
-         end if;
-
-         --  Ignore the status of data representation generation, as this is an
-         --  optional step in GNATprove.
-         Status := 0;
-      end if;
-   end Compute_Data_Representation;
-
    --------------------
    -- Copy_ALI_Files --
    --------------------
 
    procedure Copy_ALI_Files (Tree : Project.Tree.Object) is
 
+      function Clone_File_C
+        (Source, Target : Interfaces.C.char_array) return Interfaces.C.int
+      with Import, Convention => C, External_Name => "clone_file";
+      --  Create Target as a copy-on-write clone of Source, with the same
+      --  permissions and timestamps. Return 0 if cloning is not supported by
+      --  the file system or the OS, or if it fails.
+
       procedure Copy_Dir (Source_Dir, Target_Dir : Virtual_File);
-      --  Copy the ALI files from Source_Dir to Target_Dir
+      --  Copy the ALI and GG files from Source_Dir to Target_Dir
 
       procedure Copy_Phase1 (Target_Dir : Virtual_File);
       --  Copy the ALI files from Target_Dir/Phase1 to Target_Dir
@@ -454,6 +519,9 @@ procedure Copy_File
            (Directory_Entry : Ada.Directories.Directory_Entry_Type);
          --  copy the file in Argument to Target_Dir
 
+         procedure Copy_Files (Pattern : String);
+         --  Copy the files matching Pattern to Target_Dir
+
          ---------------
          -- Copy_File --
          ---------------
@@ -462,26 +530,75 @@ procedure Copy_File
            (Directory_Entry : Ada.Directories.Directory_Entry_Type)
          is
             use GNAT.OS_Lib;
+            use type Ada.Directories.File_Size;
+            use type Interfaces.C.int;
+
+            Source  : constant String :=
+              Ada.Directories.Full_Name (Directory_Entry);
+            Target  : constant String :=
+              Ada.Directories.Compose
+                (Target_Dir.Display_Full_Name,
+                 Ada.Directories.Simple_Name (Directory_Entry));
             Success : Boolean;
             pragma Warnings (Off, Success);  --  modified and then unused
 
          begin
-            Copy_File
-              (Ada.Directories.Full_Name (Directory_Entry),
-               Target_Dir.Display_Full_Name,
-               Success,
-               Mode     => Overwrite,
-               Preserve => Full);
+            --  Files are copied with their timestamps, so a target with the
+            --  same size and timestamp as its source is left over from a
+            --  previous run in which the source was not regenerated since.
+
+            if Is_Regular_File (Target)
+              and then Ada.Directories.Size (Source)
+                       = Ada.Directories.Size (Target)
+              and then File_Time_Stamp (Source) = File_Time_Stamp (Target)
+            then
+               return;
+            end if;
+
+            --  Clone the file when the file system supports it, so that its
+            --  contents are not copied. Hard links would be cheaper still,
+            --  but gnat2why rewrites the ALI files of phase 2 in place, which
+            --  would then corrupt those of phase 1.
+
+            Delete_File (Target, Success);
+
+            if Clone_File_C
+                 (Interfaces.C.To_C (Source), Interfaces.C.To_C (Target))
+              = 0
+            then
+               Copy_File
+                 (Source,
+                  Target_Dir.Display_Full_Name,
+                  Success,
+                  Mode     => Overwrite,
+                  Preserve => Full);
+            end if;
          end Copy_File;
 
-      begin
-         if Is_Directory (Source_Dir) then
+         ----------------
+         -- Copy_Files --
+         ----------------
+
+         procedure Copy_Files (Pattern : String) is
+         begin
             Ada.Directories.Search
               (Source_Dir.Display_Full_Name,
-               Pattern => "*.ali",
+               Pattern => Pattern,
                Filter  =>
                  [Ada.Directories.Ordinary_File => True, others => False],
                Process => Copy_File'Access);
+         end Copy_Files;
+
+         --  Start of processing for Copy_Dir
+
+      begin
+         if Is_Directory (Source_Dir) then
+            Copy_Files ("*.ali");
+
+            --  The generated globals of each unit are in a GG file next to
+            --  its ALI file.
+
+            Copy_Files ("*.gg");
          end if;
       end Copy_Dir;
 
@@ -550,6 +667,39 @@ procedure Create_Dir_And_Parents (Dir : Virtual_File) is
       Create_Directory_Or_Exit (Dir.Display_Full_Name);
    end Create_Dir_And_Parents;
 
+   --------------------------------
+   -- Data_Representation_Key_Of --
+   --------------------------------
+
+   function Data_Representation_Key_Of
+     (Tree : Project.Tree.Object) return String
+   is
+      Prefix : constant String := "-gnateT=";
+      Config : constant String :=
+        (if GnateT_Switch /= null
+           and then GnateT_Switch'Length > Prefix'Length
+           and then Starts_With (GnateT_Switch.all, Prefix)
+         then
+           GnateT_Switch
+             (GnateT_Switch'First + Prefix'Length .. GnateT_Switch'Last)
+         else "");
+      Digest : constant String :=
+        (if Config /= "" and then GNAT.OS_Lib.Is_Regular_File (Config)
+         then GNAT.SHA1.Digest (Read_File_Into_String (Config))
+         else "");
+   begin
+      return
+        SPARK2014_Static_Version_String
+        & ASCII.LF
+        & String (Tree.Target)
+        & ASCII.LF
+        & String (Tree.Runtime (Ada_Language))
+        & ASCII.LF
+        & Config
+        & ASCII.LF
+        & Digest;
+   end Data_Representation_Key_Of;
+
    ------------------
    -- Execute_Step --
    ------------------
@@ -579,20 +729,21 @@ procedure Execute_Step
             --  explicitly, as this prevents the compiler from outputting
             --  correct data representation information. Also skip this
             --  phase if proof is not called.
-            if Has_gnateT_Switch (Tree.Root_Project)
-              or else Configuration.Mode
-                      in GPM_Check | GPM_Check_All | GPM_Flow
+            if not Has_gnateT_Switch (Tree.Root_Project)
+              and then Configuration.Mode
+                       not in GPM_Check | GPM_Check_All | GPM_Flow
             then
-               Status := 0;
-            else
-               Compute_Data_Representation (Project_File, Tree, Status);
+               Start_Data_Representation (Project_File, Tree);
             end if;
+            Status := 0;
 
          when GS_ALI                 =>
             Compute_ALI_Information (Project_File, Tree, Status);
+            Wait_For_Data_Representation (Kill => Status /= 0);
 
          when GS_Gnat2Why            =>
             Copy_ALI_Files (Tree);
+            Link_Generated_Globals (Tree);
             Flow_Analysis_And_Proof (Project_File, Tree, Status);
       end case;
 
@@ -625,8 +776,10 @@ procedure Flow_Analysis_And_Proof
 
       declare
          use String_Lists;
-         Args : String_Lists.List;
-         Id   : GNAT.OS_Lib.Process_Id := GNAT.OS_Lib.Invalid_Pid;
+         Args      : String_Lists.List;
+         Id        : GNAT.OS_Lib.Process_Id := GNAT.OS_Lib.Invalid_Pid;
+         Broker_Id : GNAT.OS_Lib.Process_Id := GNAT.OS_Lib.Invalid_Pid;
+         Sched_Id  : GNAT.OS_Lib.Process_Id := GNAT.OS_Lib.Invalid_Pid;
       begin
          Args.Append ("--subdirs=" & Phase2_Subdir.Display_Full_Name);
 
@@ -647,6 +800,23 @@ procedure Flow_Analysis_And_Proof
 
          if Configuration.Mode in GPM_All | GPM_Prove then
             Id := Spawn_VC_Server_And_Semaphore (Tree);
+            if Use_Proof_Scheduler then
+               Sched_Id := Spawn_Proof_Scheduler;
+            end if;
+            if Use_Cache_Broker then
+               Broker_Id := Spawn_Cache_Broker;
+            end if;
+         end if;
+
+         --  The job slots for flow analysis workers are shared by all gnat2why
+         --  processes through a semaphore, as these processes do not know how
+         --  many others are running concurrently.
+
+         if Use_Flow_Workers then
+            Delete (Flow_Semaphore_Name);
+            Create (Flow_Semaphore_Name, Parallel, Flow_Semaphore);
+            Ada.Environment_Variables.Set
+              ("GNATPROVE_FLOW_SEMAPHORE", Flow_Semaphore_Name);
          end if;
 
          Call_Gprbuild
@@ -657,11 +827,35 @@ procedure Flow_Analysis_And_Proof
             Args              => Args,
             Status            => Status);
 
+         if Use_Flow_Workers then
+            Close (Flow_Semaphore);
+            Delete (Flow_Semaphore_Name);
+         end if;
+
          if Configuration.Mode in GPM_All | GPM_Prove then
             if Id /= GNAT.OS_Lib.Invalid_Pid then
                GNAT.OS_Lib.Kill_Process_Tree (Id, Hard_Kill => False);
             end if;
-            if Use_Semaphores then
+            if Broker_Id /= GNAT.OS_Lib.Invalid_Pid then
+               declare
+                  Unused : Boolean;
+               begin
+                  GNAT.OS_Lib.Kill_Process_Tree
+                    (Broker_Id, Hard_Kill => False);
+                  GNAT.OS_Lib.Delete_File
+                    (Cache_Broker_Socket_Name.all, Unused);
+               end;
+            end if;
+            if Sched_Id /= GNAT.OS_Lib.Invalid_Pid then
+               declare
+                  Unused : Boolean;
+               begin
+                  GNAT.OS_Lib.Kill_Process_Tree
+                    (Sched_Id, Hard_Kill => False);
+                  GNAT.OS_Lib.Delete_File (Scheduler_Socket_Name.all, Unused);
+               end;
+            end if;
+            if Use_Semaphores and then not Use_Proof_Scheduler then
                Close (Why3_Semaphore);
                Delete (Semaphore_Name);
             end if;
@@ -839,13 +1033,108 @@ procedure Generate_SPARK_Report
       end if;
    end Generate_SPARK_Report;
 
+   -------------------
+   -- Gprbuild_Jobs --
+   -------------------
+
+   function Gprbuild_Jobs (Translation_Phase : Gnatprove_Step) return Positive
+   is
+      use type GNAT.OS_Lib.Process_Id;
+   begin
+      case Translation_Phase is
+         when GS_Data_Representation =>
+            return Data_Representation_Jobs;
+
+         --  The generation of data representation information is started
+         --  before the generation of ALI information, and is still running
+         --  if it was started at all.
+
+         when GS_ALI                 =>
+            if Data_Representation_Process /= GNAT.OS_Lib.Invalid_Pid then
+               return Positive'Max (1, Parallel - Data_Representation_Jobs);
+            else
+               return Parallel;
+            end if;
+
+         when GS_Gnat2Why            =>
+            return Parallel;
+      end case;
+   end Gprbuild_Jobs;
+
+   ----------------------------
+   -- Link_Generated_Globals --
+   ----------------------------
+
+   procedure Link_Generated_Globals (Tree : Project.Tree.Object) is
+      GG_Files_Seen : String_Sets.Set;
+      GG_File_Names : String_Lists.List;
+   begin
+      --  Collect the GG files of the units of the project, next to the ALI
+      --  files copied to the object directories by Copy_ALI_Files. GG files
+      --  left over in these directories by units which are no longer part of
+      --  the project are not linked. The ALI file of a unit is named after
+      --  the source of its main part, i.e. its body if any.
+
+      for Cursor in
+        Tree.Iterate
+          (Status =>
+             [GPR2.Project.S_Externally_Built => GNATCOLL.Tribooleans.False])
+      loop
+         declare
+            View : constant Project.View.Object :=
+              Project.Tree.Element (Cursor);
+         begin
+            if View.Kind in With_Object_Dir_Kind then
+               declare
+                  Obj_Dir : constant String :=
+                    View.Object_Directory.Virtual_File.Display_Full_Name;
+                  Units   : constant GPR2.Build.Compilation_Unit.Maps.Map :=
+                    View.Own_Units;
+               begin
+                  for C in Units.Iterate loop
+                     declare
+                        Source   : constant String :=
+                          String (Units (C).Main_Part.Source.Simple_Name);
+                        GG_File  : constant String :=
+                          Ada.Directories.Compose
+                            (Obj_Dir,
+                             GG_Files.GG_File_Name
+                               (Ada.Directories.Base_Name (Source)
+                                & ".ali"));
+                        Position : String_Sets.Cursor;
+                        Inserted : Boolean;
+                     begin
+                        if GNAT.OS_Lib.Is_Regular_File (GG_File) then
+                           GG_Files_Seen.Insert (GG_File, Position, Inserted);
+
+                           if Inserted then
+                              GG_File_Names.Append (GG_File);
+                           end if;
+                        end if;
+                     end;
+                  end loop;
+               end;
+            end if;
+         end;
+      end loop;
+
+      GG_Files.Link
+        (GG_File_Names,
+         Database =>
+           Ada.Directories.Compose
+             (Artifact_Dir (Tree).Display_Full_Name,
+              GG_Files.GG_Database_File_Name),
+         Version  => SPARK2014_Static_Version_String);
+   end Link_Generated_Globals;
+
    ------------------------
    -- Non_Blocking_Spawn --
    ------------------------
 
    function Non_Blocking_Spawn
-     (Command : String; Arguments : String_Lists.List)
-      return GNAT.OS_Lib.Process_Id
+     (Command     : String;
+      Arguments   : String_Lists.List;
+      Output_Name : String := "") return GNAT.OS_Lib.Process_Id
    is
       Executable : GNAT.OS_Lib.String_Access :=
         GNAT.OS_Lib.Locate_Exec_On_Path (Command);
@@ -864,7 +1153,19 @@ function Non_Blocking_Spawn
          end loop;
          Ada.Text_IO.New_Line;
       end if;
-      Proc := GNAT.OS_Lib.Non_Blocking_Spawn (Executable.all, Args);
+      if Output_Name = "" then
+         Proc := GNAT.OS_Lib.Non_Blocking_Spawn (Executable.all, Args);
+      else
+         declare
+            Output_FD : constant GNAT.OS_Lib.File_Descriptor :=
+              GNAT.OS_Lib.Create_File (Output_Name, GNAT.OS_Lib.Text);
+         begin
+            Proc :=
+              GNAT.OS_Lib.Non_Blocking_Spawn
+                (Executable.all, Args, Output_FD, Err_To_Out => True);
+            GNAT.OS_Lib.Close (Output_FD);
+         end;
+      end if;
       Free (Args);
       Free (Executable);
       return Proc;
@@ -928,6 +1229,39 @@ procedure Set_Environment is
 
    end Set_Environment;
 
+   ------------------------
+   -- Spawn_Cache_Broker --
+   ------------------------
+
+   function Spawn_Cache_Broker return GNAT.OS_Lib.Process_Id is
+      Args : String_Lists.List;
+   begin
+      --  The broker keeps at most one connection to the server per parallel
+      --  process, as this is the maximal number of provers running at the
+      --  same time.
+
+      Args.Append (Cache_Broker_Socket_Name.all);
+      Args.Append (CL_Switches.Memcached_Server.all);
+      Args.Append (Image (Parallel, 1));
+      Ada.Environment_Variables.Set
+        ("GNATPROVE_CACHE_BROKER", Cache_Broker_Socket_Name.all);
+      return Non_Blocking_Spawn ("spark_memcached_broker", Args);
+   end Spawn_Cache_Broker;
+
+   ---------------------------
+   -- Spawn_Proof_Scheduler --
+   ---------------------------
+
+   function Spawn_Proof_Scheduler return GNAT.OS_Lib.Process_Id is
+      Args : String_Lists.List;
+   begin
+      Args.Append (Scheduler_Socket_Name.all);
+      Args.Append (Image (Max_Gnatwhy3_Processes, 1));
+      Ada.Environment_Variables.Set
+        ("GNATPROVE_SCHEDULER", Scheduler_Socket_Name.all);
+      return Non_Blocking_Spawn ("spark_proof_scheduler", Args);
+   end Spawn_Proof_Scheduler;
+
    ---------------------
    -- Spawn_VC_Server --
    ---------------------
@@ -957,21 +1291,79 @@ function Spawn_VC_Server_And_Semaphore
          Ada.Environment_Variables.Set
            ("GNATPROVE_SOCKET", CL_Switches.Why3_Server.all);
       end if;
-      if Use_Semaphores then
-         declare
-            Max_Proc : constant Integer :=
-              (if CL_Switches.Debug_Subp_Multi = 0
-               then Parallel
-               else CL_Switches.Debug_Subp_Multi);
-         begin
-            Delete (Semaphore_Name);
-            Create (Semaphore_Name, Max_Proc, Why3_Semaphore);
-         end;
+      --  When the proof scheduler is used, it replaces the semaphore
+
+      if Use_Semaphores and then not Use_Proof_Scheduler then
+         Delete (Semaphore_Name);
+         Create (Semaphore_Name, Max_Gnatwhy3_Processes, Why3_Semaphore);
          Ada.Environment_Variables.Set ("GNATPROVE_SEMAPHORE", Semaphore_Name);
       end if;
       return Id;
    end Spawn_VC_Server_And_Semaphore;
 
+   -------------------------------
+   -- Start_Data_Representation --
+   -------------------------------
+
+   procedure Start_Data_Representation
+     (Project_File : String; Tree : Project.Tree.Object)
+   is
+      Args        : String_Lists.List;
+      Output_Name : constant String :=
+        Ada.Directories.Compose
+          (Configuration.Artifact_Dir (Tree).Display_Full_Name,
+           "data_representation_generation",
+           "log");
+      Stamp       : constant String :=
+        Ada.Directories.Compose
+          (Configuration.Artifact_Dir (Tree).Display_Full_Name,
+           "data_representation",
+           "key");
+      Key         : constant String := Data_Representation_Key_Of (Tree);
+      Success     : Boolean;
+   begin
+      declare
+         Subd : constant Virtual_File :=
+           Phase2_Subdir / Data_Representation_Subdir;
+      begin
+         Args.Append ("--subdirs=" & Subd.Display_Full_Name);
+      end;
+      Args.Append ("--no-object-check");
+
+      --  Force the generation when the target configuration changed, or
+      --  when it is not known which configuration the information present
+      --  was generated for. The stamp is removed until the generation
+      --  completes, so that an interrupted generation is forced again.
+
+      if not GNAT.OS_Lib.Is_Regular_File (Stamp)
+        or else Read_File_Into_String (Stamp) /= Key
+      then
+         Args.Append ("-f");
+         GNAT.OS_Lib.Delete_File (Stamp, Success);
+      end if;
+
+      Data_Representation_Key :=
+        Ada.Strings.Unbounded.To_Unbounded_String (Key);
+      Data_Representation_Stamp :=
+        Ada.Strings.Unbounded.To_Unbounded_String (Stamp);
+
+      --  Keep going after a compilation error in 'check' mode
+
+      if Configuration.Mode = GPM_Check then
+         Args.Append ("-k");
+      end if;
+
+      Append_Gprbuild_Args
+        (Project_File,
+         DB_Dir            => "",
+         Translation_Phase => GS_Data_Representation,
+         Opt_File          => "",
+         Args              => Args);
+
+      Data_Representation_Process :=
+        Non_Blocking_Spawn ("gprbuild", Args, Output_Name);
+   end Start_Data_Representation;
+
    ------------------
    -- Text_Of_Step --
    ------------------
@@ -1008,6 +1400,69 @@ function Text_Of_Step (Step : Gnatprove_Step) return String is
       end case;
    end Text_Of_Step;
 
+   ----------------------------------
+   -- Wait_For_Data_Representation --
+   ----------------------------------
+
+   procedure Wait_For_Data_Representation (Kill : Boolean) is
+      use type GNAT.OS_Lib.Process_Id;
+
+      function Wait_Process (Pid : Interfaces.C.int) return Interfaces.C.int
+      with Import, Convention => C, External_Name => "wait_process";
+      --  Wait for the termination of the child process Pid, and return its
+      --  exit status, or -1 if it did not exit normally. Other children are
+      --  left alone, unlike with GNAT.OS_Lib.Wait_Process.
+
+      Success : Boolean;
+   begin
+      if Data_Representation_Process = GNAT.OS_Lib.Invalid_Pid then
+         return;
+      end if;
+
+      if Kill then
+         GNAT.OS_Lib.Kill_Process_Tree
+           (Data_Representation_Process, Hard_Kill => False);
+      end if;
+
+      Success :=
+        Integer
+          (Wait_Process
+             (Interfaces.C.int
+                (GNAT.OS_Lib.Pid_To_Integer (Data_Representation_Process))))
+        = 0;
+
+      Data_Representation_Process := GNAT.OS_Lib.Invalid_Pid;
+
+      --  Record the target configuration of the information generated,
+      --  unless the generation was interrupted. Units which failed to
+      --  compile are compiled again anyway by the next generation.
+
+      if not Kill then
+         declare
+            File : Ada.Text_IO.File_Type;
+         begin
+            Ada.Text_IO.Create
+              (File,
+               Ada.Text_IO.Out_File,
+               Ada.Strings.Unbounded.To_String (Data_Representation_Stamp));
+            Ada.Text_IO.Put
+              (File,
+               Ada.Strings.Unbounded.To_String (Data_Representation_Key));
+            Ada.Text_IO.Close (File);
+         end;
+      end if;
+
+      if not Success and then not Kill and then not Quiet then
+         Ada.Text_IO.Put_Line
+           ("generation of data representation information failed");
+         Ada.Text_IO.Put_Line
+           ("continuing analysis with partial data representation");
+         Ada.Text_IO.Put_Line
+           ("for details, see log file "
+            & "gnatprove/data_representation_generation.log");
+      end if;
+   end Wait_For_Data_Representation;
+
    --------------------------
    -- Write_Why3_Conf_File --
    --------------------------
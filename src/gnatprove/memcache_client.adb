@@ -24,9 +24,7 @@
 ------------------------------------------------------------------------------
 
 with Ada.Characters.Latin_1;
-with Ada.Streams;
-with Ada.Strings.Fixed;     use Ada.Strings.Fixed;
-with Ada.Strings.Unbounded; use Ada.Strings.Unbounded;
+with Ada.Strings.Fixed; use Ada.Strings.Fixed;
 
 package body Memcache_Client is
 
@@ -34,16 +32,42 @@ package body Memcache_Client is
 
    --  https://github.com/memcached/memcached/blob/master/doc/protocol.txt
 
+   --  Answers of the server are read line by line for the command replies and
+   --  value headers, while the data of a value is read according to the
+   --  length given in its header. This avoids scanning the data for an end
+   --  marker, and allows reading large values without intermediate copies.
+
    CRLF : constant String :=
      Ada.Characters.Latin_1.CR & Ada.Characters.Latin_1.LF;
 
-   function Read_Stop_When_End_Marker
-     (Conn : Cache_Connection; End_Marker : String) return String;
-   --  @param Conn the connection from which to read
-   --  @param End_Marker when the read text ends with this marker, stop
-   --    reading. Reading will *not* stop if the end marker appears somewhere
-   --    inside a message. But this shouldn't happen in regular connections.
-   --  @return the read text
+   function Connect (Sock : Socket_Type) return Cache_Connection;
+   --  @param Sock a socket connected to a server
+   --  @return a connection object reading and writing through Sock
+
+   procedure Parse_Value_Header
+     (Header : String; Key_First, Key_Last : out Natural; Bytes : out Natural);
+   --  @param Header a line "VALUE <key> <flags> <bytes> [<cas unique>]"
+   --    received from the server
+   --  @param Key_First, Key_Last set to the bounds of <key> in Header
+   --  @param Bytes set to the length of the data following Header
+   --  Raise Protocol_Error if Header is ill-formed.
+
+   procedure Skip_Data_Terminator (Conn : Cache_Connection);
+   --  Read the CRLF following the data of a value
+
+   -------------
+   -- Connect --
+   -------------
+
+   function Connect (Sock : Socket_Type) return Cache_Connection is
+      Result : Cache_Connection;
+   begin
+      Result.Sock := Sock;
+      Result.Stream := Stream (Sock);
+      Result.Reader := new Socket_Reader;
+      Attach (Result.Reader.all, Sock);
+      return Result;
+   end Connect;
 
    ----------
    -- Init --
@@ -52,49 +76,102 @@ function Read_Stop_When_End_Marker
    function Init (Hostname : String; Port : Port_Type) return Cache_Connection
    is
       Host   : constant Host_Entry_Type := Get_Host_By_Name (Hostname);
-      Result : Cache_Connection;
+      Sock   : Socket_Type;
       Status : Boolean;
    begin
-      Create_Socket (Result.Sock);
+      Create_Socket (Sock);
 
       --  Make socket available only to wrapper, not to the wrapped executable
       Set_Close_On_Exec
-        (Socket => Result.Sock, Close_On_Exec => True, Status => Status);
+        (Socket => Sock, Close_On_Exec => True, Status => Status);
 
       pragma Assert (Status);
 
       Connect_Socket
-        (Result.Sock,
+        (Sock,
          (Family => Family_Inet, Addr => Addresses (Host), Port => Port));
-      Result.Stream := Stream (Result.Sock);
-      return Result;
+      return Connect (Sock);
    end Init;
 
-   -------------------------------
-   -- Read_Stop_When_End_Marker --
-   -------------------------------
+   ----------------
+   -- Init_Local --
+   ----------------
+
+   function Init_Local (Socket_Name : String) return Cache_Connection is
+      Sock   : Socket_Type;
+      Status : Boolean;
+   begin
+      Create_Socket (Sock, Family_Unix);
+
+      --  Make socket available only to wrapper, not to the wrapped executable
+      Set_Close_On_Exec
+        (Socket => Sock, Close_On_Exec => True, Status => Status);
+
+      pragma Assert (Status);
+
+      begin
+         Connect_Socket (Sock, Unix_Socket_Address (Socket_Name));
+      exception
+         when Socket_Error =>
+            Close_Socket (Sock);
+            raise;
+      end;
+      return Connect (Sock);
+   end Init_Local;
+
+   ------------------------
+   -- Parse_Value_Header --
+   ------------------------
 
-   function Read_Stop_When_End_Marker
-     (Conn : Cache_Connection; End_Marker : String) return String
+   procedure Parse_Value_Header
+     (Header : String; Key_First, Key_Last : out Natural; Bytes : out Natural)
    is
-      Buf    : Ada.Streams.Stream_Element_Array (1 .. 1024);
-      Result : Unbounded_String := Null_Unbounded_String;
-      Last   : Ada.Streams.Stream_Element_Offset;
+      Key_End   : Natural;
+      Flags_End : Natural;
+      Bytes_End : Natural;
+      --  Positions of the spaces following the key, flags and length fields
    begin
-      loop
-         Receive_Socket (Conn.Sock, Buf, Last);
-         declare
-            Read_Str : String (Integer (Buf'First) .. Integer (Last));
-         begin
-            for I in Buf'First .. Last loop
-               Read_Str (Integer (I)) := Character'Val (Buf (I));
-            end loop;
-            Append (Result, Read_Str);
-            exit when Tail (Result, End_Marker'Length) = End_Marker;
-         end;
-      end loop;
-      return To_String (Result);
-   end Read_Stop_When_End_Marker;
+      if Head (Header, 6) /= "VALUE " then
+         raise Protocol_Error;
+      end if;
+
+      Key_First := Header'First + 6;
+      Key_End := Index (Header (Key_First .. Header'Last), " ");
+      if Key_End <= Key_First then
+         raise Protocol_Error;
+      end if;
+      Key_Last := Key_End - 1;
+
+      Flags_End := Index (Header (Key_End + 1 .. Header'Last), " ");
+      if Flags_End = 0 then
+         raise Protocol_Error;
+      end if;
+
+      --  The length may be followed by the optional cas unique value
+
+      Bytes_End := Index (Header (Flags_End + 1 .. Header'Last), " ");
+      if Bytes_End = 0 then
+         Bytes_End := Header'Last + 1;
+      end if;
+
+      Bytes := Natural'Value (Header (Flags_End + 1 .. Bytes_End - 1));
+   exception
+      when Constraint_Error =>
+         raise Protocol_Error;
+   end Parse_Value_Header;
+
+   --------------------------
+   -- Skip_Data_Terminator --
+   --------------------------
+
+   procedure Skip_Data_Terminator (Conn : Cache_Connection) is
+      Terminator : String (1 .. 2);
+   begin
+      Read_Exact (Conn.Reader.all, Terminator);
+      if Terminator /= CRLF then
+         raise Protocol_Error;
+      end if;
+   end Skip_Data_Terminator;
 
    ---------
    -- Set --
@@ -117,24 +194,22 @@ procedure Set (Conn : Cache_Connection; Key : String; Value : String) is
       String'Write (Conn.Stream, CRLF);
 
       declare
-         Answer : constant String := Read_Stop_When_End_Marker (Conn, CRLF);
+         Answer : constant String := Read_Line (Conn.Reader.all);
 
       begin
          --  We expect the key-value pair to be stored
 
-         if Answer = "STORED" & CRLF then
+         if Answer = "STORED" then
             null;
 
          --  Silenlty ignore server-side errors, e.g. when the value object is
          --  too large. ??? ideally such errors should be propagated to users
 
-         elsif Head (Answer, 13) = "SERVER_ERROR "
-           and then Tail (Answer, 2) = CRLF
-         then
+         elsif Head (Answer, 13) = "SERVER_ERROR " then
             null;
 
          else
-            raise Program_Error;
+            raise Protocol_Error;
          end if;
       end;
    end Set;
@@ -146,16 +221,29 @@ procedure Set (Conn : Cache_Connection; Key : String; Value : String) is
    function Get (Conn : Cache_Connection; Key : String) return String is
    begin
       String'Write (Conn.Stream, "get " & Key & CRLF);
+
       declare
-         Answer : constant String :=
-           Read_Stop_When_End_Marker (Conn, "END" & CRLF);
-         Start  : constant Integer := Ada.Strings.Fixed.Index (Answer, CRLF);
+         Header       : constant String := Read_Line (Conn.Reader.all);
+         Unused_First : Natural;
+         Unused_Last  : Natural;
+         Bytes        : Natural;
       begin
-         --  We remove the first line from the output, as well as the last
-         --  line containing the END marker, and also the previous CRLF line
-         --  separator. The result may be empty.
+         if Header = "END" then
+            return "";
+         end if;
+
+         Parse_Value_Header (Header, Unused_First, Unused_Last, Bytes);
+
+         --  The data is read directly into the result, whose size is known
+         --  from the header.
 
-         return Answer (Start + 2 .. Answer'Last - 7);
+         return Result : String (1 .. Bytes) do
+            Read_Exact (Conn.Reader.all, Result);
+            Skip_Data_Terminator (Conn);
+            if Read_Line (Conn.Reader.all) /= "END" then
+               raise Protocol_Error;
+            end if;
+         end return;
       end;
    end Get;
 
@@ -166,6 +254,7 @@ function Get (Conn : Cache_Connection; Key : String) return String is
    procedure Close (Conn : in out Cache_Connection) is
    begin
       Free (Conn.Stream);
+      Free (Conn.Reader);
       Close_Socket (Conn.Sock);
    end Close;
 
@@ -0,0 +1,92 @@
+------------------------------------------------------------------------------
+--                                                                          --
+--                            GNATPROVE COMPONENTS                          --
+--                                                                          --
+--                  P R O O F _ C A C H E . C L I E N T S                   --
+--                                                                          --
+--                                 B o d y                                  --
+--                                                                          --
+--                       Copyright (C) 2025, AdaCore                        --
+--                                                                          --
+-- gnatprove is  free  software;  you can redistribute it and/or  modify it --
+-- under terms of the  GNU General Public License as published  by the Free --
+-- Software  Foundation;  either version 3,  or (at your option)  any later --
+-- version.  gnatprove is distributed  in the hope that  it will be useful, --
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- --
+-- TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public --
+-- License for  more details.  You should have  received  a copy of the GNU --
+-- General Public License  distributed with  gnatprove;  see file COPYING3. --
+-- If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the --
+-- license.                                                                 --
+--                                                                          --
+-- gnatprove is maintained by AdaCore (http://www.adacore.com)              --
+--                                                                          --
+------------------------------------------------------------------------------
+
+with Ada.Environment_Variables;
+with Filecache_Client;
+with GNAT.Sockets;        use GNAT.Sockets;
+with Memcache_Client;
+with Tiered_Cache_Client;
+
+package body Proof_Cache.Clients is
+
+   -----------------
+   -- Init_Client --
+   -----------------
+
+   function Init_Client (Info : String) return Cache'Class is
+      Specs   : constant Cache_Spec_Vectors.Vector := Parse_Cache_Specs (Info);
+      Local   : Tiered_Cache_Client.Cache_Access;
+      Servers : Tiered_Cache_Client.Server_Vectors.Vector;
+
+   begin
+      if Natural (Specs.Length) = 1 then
+         declare
+            Spec : constant Cache_Spec := Specs.First_Element;
+         begin
+            if Spec.Is_File then
+               return Filecache_Client.Init (To_String (Spec.Name));
+            end if;
+
+            declare
+               Broker : constant String :=
+                 Ada.Environment_Variables.Value
+                   ("GNATPROVE_CACHE_BROKER", "");
+            begin
+               if Broker /= "" then
+                  return Memcache_Client.Init_Local (Broker);
+               end if;
+            exception
+
+               --  The broker may not be ready yet, connect directly to the
+               --  server in that case.
+
+               when Socket_Error =>
+                  null;
+            end;
+
+            return
+              Memcache_Client.Init
+                (To_String (Spec.Name), Port_Type (Spec.Port));
+         end;
+      end if;
+
+      --  A list of caches is given, use the file cache (if any) in front of
+      --  the memcached servers.
+
+      for Spec of Specs loop
+         if Spec.Is_File then
+            Local :=
+              new Filecache_Client.Filecache'
+                (Filecache_Client.Init (To_String (Spec.Name)));
+         else
+            Servers.Append
+              ((Hostname => Spec.Name, Port => Port_Type (Spec.Port)));
+         end if;
+      end loop;
+
+      return Tiered_Cache_Client.Init (Local, Servers);
+   end Init_Client;
+
+end Proof_Cache.Clients;
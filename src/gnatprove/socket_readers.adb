@@ -0,0 +1,153 @@
+------------------------------------------------------------------------------
+--                                                                          --
+--                            GNATPROVE COMPONENTS                          --
+--                                                                          --
+--                       S O C K E T _ R E A D E R S                        --
+--                                                                          --
+--                                 B o d y                                  --
+--                                                                          --
+--                       Copyright (C) 2025, AdaCore                        --
+--                                                                          --
+-- gnatprove is  free  software;  you can redistribute it and/or  modify it --
+-- under terms of the  GNU General Public License as published  by the Free --
+-- Software  Foundation;  either version 3,  or (at your option)  any later --
+-- version.  gnatprove is distributed  in the hope that  it will be useful, --
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- --
+-- TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public --
+-- License for  more details.  You should have  received  a copy of the GNU --
+-- General Public License  distributed with  gnatprove;  see file COPYING3. --
+-- If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the --
+-- license.                                                                 --
+--                                                                          --
+-- gnatprove is maintained by AdaCore (http://www.adacore.com)              --
+--                                                                          --
+------------------------------------------------------------------------------
+
+with Ada.Characters.Latin_1;
+with Ada.Strings.Unbounded; use Ada.Strings.Unbounded;
+with Ada.Unchecked_Deallocation;
+
+package body Socket_Readers is
+
+   LF : constant Stream_Element :=
+     Character'Pos (Ada.Characters.Latin_1.LF);
+   CR : constant Character := Ada.Characters.Latin_1.CR;
+
+   procedure Fill (R : in out Socket_Reader)
+   with Pre => R.First > R.Last;
+   --  Receive more data in the buffer of R, which should be fully consumed.
+   --  Raise Connection_Closed if the peer has closed the connection.
+
+   function To_String (Data : Stream_Element_Array) return String;
+   --  Return the characters corresponding to the elements of Data
+
+   ------------
+   -- Attach --
+   ------------
+
+   procedure Attach (R : in out Socket_Reader; Sock : Socket_Type) is
+   begin
+      R.Sock := Sock;
+      R.First := R.Buf'First;
+      R.Last := R.Buf'First - 1;
+   end Attach;
+
+   ----------
+   -- Fill --
+   ----------
+
+   procedure Fill (R : in out Socket_Reader) is
+   begin
+      Receive_Socket (R.Sock, R.Buf, R.Last);
+      if R.Last < R.Buf'First then
+         raise Connection_Closed;
+      end if;
+      R.First := R.Buf'First;
+   end Fill;
+
+   ----------
+   -- Free --
+   ----------
+
+   procedure Free (R : in out Socket_Reader_Access) is
+      procedure Deallocate is new
+        Ada.Unchecked_Deallocation (Socket_Reader, Socket_Reader_Access);
+   begin
+      Deallocate (R);
+   end Free;
+
+   ----------------
+   -- Read_Exact --
+   ----------------
+
+   procedure Read_Exact (R : in out Socket_Reader; Item : out String) is
+      Next : Natural := Item'First;
+      --  Index of the next character of Item to be filled
+   begin
+      while Next <= Item'Last loop
+         if R.First > R.Last then
+            Fill (R);
+         end if;
+         declare
+            Count : constant Natural :=
+              Natural'Min
+                (Natural (R.Last - R.First + 1), Item'Last - Next + 1);
+            Chunk : constant Stream_Element_Offset :=
+              R.First + Stream_Element_Offset (Count) - 1;
+         begin
+            Item (Next .. Next + Count - 1) :=
+              To_String (R.Buf (R.First .. Chunk));
+            Next := Next + Count;
+            R.First := Chunk + 1;
+         end;
+      end loop;
+   end Read_Exact;
+
+   ---------------
+   -- Read_Line --
+   ---------------
+
+   function Read_Line (R : in out Socket_Reader) return String is
+      Line : Unbounded_String;
+      Stop : Stream_Element_Offset;
+   begin
+      loop
+         if R.First > R.Last then
+            Fill (R);
+         end if;
+
+         Stop := R.First;
+         while Stop <= R.Last and then R.Buf (Stop) /= LF loop
+            Stop := Stop + 1;
+         end loop;
+
+         Append (Line, To_String (R.Buf (R.First .. Stop - 1)));
+
+         if Stop <= R.Last then
+            R.First := Stop + 1;
+            exit;
+         else
+            R.First := Stop;
+         end if;
+      end loop;
+
+      if Length (Line) > 0 and then Element (Line, Length (Line)) = CR then
+         return Slice (Line, 1, Length (Line) - 1);
+      else
+         return To_String (Line);
+      end if;
+   end Read_Line;
+
+   ---------------
+   -- To_String --
+   ---------------
+
+   function To_String (Data : Stream_Element_Array) return String is
+      Result : constant String (1 .. Data'Length)
+      with Import, Address => Data'Address;
+      --  A fake string directly mapped onto the data
+   begin
+      return Result;
+   end To_String;
+
+end Socket_Readers;
@@ -0,0 +1,161 @@
+------------------------------------------------------------------------------
+--                                                                          --
+--                            GNATPROVE COMPONENTS                          --
+--                           S P A R K _ C A C H E                          --
+--                                                                          --
+--                                 B o d y                                  --
+--                                                                          --
+--                       Copyright (C) 2025, AdaCore                        --
+--                                                                          --
+-- gnatprove is  free  software;  you can redistribute it and/or  modify it --
+-- under terms of the  GNU General Public License as published  by the Free --
+-- Software  Foundation;  either version 3,  or (at your option)  any later --
+-- version.  gnatprove is distributed  in the hope that  it will be useful, --
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- --
+-- TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public --
+-- License for  more details.  You should have  received  a copy of the GNU --
+-- General Public License  distributed with  gnatprove;  see file COPYING3. --
+-- If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the --
+-- license.                                                                 --
+--                                                                          --
+-- gnatprove is maintained by AdaCore (http://www.adacore.com)              --
+--                                                                          --
+------------------------------------------------------------------------------
+
+with Ada.Calendar;
+with Ada.Command_Line;  use Ada.Command_Line;
+with Ada.Directories;   use Ada.Directories;
+with Ada.Text_IO;       use Ada.Text_IO;
+with Filecache_Client;  use Filecache_Client;
+with GNAT.OS_Lib;
+with GNATCOLL.Utils;    use GNATCOLL.Utils;
+
+procedure SPARK_Cache is
+
+   --  This program maintains a file cache used by gnatprove with switch
+   --  --memcached-server=file:<directory>.
+
+   --  Invocation:
+   --  spark_cache stats <directory>
+   --  spark_cache gc <directory> [--max-size=<MB>] [--max-age=<days>]
+
+   --  The stats command prints the number of entries and total size of the
+   --  cache. The gc command removes the least recently used entries of the
+   --  cache until it is smaller than the given size, and removes all the
+   --  entries that were not used during the given number of days.
+
+   use type Ada.Calendar.Time;
+
+   Usage : constant String :=
+     "usage: spark_cache stats <directory>"
+     & ASCII.LF
+     & "       spark_cache gc <directory> [--max-size=<MB>] "
+     & "[--max-age=<days>]";
+
+   Megabyte : constant := 1024 * 1024;
+   Day      : constant := 86_400.0;
+
+   procedure Report_Error (Msg : String)
+   with No_Return;
+   --  @param Msg error message to be reported
+   --  Quit the program with an error message
+
+   function Value_Of (Switch : String; Prefix : String) return Natural;
+   --  @param Switch a switch of the form <Prefix><number>
+   --  @return the number in Switch
+
+   function Image (Stats : Cache_Stats) return String
+   is (Image (Stats.Entries, 1)
+       & " entries,"
+       & File_Size'Image (Stats.Size / Megabyte)
+       & " MB");
+
+   ------------------
+   -- Report_Error --
+   ------------------
+
+   procedure Report_Error (Msg : String) is
+   begin
+      Put_Line (Standard_Error, "spark_cache: " & Msg);
+      Put_Line (Standard_Error, Usage);
+      GNAT.OS_Lib.OS_Exit (1);
+   end Report_Error;
+
+   --------------
+   -- Value_Of --
+   --------------
+
+   function Value_Of (Switch : String; Prefix : String) return Natural is
+   begin
+      return
+        Natural'Value (Switch (Switch'First + Prefix'Length .. Switch'Last));
+   exception
+      when Constraint_Error =>
+         Report_Error ("invalid value for " & Prefix);
+   end Value_Of;
+
+   --  Start of processing for SPARK_Cache
+
+begin
+   if Argument_Count < 2 then
+      Report_Error ("not enough arguments");
+   end if;
+
+   declare
+      Command : String renames Argument (1);
+      Dir     : String renames Argument (2);
+   begin
+      if not Exists (Dir) or else Kind (Dir) /= Directory then
+         Report_Error ("no such directory: " & Dir);
+      end if;
+
+      if Command = "stats" and then Argument_Count = 2 then
+         declare
+            Stats : constant Cache_Stats := Get_Stats (Dir);
+         begin
+            Put_Line (Image (Stats));
+            if Stats.Entries > 0 then
+               Put_Line
+                 ("least recently used entry:"
+                  & Natural'Image
+                      (Natural ((Ada.Calendar.Clock - Stats.Oldest) / Day))
+                  & " days ago");
+            end if;
+         end;
+
+      elsif Command = "gc" then
+         declare
+            Max_Size : File_Size := 0;
+            Max_Age  : Duration := 0.0;
+            Removed  : Cache_Stats;
+         begin
+            for J in 3 .. Argument_Count loop
+               declare
+                  Switch : String renames Argument (J);
+               begin
+                  if Starts_With (Switch, "--max-size=") then
+                     Max_Size :=
+                       File_Size (Value_Of (Switch, "--max-size=")) * Megabyte;
+                  elsif Starts_With (Switch, "--max-age=") then
+                     Max_Age :=
+                       Duration (Value_Of (Switch, "--max-age=")) * Day;
+                  else
+                     Report_Error ("unknown switch: " & Switch);
+                  end if;
+               end;
+            end loop;
+
+            if Max_Size = 0 and then Max_Age = 0.0 then
+               Report_Error ("gc requires --max-size or --max-age");
+            end if;
+
+            Collect_Garbage (Dir, Max_Size, Max_Age, Removed);
+            Put_Line ("removed " & Image (Removed));
+            Put_Line ("remaining " & Image (Get_Stats (Dir)));
+         end;
+
+      else
+         Report_Error ("unknown command: " & Command);
+      end if;
+   end;
+end SPARK_Cache;
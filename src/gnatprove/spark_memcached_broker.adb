@@ -0,0 +1,496 @@
+------------------------------------------------------------------------------
+--                                                                          --
+--                            GNATPROVE COMPONENTS                          --
+--                                                                          --
+--               S P A R K _ M E M C A C H E D _ B R O K E R                --
+--                                                                          --
+--                                 B o d y                                  --
+--                                                                          --
+--                       Copyright (C) 2025, AdaCore                        --
+--                                                                          --
+-- gnatprove is  free  software;  you can redistribute it and/or  modify it --
+-- under terms of the  GNU General Public License as published  by the Free --
+-- Software  Foundation;  either version 3,  or (at your option)  any later --
+-- version.  gnatprove is distributed  in the hope that  it will be useful, --
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- --
+-- TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public --
+-- License for  more details.  You should have  received  a copy of the GNU --
+-- General Public License  distributed with  gnatprove;  see file COPYING3. --
+-- If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the --
+-- license.                                                                 --
+--                                                                          --
+-- gnatprove is maintained by AdaCore (http://www.adacore.com)              --
+--                                                                          --
+------------------------------------------------------------------------------
+
+with Ada.Characters.Latin_1;
+with Ada.Command_Line;  use Ada.Command_Line;
+with Ada.Exceptions;
+with Ada.Strings.Fixed;
+with Ada.Text_IO;
+with GNAT.OS_Lib;       use GNAT.OS_Lib;
+with GNAT.Sockets;      use GNAT.Sockets;
+with Memcache_Client;   use Memcache_Client;
+with Socket_Readers;    use Socket_Readers;
+with String_Utils;      use String_Utils;
+
+procedure SPARK_Memcached_Broker is
+
+   --  This program is spawned once by gnatprove when a memcached server is
+   --  used to cache proof results. It listens on a local socket and forwards
+   --  the requests of all spark_memcached_wrapper processes to the memcached
+   --  server, through a pool of persistent connections. This saves the setup
+   --  and teardown of a connection to the (possibly remote) server for each
+   --  invocation of the wrapper.
+
+   --  Invocation:
+   --  spark_memcached_broker socketname hostname:port poolsize
+
+   --  The broker only understands the subset of the memcached text protocol
+   --  that is used by Memcache_Client, that is the get, set and quit
+   --  commands. It runs until it is killed by gnatprove.
+
+   CRLF : constant String :=
+     Ada.Characters.Latin_1.CR & Ada.Characters.Latin_1.LF;
+
+   Max_Pending_Clients : constant := 256;
+   --  Maximal number of accepted client connections waiting for a worker
+
+   procedure Report_Error (Msg : String)
+   with No_Return;
+   --  @param Msg error message to be reported
+   --  Quit the program with an error message
+
+   --  The arguments are always provided by gnatprove, so they are not
+   --  validated here.
+
+   Socket_Name : String renames Argument (1);
+   Server      : String renames Argument (2);
+   Colon       : constant Natural :=
+     Ada.Strings.Fixed.Index (Server, ":", Going => Ada.Strings.Backward);
+   Hostname    : String renames Server (Server'First .. Colon - 1);
+   Port        : constant Port_Type :=
+     Port_Type'Value (Server (Colon + 1 .. Server'Last));
+   Pool_Size   : constant Positive := Positive'Value (Argument (3));
+
+   type Slot_Flags is array (Positive range <>) of Boolean;
+
+   type Connection_Array is array (Positive range <>) of Cache_Connection;
+
+   type Socket_Array is array (Positive range <>) of Socket_Type;
+
+   Connections : Connection_Array (1 .. Pool_Size);
+   --  Pool of connections to the memcached server. A connection is only used
+   --  by the worker which acquired the corresponding slot from Pool.
+
+   Connected : Slot_Flags (1 .. Pool_Size) := [others => False];
+   --  Connections are only opened when first needed, and are reopened after
+   --  a communication error with the server.
+
+   protected Pool is
+      entry Acquire (Slot : out Positive);
+      --  Wait for a slot of the pool to be available and reserve it
+
+      procedure Release (Slot : Positive);
+      --  Make a slot available again
+
+   private
+      Busy      : Slot_Flags (1 .. Pool_Size) := [others => False];
+      Available : Natural := Pool_Size;
+   end Pool;
+
+   protected Pending_Clients is
+      entry Put (Sock : Socket_Type);
+      --  Add a newly accepted client connection
+
+      entry Take (Sock : out Socket_Type);
+      --  Retrieve the oldest client connection waiting for a worker
+
+   private
+      Queue : Socket_Array (1 .. Max_Pending_Clients);
+      First : Positive := 1;
+      Count : Natural := 0;
+   end Pending_Clients;
+
+   task type Worker;
+   --  Workers serve client connections one at a time, until the client closes
+   --  the connection.
+
+   procedure Disconnect (Slot : Positive);
+   --  Close the connection of Slot, ignoring errors
+
+   function Nth (Words : String_Lists.List; N : Positive) return String;
+   --  Return the N-th element of Words
+
+   procedure Serve_Client (Sock : Socket_Type);
+   --  Answer requests received on Sock until the client closes the
+   --  connection.
+
+   function Split (Line : String) return String_Lists.List;
+   --  Return the words of Line, separated by spaces
+
+   procedure With_Connection
+     (Process : not null access procedure (Conn : Cache_Connection));
+   --  Call Process on an open connection of the pool, which is reserved for
+   --  the duration of the call. If the communication with the server fails,
+   --  the connection is closed and the exception is propagated.
+
+   ----------
+   -- Pool --
+   ----------
+
+   protected body Pool is
+
+      entry Acquire (Slot : out Positive) when Available > 0 is
+      begin
+         Slot := Busy'First;
+         while Busy (Slot) loop
+            Slot := Slot + 1;
+         end loop;
+         Busy (Slot) := True;
+         Available := Available - 1;
+      end Acquire;
+
+      procedure Release (Slot : Positive) is
+      begin
+         Busy (Slot) := False;
+         Available := Available + 1;
+      end Release;
+
+   end Pool;
+
+   ---------------------
+   -- Pending_Clients --
+   ---------------------
+
+   protected body Pending_Clients is
+
+      entry Put (Sock : Socket_Type) when Count < Queue'Length is
+      begin
+         Queue ((First + Count - 1) mod Queue'Length + 1) := Sock;
+         Count := Count + 1;
+      end Put;
+
+      entry Take (Sock : out Socket_Type) when Count > 0 is
+      begin
+         Sock := Queue (First);
+         First := First mod Queue'Length + 1;
+         Count := Count - 1;
+      end Take;
+
+   end Pending_Clients;
+
+   ----------------
+   -- Disconnect --
+   ----------------
+
+   procedure Disconnect (Slot : Positive) is
+   begin
+      if Connected (Slot) then
+         Connected (Slot) := False;
+         Connections (Slot).Close;
+      end if;
+   exception
+      when Socket_Error =>
+         null;
+   end Disconnect;
+
+   ---------
+   -- Nth --
+   ---------
+
+   function Nth (Words : String_Lists.List; N : Positive) return String is
+      C : String_Lists.Cursor := Words.First;
+   begin
+      for J in 2 .. N loop
+         String_Lists.Next (C);
+      end loop;
+      return String_Lists.Element (C);
+   end Nth;
+
+   ------------------
+   -- Report_Error --
+   ------------------
+
+   procedure Report_Error (Msg : String) is
+   begin
+      Ada.Text_IO.Put_Line
+        (Ada.Text_IO.Standard_Error, "spark_memcached_broker: " & Msg);
+      OS_Exit (1);
+   end Report_Error;
+
+   ------------------
+   -- Serve_Client --
+   ------------------
+
+   procedure Serve_Client (Sock : Socket_Type) is
+      Reader  : Socket_Reader;
+      Channel : Stream_Access := Stream (Sock);
+
+      procedure Handle_Get (Keys : String_Lists.List);
+      --  Answer a get command for Keys, using a single connection to the
+      --  server
+
+      procedure Handle_Set (Words : String_Lists.List);
+      --  Answer a set command, whose command line is split in Words
+
+      ----------------
+      -- Handle_Get --
+      ----------------
+
+      procedure Handle_Get (Keys : String_Lists.List) is
+         Values : String_Lists.List;
+         --  The values of Keys, in the same order, the empty string standing
+         --  for a key that is not set.
+
+         procedure Get_Values (Conn : Cache_Connection);
+
+         ----------------
+         -- Get_Values --
+         ----------------
+
+         procedure Get_Values (Conn : Cache_Connection) is
+         begin
+            --  The keys are requested from the server one at a time, waiting
+            --  for each answer before sending the next request: requests are
+            --  neither pipelined nor grouped into a single multi-key get.
+
+            for Key of Keys loop
+               Values.Append (Conn.Get (Key));
+            end loop;
+         end Get_Values;
+
+         Value : String_Lists.Cursor;
+
+      begin
+         --  A failure to reach the server is reported as a cache miss, as is
+         --  done by memcached clients in general.
+
+         begin
+            With_Connection (Get_Values'Access);
+         exception
+            when
+              Socket_Error | Host_Error | Protocol_Error | Connection_Closed
+            =>
+               Values.Clear;
+         end;
+
+         Value := Values.First;
+         for Key of Keys loop
+            exit when not String_Lists.Has_Element (Value);
+
+            declare
+               Data : constant String := String_Lists.Element (Value);
+            begin
+               if Data /= "" then
+                  String'Write
+                    (Channel,
+                     "VALUE "
+                     & Key
+                     & " 0"
+                     & Natural'Image (Data'Length)
+                     & CRLF);
+                  String'Write (Channel, Data);
+                  String'Write (Channel, CRLF);
+               end if;
+            end;
+            String_Lists.Next (Value);
+         end loop;
+         String'Write (Channel, "END" & CRLF);
+      end Handle_Get;
+
+      ----------------
+      -- Handle_Set --
+      ----------------
+
+      procedure Handle_Set (Words : String_Lists.List) is
+         Key        : constant String := Nth (Words, 2);
+         Bytes      : constant Natural := Natural'Value (Nth (Words, 5));
+         No_Reply   : constant Boolean :=
+           Natural (Words.Length) = 6 and then Nth (Words, 6) = "noreply";
+         Data       : String_Access := new String (1 .. Bytes);
+         Terminator : String (1 .. 2);
+         Stored     : Boolean := True;
+
+         procedure Set_Value (Conn : Cache_Connection);
+
+         ---------------
+         -- Set_Value --
+         ---------------
+
+         procedure Set_Value (Conn : Cache_Connection) is
+         begin
+            Conn.Set (Key, Data.all);
+         end Set_Value;
+
+      begin
+         --  The data block is allocated on the heap, as it may be arbitrarily
+         --  large.
+
+         Read_Exact (Reader, Data.all);
+         Read_Exact (Reader, Terminator);
+
+         begin
+            With_Connection (Set_Value'Access);
+         exception
+            when
+              Socket_Error | Host_Error | Protocol_Error | Connection_Closed
+            =>
+               Stored := False;
+         end;
+
+         if not No_Reply then
+            String'Write
+              (Channel,
+               (if Stored then "STORED" else "SERVER_ERROR cache unavailable")
+               & CRLF);
+         end if;
+
+         Free (Data);
+
+      exception
+         when others =>
+            Free (Data);
+            raise;
+      end Handle_Set;
+
+      --  Start of processing for Serve_Client
+
+   begin
+      Attach (Reader, Sock);
+
+      loop
+         declare
+            Words : String_Lists.List := Split (Read_Line (Reader));
+         begin
+            if Words.Is_Empty then
+               String'Write (Channel, "ERROR" & CRLF);
+
+            elsif Words.First_Element = "get" then
+               Words.Delete_First;
+               Handle_Get (Words);
+
+            elsif Words.First_Element = "set"
+              and then Natural (Words.Length) in 5 .. 6
+            then
+               Handle_Set (Words);
+
+            elsif Words.First_Element = "quit" then
+               exit;
+
+            else
+               String'Write (Channel, "ERROR" & CRLF);
+            end if;
+         end;
+      end loop;
+
+      Free (Channel);
+
+   exception
+      --  The client closed the connection or sent an ill-formed command
+
+      when Connection_Closed | Socket_Error | Constraint_Error =>
+         Free (Channel);
+
+      --  Any other exception is unexpected; report it, and only drop the
+      --  connection of this client so that the worker keeps serving others.
+
+      when E : others =>
+         Ada.Text_IO.Put_Line
+           (Ada.Text_IO.Standard_Error,
+            "spark_memcached_broker: "
+            & Ada.Exceptions.Exception_Information (E));
+         Free (Channel);
+   end Serve_Client;
+
+   -----------
+   -- Split --
+   -----------
+
+   function Split (Line : String) return String_Lists.List is
+      Result : String_Lists.List;
+      First  : Positive := Line'First;
+   begin
+      for J in Line'Range loop
+         if Line (J) = ' ' then
+            if J > First then
+               Result.Append (Line (First .. J - 1));
+            end if;
+            First := J + 1;
+         end if;
+      end loop;
+      if First <= Line'Last then
+         Result.Append (Line (First .. Line'Last));
+      end if;
+      return Result;
+   end Split;
+
+   ---------------------
+   -- With_Connection --
+   ---------------------
+
+   procedure With_Connection
+     (Process : not null access procedure (Conn : Cache_Connection))
+   is
+      Slot : Positive;
+   begin
+      Pool.Acquire (Slot);
+      begin
+         if not Connected (Slot) then
+            Connections (Slot) := Init (Hostname, Port);
+            Connected (Slot) := True;
+         end if;
+         Process (Connections (Slot));
+      exception
+         when others =>
+            Disconnect (Slot);
+            Pool.Release (Slot);
+            raise;
+      end;
+      Pool.Release (Slot);
+   end With_Connection;
+
+   ------------
+   -- Worker --
+   ------------
+
+   task body Worker is
+      Sock : Socket_Type;
+   begin
+      loop
+         Pending_Clients.Take (Sock);
+         Serve_Client (Sock);
+         Close_Socket (Sock);
+      end loop;
+   end Worker;
+
+   Listener       : Socket_Type;
+   Client         : Socket_Type;
+   Unused_Address : Sock_Addr_Type;
+   Unused         : Boolean;
+
+   --  Start of processing for SPARK_Memcached_Broker
+
+begin
+   --  Remove a stale socket left over by a previous run, if any
+
+   Delete_File (Socket_Name, Unused);
+
+   Create_Socket (Listener, Family_Unix);
+   Bind_Socket (Listener, Unix_Socket_Address (Socket_Name));
+   Listen_Socket (Listener, Max_Pending_Clients);
+
+   declare
+      Workers : array (1 .. 2 * Pool_Size) of Worker;
+      pragma Unreferenced (Workers);
+   begin
+      loop
+         Accept_Socket (Listener, Client, Unused_Address);
+         Pending_Clients.Put (Client);
+      end loop;
+   end;
+
+exception
+   when E : Socket_Error | Host_Error =>
+      Report_Error (Ada.Exceptions.Exception_Message (E));
+end SPARK_Memcached_Broker;
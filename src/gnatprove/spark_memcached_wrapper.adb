@@ -24,19 +24,17 @@
 ------------------------------------------------------------------------------
 
 with Ada.Command_Line; use Ada.Command_Line;
-with Ada.Directories;
 with Ada.Exceptions;
-with Ada.Strings.Fixed;
 with Ada.Text_IO;
 with Cache_Client;
-with Filecache_Client;
 with GNAT.Expect;      use GNAT.Expect;
 with GNAT.OS_Lib;      use GNAT.OS_Lib;
-with GNAT.SHA1;
-with GNAT.Sockets;     use GNAT.Sockets;
+with GNAT.Sockets;
 with GNATCOLL.JSON;    use GNATCOLL.JSON;
-with GNATCOLL.Mmap;
-with Memcache_Client;
+with Proof_Cache;
+with Proof_Cache.Clients;
+with Socket_Readers;
+with String_Utils;     use String_Utils;
 
 procedure SPARK_Memcached_Wrapper with No_Return is
 
@@ -48,180 +46,95 @@ procedure SPARK_Memcached_Wrapper with No_Return is
    --  Invocation:
    --  spark_memcached_wrapper salt hostname:port commandname <args> filename
 
+   --  Instead of hostname:port, the cache can be given as file:directory, or
+   --  as a comma-separated list of at most one file:directory and any number
+   --  of hostname:port, see
+   --  Proof_Cache.Parse_Cache_Specs.
+
    --  The salt is an arbitrary string that is hashed as well, but is not part
    --  of the command name or command line of the tool.
 
-   procedure Hash_Commandline (C : in out GNAT.SHA1.Context);
-   --  @param C the hash context to be updated
-   --  Compute a hash of the commandline provided to the wrapper. The procedure
-   --  starts hashing at the second argument (the command name) and stops
-   --  before the last (the file name). This procedure only has special
-   --  handling for arguments of gnatwhy3 currently. This means that some
-   --  arguments which can be ignored are skipped, for others, instead of
-   --  the argument some other content is hashed.
-
-   procedure Hash_Binary (C : in out GNAT.SHA1.Context; Execname : String);
-   --  If the binary Fn is on the PATH and there is a file Fn.hash next to it,
-   --  we read that file and add it to the context.
+   --  When gnatprove has spawned a spark_memcached_broker, the name of its
+   --  socket is passed in the GNATPROVE_CACHE_BROKER environment variable. The
+   --  memcached server is then accessed through the broker, which keeps
+   --  persistent connections to the server. The connection to the cache is
+   --  not kept open while the tool runs, so that a client connection of the
+   --  broker is only used for the duration of a lookup or a store.
 
-   procedure Hash_File (C : in out GNAT.SHA1.Context; Fn : String);
-   --  @param C the hash context to be updated
-   --  @param Fn the file to be hashed
-   --  Compute a hash of the file in argument
-
-   function Compute_Key return GNAT.SHA1.Message_Digest;
+   function Compute_Key return String;
    --  @return the key to be used for this invocation of the wrapper in the
    --    memcached table
 
    function Init_Client return Cache_Client.Cache'Class;
-   --  @return a connection to the memcached server specified by the first
-   --    command line argument
+   --  @return a connection to the cache specified by the second command line
+   --    argument
+
+   function Lookup (Key : String) return String;
+   --  @param Key the key of this invocation
+   --  @return the cached output for Key, or the empty string if there is
+   --    none. The value is received entirely before anything is printed, and
+   --    a connection lost while receiving it is treated as a cache miss, so
+   --    that a partial output is never passed on to gnat2why.
 
    procedure Report_Error (Msg : String)
    with No_Return;
    --  @param Msg error message to be reported
    --  Quit the program and transmit a message in gnatwhy3 style
 
+   procedure Store (Key : String; Value : String);
+   --  @param Key the key of this invocation
+   --  @param Value the output of the tool
+   --  Store Value in the cache. A connection lost while storing is ignored,
+   --  as the output of the tool is still valid.
+
    -----------------
-   -- Hash_Binary --
+   -- Compute_Key --
    -----------------
 
-   procedure Hash_Binary (C : in out GNAT.SHA1.Context; Execname : String) is
-
-      function Compute_Hash_Filename (Exec : String) return String;
-      --  Compute the hashfile name from the executable name by locating the
-      --  file in the PATH, then adding ".hash", or replacing the suffix with
-      --  ".hash", if any.
-
-      ---------------------------
-      -- Compute_Hash_Filename --
-      ---------------------------
-
-      function Compute_Hash_Filename (Exec : String) return String is
-         Fn : String_Access := GNAT.OS_Lib.Locate_Exec_On_Path (Exec);
-      begin
-         if Fn = null then
-            return "";
-         end if;
-         declare
-            Ext : constant String := Ada.Directories.Extension (Fn.all);
-         begin
-            return
-               Result : constant String :=
-                 (if Ext = ""
-                  then Fn.all & ".hash"
-                  else Fn (Fn'First .. Fn'Last - Ext'Length) & ".hash")
-            do
-               Free (Fn);
-            end return;
-         end;
-      end Compute_Hash_Filename;
-
-      Hash_Fn : constant String := Compute_Hash_Filename (Execname);
+   function Compute_Key return String is
+      Command : String_Lists.List;
    begin
-      if Hash_Fn /= "" and then Ada.Directories.Exists (Hash_Fn) then
-         Hash_File (C, Hash_Fn);
-      end if;
-   end Hash_Binary;
+      --  The salt comes first and the input file last on the command line,
+      --  the command and its arguments are in between.
 
-   ----------------------
-   -- Hash_Commandline --
-   ----------------------
-
-   procedure Hash_Commandline (C : in out GNAT.SHA1.Context) is
-      I : Positive := 3;
-   begin
-      while I < Ada.Command_Line.Argument_Count loop
-         declare
-            Arg : constant String := Ada.Command_Line.Argument (I);
-         begin
-            if Arg = "-j" then
-               I := I + 2;
-            elsif Arg = "--debug" or else Arg = "--force" or else Arg = "-f"
-            then
-               I := I + 1;
-            elsif Arg = "--why3-conf" then
-               Hash_File (C, Ada.Command_Line.Argument (I + 1));
-               I := I + 2;
-            else
-               GNAT.SHA1.Update (C, Arg);
-               I := I + 1;
-            end if;
-         end;
+      for I in 3 .. Argument_Count - 1 loop
+         Command.Append (Argument (I));
       end loop;
-   end Hash_Commandline;
-
-   ---------------
-   -- Hash_File --
-   ---------------
-
-   procedure Hash_File (C : in out GNAT.SHA1.Context; Fn : String) is
-      use GNATCOLL.Mmap;
-      File   : Mapped_File;
-      Region : Mapped_Region;
-
-   begin
-      File := Open_Read (Fn);
-
-      Read (File, Region);
-
-      declare
-         S : String (1 .. Integer (Length (File)));
-         for S'Address use Data (Region).all'Address;
-         --  A fake string directly mapped onto the file contents
-
-      begin
-         GNAT.SHA1.Update (C, S);
-      end;
-
-      Free (Region);
-
-      Close (File);
-   end Hash_File;
+      return
+        Proof_Cache.Compute_Key
+          (Argument (1), Command, Argument (Argument_Count));
+   end Compute_Key;
 
    -----------------
    -- Init_Client --
    -----------------
 
    function Init_Client return Cache_Client.Cache'Class is
-      Info  : String renames Argument (2);
-      Colon : constant Natural := Ada.Strings.Fixed.Index (Info, ":");
+   begin
+      return Proof_Cache.Clients.Init_Client (Argument (2));
+   exception
+      when E : Proof_Cache.Invalid_Cache_Spec =>
+         Report_Error (Ada.Exceptions.Exception_Message (E));
+   end Init_Client;
 
-      Wrong_Port_Msg : constant String :=
-        ("port value should be an integer between 1 and 65535");
+   ------------
+   -- Lookup --
+   ------------
 
+   function Lookup (Key : String) return String is
+      Cache : Cache_Client.Cache'Class := Init_Client;
    begin
-      if Colon = 0 then
-         Report_Error
-           ("the expected format of option --memcached-server "
-            & "is hostname:portnumber, but no colon was found");
-      end if;
       declare
-         First  : String renames Info (Info'First .. Colon - 1);
-         Second : String renames Info (Colon + 1 .. Info'Last);
-         Port   : Port_Type;
+         Value : constant String := Cache.Get (Key);
       begin
-         if First'Length = 4 and then First = "file" then
-            if not Ada.Directories.Exists (Second) then
-               Report_Error ("file caching: no such directory: " & Second);
-            end if;
-            return Filecache_Client.Init (Second);
-         else
-            begin
-               Port := Port_Type'Value (Info (Colon + 1 .. Info'Last));
-            exception
-               when Constraint_Error =>
-                  Report_Error (Wrong_Port_Msg);
-            end;
-
-            if Port = No_Port then
-               Report_Error (Wrong_Port_Msg);
-            else
-               return Memcache_Client.Init (First, Port);
-            end if;
-         end if;
+         Cache.Close;
+         return Value;
       end;
-   end Init_Client;
+   exception
+      when GNAT.Sockets.Socket_Error | Socket_Readers.Connection_Closed =>
+         Cache.Close;
+         return "";
+   end Lookup;
 
    ------------------
    -- Report_Error --
@@ -242,34 +155,19 @@ procedure Report_Error (Msg : String) is
       GNAT.OS_Lib.OS_Exit (1);
    end Report_Error;
 
-   -----------------
-   -- Compute_Key --
-   -----------------
+   -----------
+   -- Store --
+   -----------
 
-   function Compute_Key return GNAT.SHA1.Message_Digest is
-      C : GNAT.SHA1.Context := GNAT.SHA1.Initial_Context;
+   procedure Store (Key : String; Value : String) is
+      Cache : Cache_Client.Cache'Class := Init_Client;
    begin
-
-      --  We first hash the salt (first argument of the command line)
-
-      GNAT.SHA1.Update (C, Argument (1));
-
-      --  The file is hashed separately here, it always comes last on the
-      --  command line.
-
-      Hash_File (C, Argument (Argument_Count));
-
-      --  Hash the rest of the command line
-
-      Hash_Commandline (C);
-
-      --  Read the binary hash if present
-
-      if Argument_Count >= 3 then
-         Hash_Binary (C, Argument (3));
-      end if;
-      return GNAT.SHA1.Digest (C);
-   end Compute_Key;
+      Cache.Set (Key, Value);
+      Cache.Close;
+   exception
+      when GNAT.Sockets.Socket_Error | Socket_Readers.Connection_Closed =>
+         Cache.Close;
+   end Store;
 
 begin
 
@@ -277,14 +175,12 @@ function Compute_Key return GNAT.SHA1.Message_Digest is
    --  in the scope of the exception handler below.
 
    declare
-      Cache : Cache_Client.Cache'Class := Init_Client;
-
       Key    : constant String := Compute_Key;
-      Msg    : constant String := Cache.Get (Key);
+      Cached : constant String := Lookup (Key);
       Status : aliased Integer := 0;
    begin
-      if Msg'Length /= 0 then
-         Ada.Text_IO.Put_Line (Msg);
+      if Cached /= "" then
+         Ada.Text_IO.Put_Line (Cached);
       else
          declare
             Arguments : Argument_List (1 .. Argument_Count - 3);
@@ -306,16 +202,19 @@ function Compute_Key return GNAT.SHA1.Message_Digest is
                --  them.
 
                if Status = 0 or else Cmd /= "gnatwhy3" then
-                  Cache.Set (Key, Msg);
+                  Store (Key, Msg);
                end if;
                Ada.Text_IO.Put_Line (Msg);
             end;
          end;
       end if;
-      Cache.Close;
       GNAT.OS_Lib.OS_Exit (Status);
    end;
 exception
-   when Error : GNAT.Sockets.Socket_Error | GNAT.Sockets.Host_Error =>
+   when Error :
+     GNAT.Sockets.Socket_Error
+     | GNAT.Sockets.Host_Error
+     | Socket_Readers.Connection_Closed
+   =>
       Report_Error (Ada.Exceptions.Exception_Message (Error));
 end SPARK_Memcached_Wrapper;
@@ -0,0 +1,360 @@
+------------------------------------------------------------------------------
+--                                                                          --
+--                            GNATPROVE COMPONENTS                          --
+--                                                                          --
+--                S P A R K _ P R O O F _ S C H E D U L E R                 --
+--                                                                          --
+--                                 B o d y                                  --
+--                                                                          --
+--                       Copyright (C) 2025, AdaCore                        --
+--                                                                          --
+-- gnatprove is  free  software;  you can redistribute it and/or  modify it --
+-- under terms of the  GNU General Public License as published  by the Free --
+-- Software  Foundation;  either version 3,  or (at your option)  any later --
+-- version.  gnatprove is distributed  in the hope that  it will be useful, --
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- --
+-- TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public --
+-- License for  more details.  You should have  received  a copy of the GNU --
+-- General Public License  distributed with  gnatprove;  see file COPYING3. --
+-- If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the --
+-- license.                                                                 --
+--                                                                          --
+-- gnatprove is maintained by AdaCore (http://www.adacore.com)              --
+--                                                                          --
+------------------------------------------------------------------------------
+
+with Ada.Characters.Latin_1;
+with Ada.Command_Line;      use Ada.Command_Line;
+with Ada.Containers.Vectors;
+with Ada.Exceptions;
+with Ada.Streams;
+with Ada.Strings.Unbounded; use Ada.Strings.Unbounded;
+with Ada.Text_IO;
+with GNAT.OS_Lib;           use GNAT.OS_Lib;
+with GNAT.Sockets;          use GNAT.Sockets;
+with GNATCOLL.Utils;        use GNATCOLL.Utils;
+
+procedure SPARK_Proof_Scheduler is
+
+   --  This program is spawned once by gnatprove when proof is run, and limits
+   --  the number of gnatwhy3 processes running at the same time, in place of
+   --  the named semaphore used otherwise. Each gnat2why process submits the
+   --  proof jobs for its entities through spark_semaphore_wrapper, which
+   --  connects to the scheduler and waits for its permission before running
+   --  gnatwhy3. As the jobs of all units being analyzed are pending at the
+   --  same time, the scheduler starts the most expensive ones first, whatever
+   --  their unit, so that the end of a run is not spent waiting for the last
+   --  entities of a single large unit.
+
+   --  Invocation:
+   --  spark_proof_scheduler socketname slots
+
+   --  Clients send a line "acquire <cost>", where cost is a natural number
+   --  estimating the duration of the job, and wait for the line "go". The
+   --  slot taken by a job is released when the client closes the connection,
+   --  so that slots are not lost when a client dies. The scheduler runs until
+   --  it is killed by gnatprove.
+
+   Max_Pending_Clients : constant := 256;
+   --  Maximal number of connections waiting to be accepted
+
+   Max_Open_Sockets : constant := 1000;
+   --  Maximal number of client connections handled at the same time, to stay
+   --  below the limit on the size of the socket sets used with select. Other
+   --  clients wait for their connection to be accepted.
+
+   Max_Request_Length : constant := 64;
+   --  Maximal length of a request, above which the connection is dropped
+
+   type Connection is record
+      Sock    : Socket_Type;
+      Request : Unbounded_String;
+   end record;
+
+   package Connection_Vectors is new
+     Ada.Containers.Vectors (Positive, Connection);
+
+   type Job is record
+      Sock : Socket_Type;
+      Cost : Natural;
+   end record;
+
+   package Job_Vectors is new Ada.Containers.Vectors (Positive, Job);
+
+   package Socket_Vectors is new
+     Ada.Containers.Vectors (Positive, Socket_Type);
+
+   Socket_Name : String renames Argument (1);
+   Slots       : constant Positive := Positive'Value (Argument (2));
+
+   Connecting : Connection_Vectors.Vector;
+   --  Connections whose request was not completely received yet, with the
+   --  part of the request received so far
+
+   Waiting : Job_Vectors.Vector;
+   --  Jobs waiting for a slot, in order of arrival
+
+   Running : Socket_Vectors.Vector;
+   --  Connections of the jobs which hold a slot
+
+   procedure Accept_Connection (Listener : Socket_Type);
+   --  Accept a connection on Listener and add it to Connecting
+
+   procedure Dispatch;
+   --  Give the free slots to the most expensive waiting jobs. Jobs of the
+   --  same cost are started in order of arrival.
+
+   function Is_Closed (Sock : Socket_Type) return Boolean;
+   --  @param Sock a client connection which is ready for reading
+   --  @return True if the client closed the connection. Any data sent by the
+   --    client is discarded.
+
+   procedure Read_Requests (Ready : Socket_Set_Type);
+   --  Receive the data available on the connections in Ready which are in
+   --  Connecting, and add the job requested by each client whose request is
+   --  complete to Waiting. Connections with ill-formed requests are closed.
+   --  The data is received as it arrives, so that a slow client never
+   --  blocks the scheduler.
+
+   procedure Remove_Closed (Ready : in out Socket_Set_Type);
+   --  Close the connections in Ready which were closed by their client,
+   --  releasing the slot of running jobs and dropping waiting jobs.
+
+   procedure Report_Error (Msg : String)
+   with No_Return;
+   --  @param Msg error message to be reported
+   --  Quit the program with an error message
+
+   -----------------------
+   -- Accept_Connection --
+   -----------------------
+
+   procedure Accept_Connection (Listener : Socket_Type) is
+      Sock           : Socket_Type;
+      Unused_Address : Sock_Addr_Type;
+   begin
+      Accept_Socket (Listener, Sock, Unused_Address);
+      Connecting.Append ((Sock => Sock, Request => Null_Unbounded_String));
+   end Accept_Connection;
+
+   --------------
+   -- Dispatch --
+   --------------
+
+   procedure Dispatch is
+   begin
+      while Natural (Running.Length) < Slots and then not Waiting.Is_Empty loop
+         declare
+            Best : Positive := Waiting.First_Index;
+         begin
+            --  There are at most a few hundred waiting jobs, so a linear
+            --  search is cheap compared to the duration of a job.
+
+            for J in Waiting.First_Index + 1 .. Waiting.Last_Index loop
+               if Waiting (J).Cost > Waiting (Best).Cost then
+                  Best := J;
+               end if;
+            end loop;
+
+            declare
+               Sock    : constant Socket_Type := Waiting (Best).Sock;
+               Channel : Stream_Access := Stream (Sock);
+            begin
+               Waiting.Delete (Best);
+               String'Write (Channel, "go" & Ada.Characters.Latin_1.LF);
+               Free (Channel);
+               Running.Append (Sock);
+            exception
+               --  The client died while waiting
+
+               when Socket_Error =>
+                  Free (Channel);
+                  Close_Socket (Sock);
+            end;
+         end;
+      end loop;
+   end Dispatch;
+
+   ---------------
+   -- Is_Closed --
+   ---------------
+
+   function Is_Closed (Sock : Socket_Type) return Boolean is
+      use type Ada.Streams.Stream_Element_Offset;
+      Data : Ada.Streams.Stream_Element_Array (1 .. 64);
+      Last : Ada.Streams.Stream_Element_Offset;
+   begin
+      Receive_Socket (Sock, Data, Last);
+      return Last < Data'First;
+   exception
+      when Socket_Error =>
+         return True;
+   end Is_Closed;
+
+   -------------------
+   -- Read_Requests --
+   -------------------
+
+   procedure Read_Requests (Ready : Socket_Set_Type) is
+      use type Ada.Streams.Stream_Element_Offset;
+
+      Prefix : constant String := "acquire ";
+      LF     : constant String := [Ada.Characters.Latin_1.LF];
+   begin
+      for J in reverse Connecting.First_Index .. Connecting.Last_Index loop
+         if Is_Set (Ready, Connecting (J).Sock) then
+            declare
+               Sock    : constant Socket_Type := Connecting (J).Sock;
+               Request : Unbounded_String := Connecting (J).Request;
+               Data    : Ada.Streams.Stream_Element_Array (1 .. 64);
+               Last    : Ada.Streams.Stream_Element_Offset;
+               EOL     : Natural := 0;
+               Cost    : Natural := 0;
+               Drop    : Boolean := False;
+            begin
+               --  Data is available, so this does not block. No data means
+               --  that the client closed the connection.
+
+               begin
+                  Receive_Socket (Sock, Data, Last);
+                  Drop := Last < Data'First;
+               exception
+                  when Socket_Error =>
+                     Drop := True;
+               end;
+
+               if not Drop then
+                  for Byte of Data (Data'First .. Last) loop
+                     Append (Request, Character'Val (Byte));
+                  end loop;
+
+                  EOL := Index (Request, LF);
+
+                  if EOL > 0 then
+                     declare
+                        Line : constant String := Slice (Request, 1, EOL - 1);
+                     begin
+                        Drop := not Starts_With (Line, Prefix);
+
+                        if not Drop then
+                           Cost :=
+                             Natural'Value
+                               (Line
+                                  (Line'First + Prefix'Length .. Line'Last));
+                        end if;
+                     exception
+                        when Constraint_Error =>
+                           Drop := True;
+                     end;
+                  else
+                     Drop := Length (Request) > Max_Request_Length;
+                  end if;
+               end if;
+
+               if Drop then
+                  Close_Socket (Sock);
+                  Connecting.Delete (J);
+               elsif EOL > 0 then
+                  Connecting.Delete (J);
+                  Waiting.Append ((Sock => Sock, Cost => Cost));
+               else
+                  Connecting (J).Request := Request;
+               end if;
+            end;
+         end if;
+      end loop;
+   end Read_Requests;
+
+   -------------------
+   -- Remove_Closed --
+   -------------------
+
+   procedure Remove_Closed (Ready : in out Socket_Set_Type) is
+   begin
+      for J in reverse Running.First_Index .. Running.Last_Index loop
+         if Is_Set (Ready, Running (J)) and then Is_Closed (Running (J)) then
+            Close_Socket (Running (J));
+            Running.Delete (J);
+         end if;
+      end loop;
+
+      for J in reverse Waiting.First_Index .. Waiting.Last_Index loop
+         if Is_Set (Ready, Waiting (J).Sock)
+           and then Is_Closed (Waiting (J).Sock)
+         then
+            Close_Socket (Waiting (J).Sock);
+            Waiting.Delete (J);
+         end if;
+      end loop;
+   end Remove_Closed;
+
+   ------------------
+   -- Report_Error --
+   ------------------
+
+   procedure Report_Error (Msg : String) is
+   begin
+      Ada.Text_IO.Put_Line
+        (Ada.Text_IO.Standard_Error, "spark_proof_scheduler: " & Msg);
+      OS_Exit (1);
+   end Report_Error;
+
+   Listener         : Socket_Type;
+   Selector         : Selector_Type;
+   Ready            : Socket_Set_Type;
+   Unused_Write_Set : Socket_Set_Type;
+   Status           : Selector_Status;
+   Unused           : Boolean;
+
+   --  Start of processing for SPARK_Proof_Scheduler
+
+begin
+   --  Remove a stale socket left over by a previous run, if any
+
+   Delete_File (Socket_Name, Unused);
+
+   Create_Socket (Listener, Family_Unix);
+   Bind_Socket (Listener, Unix_Socket_Address (Socket_Name));
+   Listen_Socket (Listener, Max_Pending_Clients);
+   Create_Selector (Selector);
+
+   loop
+      Empty (Ready);
+      Empty (Unused_Write_Set);
+
+      if Natural (Connecting.Length + Running.Length + Waiting.Length)
+        < Max_Open_Sockets
+      then
+         Set (Ready, Listener);
+      end if;
+
+      for C of Connecting loop
+         Set (Ready, C.Sock);
+      end loop;
+
+      for Sock of Running loop
+         Set (Ready, Sock);
+      end loop;
+
+      for J of Waiting loop
+         Set (Ready, J.Sock);
+      end loop;
+
+      Check_Selector (Selector, Ready, Unused_Write_Set, Status);
+
+      if Status = Completed then
+         Remove_Closed (Ready);
+         Read_Requests (Ready);
+
+         if Is_Set (Ready, Listener) then
+            Accept_Connection (Listener);
+         end if;
+
+         Dispatch;
+      end if;
+   end loop;
+
+exception
+   when E : Socket_Error =>
+      Report_Error (Ada.Exceptions.Exception_Message (E));
+end SPARK_Proof_Scheduler;
@@ -110,6 +110,11 @@ procedure SPARK_Report is
    Has_Errors         : Boolean := False;
    Colors             : Boolean := False;
 
+   Predicted_Proof_Time : Float := 0.0;
+   Actual_Proof_Time    : Float := 0.0;
+   --  Total predicted and actual time in seconds for the proof of entities
+   --  whose cost was recorded by a previous analysis
+
    Mode : GP_Mode;
 
    Error_Code : Integer := 0;
@@ -152,6 +157,10 @@ procedure Print_Analysis_Report (Handle : Ada.Text_IO.File_Type);
    procedure Print_Max_Steps (Handle : Ada.Text_IO.File_Type);
    --  Print a line that summarizes the maximum required steps
 
+   procedure Print_Proof_Time (Handle : Ada.Text_IO.File_Type);
+   --  Print the predicted and actual time for the proof of entities whose
+   --  cost was recorded by a previous analysis, if any.
+
    procedure Print_Most_Difficult_Proved_Checks
      (Handle : Ada.Text_IO.File_Type);
    --  Print the set of most difficult checks to prove
@@ -857,6 +866,16 @@ procedure Handle_SPARK_Status (Name : UTF8_String; Value : JSON_Value) is
       if Has_Proof then
          Handle_Proof_Items (Get (Get (Dict, "proof")), Unit);
       end if;
+      if Has_Field (Dict, "proof_cost") then
+         declare
+            Cost : constant JSON_Value := Get (Dict, "proof_cost");
+         begin
+            Predicted_Proof_Time :=
+              Predicted_Proof_Time + Float'(Get (Cost, "predicted"));
+            Actual_Proof_Time :=
+              Actual_Proof_Time + Float'(Get (Cost, "actual"));
+         end;
+      end if;
       if Assumptions and then Has_Field (Dict, "assumptions") then
          Handle_Assume_Items (Get (Get (Dict, "assumptions")), Unit);
       end if;
@@ -1190,6 +1209,23 @@ procedure Print_Most_Difficult_Proved_Checks
       Ada.Text_IO.New_Line (Handle);
    end Print_Most_Difficult_Proved_Checks;
 
+   ----------------------
+   -- Print_Proof_Time --
+   ----------------------
+
+   procedure Print_Proof_Time (Handle : Ada.Text_IO.File_Type) is
+      Predicted : constant Natural := Integer (Predicted_Proof_Time);
+      Actual    : constant Natural := Integer (Actual_Proof_Time);
+   begin
+      if Predicted_Proof_Time > 0.0 then
+         Ada.Text_IO.Put_Line
+           (Handle,
+            f"proof time of previously analyzed entities: predicted "
+            & f"{Predicted} seconds, actual {Actual} seconds");
+         Ada.Text_IO.New_Line (Handle);
+      end if;
+   end Print_Proof_Time;
+
    -------------------
    -- Process_Stats --
    -------------------
@@ -1489,6 +1525,7 @@ function To_String (S : Summary_Entries) return String is
       end if;
       if Max_Progress >= Progress_Proof then
          Print_Max_Steps (Handle);
+         Print_Proof_Time (Handle);
       end if;
    else
 
@@ -23,56 +23,156 @@
 --                                                                          --
 ------------------------------------------------------------------------------
 
-with Ada.Command_Line; use Ada.Command_Line;
+with Ada.Characters.Latin_1;
+with Ada.Command_Line;  use Ada.Command_Line;
 with Ada.Environment_Variables;
 with Ada.Text_IO;
-with GNAT.OS_Lib;      use GNAT.OS_Lib;
-with Named_Semaphores; use Named_Semaphores;
+with GNAT.OS_Lib;       use GNAT.OS_Lib;
+with GNAT.Sockets;      use GNAT.Sockets;
+with GNATCOLL.JSON;     use GNATCOLL.JSON;
+with GNATCOLL.Utils;    use GNATCOLL.Utils;
+with Named_Semaphores;  use Named_Semaphores;
+with Socket_Readers;    use Socket_Readers;
 
 procedure SPARK_Semaphore_Wrapper with No_Return is
 
    --  This is a wrapper program, which runs the wrapped program only if the
-   --  named semaphore is available for locking.
+   --  named semaphore is available for locking, or when allowed to by the
+   --  proof scheduler.
 
-   --  The name of the semaphore is retrieved from the GNATPROVE_SEMAPHORE
-   --  environment variable. If no such variable is set, the program returns an
-   --  error.
+   --  If the GNATPROVE_SCHEDULER environment variable is set, it holds the
+   --  name of the socket of spark_proof_scheduler, which decides when the
+   --  wrapped program can run, based on its estimated cost. Otherwise, the
+   --  name of the semaphore is retrieved from the GNATPROVE_SEMAPHORE
+   --  environment variable. If no such variable is set, the program returns
+   --  an error.
 
    --  Invocation:
-   --  spark_semaphore_wrapper command <args>
+   --  spark_semaphore_wrapper [--cost=N] command <args>
+
+   Cost_Switch : constant String := "--cost=";
+
+   Has_Cost : constant Boolean :=
+     Argument_Count >= 1 and then Starts_With (Argument (1), Cost_Switch);
+
+   Cmd_Index : constant Positive := (if Has_Cost then 2 else 1);
+   --  Index of the command among the arguments of the wrapper
 
    Ret : Integer;
 
-   Args : String_List (1 .. Argument_Count - 1);
+   Args : String_List (1 .. Argument_Count - Cmd_Index);
    --  Holds the arguments that will be passed to program to be spawned. We
-   --  need one less than the arguments of the wrapper program, because we
-   --  remove the name of the wrapper.
+   --  remove the name of the wrapper and the cost switch, if any.
 
-   Env_Var_Name : constant String := "GNATPROVE_SEMAPHORE";
-begin
-   if Argument_Count < 1 then
-      Ada.Text_IO.Put_Line ("spark_semaphore_wrapper: not enough arguments");
+   Env_Var_Name       : constant String := "GNATPROVE_SEMAPHORE";
+   Scheduler_Var_Name : constant String := "GNATPROVE_SCHEDULER";
+
+   function Cost return Natural;
+   --  @return the estimated cost of the wrapped program, 0 if unknown
+
+   procedure Report_Error (Msg : String)
+   with No_Return;
+   --  @param Msg error message to be reported
+   --  Quit the program and transmit a message in gnatwhy3 style
+
+   ----------
+   -- Cost --
+   ----------
+
+   function Cost return Natural is
+   begin
+      if Has_Cost then
+         declare
+            Arg : constant String := Argument (1);
+         begin
+            return
+              Natural'Value
+                (Arg (Arg'First + Cost_Switch'Length .. Arg'Last));
+         end;
+      end if;
+      return 0;
+   exception
+      when Constraint_Error =>
+         return 0;
+   end Cost;
+
+   ------------------
+   -- Report_Error --
+   ------------------
+
+   procedure Report_Error (Msg : String) is
+      Res : constant JSON_Value := Create_Object;
+   begin
+      --  gnat2why only uses this wrapper to run gnatwhy3, and parses its
+      --  output as the output of gnatwhy3. See why3/src/gnat/gnat_report.mli
+      --  for the format of this output.
+
+      Set_Field (Res, "error", "spark_semaphore_wrapper: " & Msg);
+      Set_Field (Res, "internal", Create (False));
+      Set_Field (Res, "results", Create (Empty_Array));
+      Ada.Text_IO.Put_Line (Write (Res));
       OS_Exit (1);
+   end Report_Error;
+
+begin
+   if Argument_Count < Cmd_Index then
+      Report_Error ("not enough arguments");
    end if;
-   if not Ada.Environment_Variables.Exists (Env_Var_Name) then
-      Ada.Text_IO.Put_Line
-        ("spark_semaphore_wrapper: "
-         & Env_Var_Name
-         & "not set, semaphore name unknown");
-      OS_Exit (1);
+   if not Ada.Environment_Variables.Exists (Scheduler_Var_Name)
+     and then not Ada.Environment_Variables.Exists (Env_Var_Name)
+   then
+      Report_Error (Env_Var_Name & " not set, semaphore name unknown");
    end if;
    for I in Args'Range loop
-      Args (I) := new String'(Argument (I + 1));
+      Args (I) := new String'(Argument (I + Cmd_Index));
    end loop;
    declare
-      Sem  : Semaphore;
-      Prog : constant String_Access := Locate_Exec_On_Path (Argument (1));
+      Prog : constant String_Access :=
+        Locate_Exec_On_Path (Argument (Cmd_Index));
    begin
-      Open (Ada.Environment_Variables.Value (Env_Var_Name), Sem);
-      Wait (Sem);
-      Ret := Spawn (Prog.all, Args);
-      Release (Sem);
-      Close (Sem);
+      if Ada.Environment_Variables.Exists (Scheduler_Var_Name) then
+
+         --  The slot given by the scheduler is released when the connection
+         --  is closed, including when this process dies.
+
+         declare
+            Sock    : Socket_Type;
+            Channel : Stream_Access;
+            Reader  : Socket_Reader;
+         begin
+            Create_Socket (Sock, Family_Unix);
+            Connect_Socket
+              (Sock,
+               Unix_Socket_Address
+                 (Ada.Environment_Variables.Value (Scheduler_Var_Name)));
+            Channel := Stream (Sock);
+            String'Write
+              (Channel,
+               "acquire"
+               & Natural'Image (Cost)
+               & Ada.Characters.Latin_1.LF);
+            Free (Channel);
+            Attach (Reader, Sock);
+            if Read_Line (Reader) /= "go" then
+               Report_Error ("unexpected answer from the proof scheduler");
+            end if;
+            Ret := Spawn (Prog.all, Args);
+            Close_Socket (Sock);
+         exception
+            when Socket_Error | Connection_Closed =>
+               Report_Error ("cannot reach the proof scheduler");
+         end;
+      else
+         declare
+            Sem : Semaphore;
+         begin
+            Open (Ada.Environment_Variables.Value (Env_Var_Name), Sem);
+            Wait (Sem);
+            Ret := Spawn (Prog.all, Args);
+            Release (Sem);
+            Close (Sem);
+         end;
+      end if;
    end;
    OS_Exit (Ret);
 end SPARK_Semaphore_Wrapper;
@@ -0,0 +1,311 @@
+------------------------------------------------------------------------------
+--                                                                          --
+--                            GNATPROVE COMPONENTS                          --
+--                                                                          --
+--                  T I E R E D _ C A C H E _ C L I E N T                   --
+--                                                                          --
+--                                 B o d y                                  --
+--                                                                          --
+--                       Copyright (C) 2025, AdaCore                        --
+--                                                                          --
+-- gnatprove is  free  software;  you can redistribute it and/or  modify it --
+-- under terms of the  GNU General Public License as published  by the Free --
+-- Software  Foundation;  either version 3,  or (at your option)  any later --
+-- version.  gnatprove is distributed  in the hope that  it will be useful, --
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- --
+-- TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public --
+-- License for  more details.  You should have  received  a copy of the GNU --
+-- General Public License  distributed with  gnatprove;  see file COPYING3. --
+-- If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the --
+-- license.                                                                 --
+--                                                                          --
+-- gnatprove is maintained by AdaCore (http://www.adacore.com)              --
+--                                                                          --
+------------------------------------------------------------------------------
+
+with Ada.Containers.Generic_Array_Sort;
+with Ada.Unchecked_Deallocation;
+with GNAT.SHA1;
+with Socket_Readers;
+
+package body Tiered_Cache_Client is
+
+   use type Interfaces.Unsigned_32;
+
+   Points_Per_Server : constant := 100;
+   --  Number of points of each server on the hash ring. Using many points per
+   --  server evens out the share of the keys stored on each server.
+
+   function "<" (Left, Right : Ring_Point) return Boolean
+   is (Left.Hash < Right.Hash);
+
+   procedure Sort is new
+     Ada.Containers.Generic_Array_Sort
+       (Index_Type   => Positive,
+        Element_Type => Ring_Point,
+        Array_Type   => Ring_Array);
+
+   procedure Free is new
+     Ada.Unchecked_Deallocation (Cache'Class, Cache_Access);
+
+   procedure Free is new
+     Ada.Unchecked_Deallocation (Ring_Array, Ring_Access);
+
+   procedure Free is new
+     Ada.Unchecked_Deallocation (Remote_State, Remote_State_Access);
+
+   function Hash (S : String) return Interfaces.Unsigned_32;
+   --  @return a hash of S on the ring
+
+   function Server_For (Conn : Tiered_Cache; Key : String) return Positive
+   with Pre => Conn.Ring'Length > 0;
+   --  @return the index of the server which stores Key
+
+   function Connect (Conn : Tiered_Cache; Index : Positive) return Boolean;
+   --  @param Index index of a server
+   --  @return True if a connection to the server is open, opening it if
+   --    needed
+
+   procedure Disconnect (Conn : Tiered_Cache; Index : Positive);
+   --  @param Index index of a server
+   --  Close the connection to the server after a communication error, and
+   --  do not try to reach it again.
+
+   function Remote_Get (Conn : Tiered_Cache; Key : String) return String;
+   --  @return the value for Key on its remote server, or empty if the value
+   --    is not stored or the server cannot be reached
+
+   procedure Remote_Set (Conn : Tiered_Cache; Key : String; Value : String);
+   --  Store Value for Key on its remote server, if it can be reached
+
+   -------------
+   -- Connect --
+   -------------
+
+   function Connect (Conn : Tiered_Cache; Index : Positive) return Boolean is
+      State : Remote_State renames Conn.Remote.all;
+   begin
+      if State.Connected (Index) then
+         return True;
+      elsif State.Unreachable (Index) then
+         return False;
+      end if;
+
+      declare
+         S : constant Server := Conn.Servers (Index);
+      begin
+         State.Connections (Index) := Init (To_String (S.Hostname), S.Port);
+         State.Connected (Index) := True;
+         return True;
+      exception
+         when Socket_Error | Host_Error =>
+            State.Unreachable (Index) := True;
+            return False;
+      end;
+   end Connect;
+
+   ----------------
+   -- Disconnect --
+   ----------------
+
+   procedure Disconnect (Conn : Tiered_Cache; Index : Positive) is
+      State : Remote_State renames Conn.Remote.all;
+   begin
+      State.Connected (Index) := False;
+      State.Unreachable (Index) := True;
+      State.Connections (Index).Close;
+   exception
+      when Socket_Error =>
+         null;
+   end Disconnect;
+
+   ----------
+   -- Hash --
+   ----------
+
+   function Hash (S : String) return Interfaces.Unsigned_32 is
+      Digest : constant GNAT.SHA1.Message_Digest := GNAT.SHA1.Digest (S);
+   begin
+      return Interfaces.Unsigned_32'Value ("16#" & Digest (1 .. 8) & "#");
+   end Hash;
+
+   ----------
+   -- Init --
+   ----------
+
+   function Init
+     (Local : Cache_Access; Servers : Server_Vectors.Vector)
+      return Tiered_Cache
+   is
+      Count : constant Natural := Natural (Servers.Length);
+      Ring  : constant Ring_Access :=
+        new Ring_Array (1 .. Count * Points_Per_Server);
+   begin
+      for J in 1 .. Count loop
+         declare
+            Name : constant String :=
+              To_String (Servers (J).Hostname)
+              & ":"
+              & Port_Type'Image (Servers (J).Port);
+         begin
+            for P in 1 .. Points_Per_Server loop
+               Ring ((J - 1) * Points_Per_Server + P) :=
+                 (Hash => Hash (Name & "#" & Positive'Image (P)),
+                  Server => J);
+            end loop;
+         end;
+      end loop;
+      Sort (Ring.all);
+
+      return
+        (Local   => Local,
+         Servers => Servers,
+         Ring    => Ring,
+         Remote  => new Remote_State (Count));
+   end Init;
+
+   ----------------
+   -- Remote_Get --
+   ----------------
+
+   function Remote_Get (Conn : Tiered_Cache; Key : String) return String is
+   begin
+      if Conn.Ring'Length = 0 then
+         return "";
+      end if;
+
+      declare
+         Index : constant Positive := Server_For (Conn, Key);
+      begin
+         if not Connect (Conn, Index) then
+            return "";
+         end if;
+         return Conn.Remote.Connections (Index).Get (Key);
+      exception
+         when
+           Socket_Error | Protocol_Error | Socket_Readers.Connection_Closed
+         =>
+            Disconnect (Conn, Index);
+            return "";
+      end;
+   end Remote_Get;
+
+   ----------------
+   -- Remote_Set --
+   ----------------
+
+   procedure Remote_Set (Conn : Tiered_Cache; Key : String; Value : String) is
+   begin
+      if Conn.Ring'Length = 0 then
+         return;
+      end if;
+
+      declare
+         Index : constant Positive := Server_For (Conn, Key);
+      begin
+         if Connect (Conn, Index) then
+            Conn.Remote.Connections (Index).Set (Key, Value);
+         end if;
+      exception
+         when
+           Socket_Error | Protocol_Error | Socket_Readers.Connection_Closed
+         =>
+            Disconnect (Conn, Index);
+      end;
+   end Remote_Set;
+
+   ----------------
+   -- Server_For --
+   ----------------
+
+   function Server_For (Conn : Tiered_Cache; Key : String) return Positive is
+      Ring : Ring_Array renames Conn.Ring.all;
+      H    : constant Interfaces.Unsigned_32 := Hash (Key);
+      Low  : Positive := Ring'First;
+      High : Positive := Ring'Last;
+      Mid  : Positive;
+   begin
+      --  Keys hashed after the last point of the ring wrap around to the
+      --  first point.
+
+      if H > Ring (High).Hash then
+         return Ring (Low).Server;
+      end if;
+
+      --  Find the first point whose hash is at least H
+
+      while Low < High loop
+         Mid := Low + (High - Low) / 2;
+         if Ring (Mid).Hash < H then
+            Low := Mid + 1;
+         else
+            High := Mid;
+         end if;
+      end loop;
+
+      return Ring (Low).Server;
+   end Server_For;
+
+   ---------
+   -- Set --
+   ---------
+
+   procedure Set (Conn : Tiered_Cache; Key : String; Value : String) is
+   begin
+      if Conn.Local /= null then
+         Conn.Local.Set (Key, Value);
+      end if;
+      Remote_Set (Conn, Key, Value);
+   end Set;
+
+   ---------
+   -- Get --
+   ---------
+
+   function Get (Conn : Tiered_Cache; Key : String) return String is
+   begin
+      if Conn.Local /= null then
+         declare
+            Value : constant String := Conn.Local.Get (Key);
+         begin
+            if Value /= "" then
+               return Value;
+            end if;
+         end;
+      end if;
+
+      declare
+         Value : constant String := Remote_Get (Conn, Key);
+      begin
+         --  Write back the value to the local cache, so that the next lookup
+         --  does not need to reach the server.
+
+         if Value /= "" and then Conn.Local /= null then
+            Conn.Local.Set (Key, Value);
+         end if;
+         return Value;
+      end;
+   end Get;
+
+   -----------
+   -- Close --
+   -----------
+
+   procedure Close (Conn : in out Tiered_Cache) is
+   begin
+      if Conn.Local /= null then
+         Conn.Local.Close;
+         Free (Conn.Local);
+      end if;
+
+      for J in Conn.Remote.Connections'Range loop
+         if Conn.Remote.Connected (J) then
+            Conn.Remote.Connections (J).Close;
+         end if;
+      end loop;
+
+      Free (Conn.Remote);
+      Free (Conn.Ring);
+   end Close;
+
+end Tiered_Cache_Client;
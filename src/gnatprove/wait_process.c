@@ -0,0 +1,66 @@
+/*****************************************************************************
+ *                                                                           *
+ *                            GNATPROVE COMPONENTS                           *
+ *                                                                           *
+ *                          W A I T _ P R O C E S S                          *
+ *                                                                           *
+ *                            C Implementation file                          *
+ *                                                                           *
+ *                        Copyright (C) 2026, AdaCore                        *
+ *                                                                           *
+ * gnatprove is  free  software;  you can redistribute it and/or  modify it  *
+ * under terms of the  GNU General Public License as published  by the Free  *
+ * Software  Foundation;  either version 3,  or (at your option)  any later  *
+ * version.  gnatprove is distributed  in the hope that  it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN-  *
+ * TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public  *
+ * License for  more details.  You should have  received  a copy of the GNU  *
+ * General Public License  distributed with  gnatprove;  see file COPYING3.  *
+ * If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the  *
+ * license.                                                                  *
+ *                                                                           *
+ * gnatprove is maintained by AdaCore (http://www.adacore.com)               *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+// Wait for the termination of the child process pid, which must have been
+// spawned by GNAT.OS_Lib.Non_Blocking_Spawn, and return its exit status, or
+// -1 if it did not exit normally or could not be waited for. Unlike
+// GNAT.OS_Lib.Wait_Process, which returns the first child to terminate, this
+// leaves the other children of the process to be waited for by their
+// owners.
+
+int wait_process (int pid) {
+#ifdef _WIN32
+   HANDLE h = OpenProcess
+     (SYNCHRONIZE | PROCESS_QUERY_LIMITED_INFORMATION, FALSE, (DWORD) pid);
+   DWORD code;
+   int result = -1;
+
+   if (h == NULL) return -1;
+   if (WaitForSingleObject (h, INFINITE) == WAIT_OBJECT_0
+       && GetExitCodeProcess (h, &code))
+      result = (int) code;
+   CloseHandle (h);
+   return result;
+#else
+   int status;
+   pid_t result;
+
+   do
+      result = waitpid ((pid_t) pid, &status, 0);
+   while (result == -1 && errno == EINTR);
+
+   if (result != (pid_t) pid || !WIFEXITED (status))
+      return -1;
+   return WEXITSTATUS (status);
+#endif
+}
@@ -45,6 +45,11 @@ function Get_Opt (V : JSON_Value; Field : String) return Unbounded_String
       with Pre => Has_Field (V, Field);
       --  Return the string value of the [Field] of the JSON record [V]
 
+      function Get_Opt (V : JSON_Value; Field : String) return Integer
+      is (Get (Get (V, Field)))
+      with Pre => Has_Field (V, Field);
+      --  Return the integer value of the [Field] of the JSON record [V]
+
       procedure Read_File_Specific_Info (V : JSON_Value);
 
       -----------------------------
@@ -122,8 +127,10 @@ procedure Read_File_Specific_Info (V : JSON_Value) is
          Ide_Mode := Get_Opt (V, Ide_Mode_Name);
          CWE := Get_Opt (V, CWE_Name);
          Parallel_Why3 := Get_Opt (V, Parallel_Why3_Name);
+         Flow_Jobs := Integer'Max (1, Get_Opt (V, Flow_Jobs_Name));
 
          Why3_Dir := Get_Opt (V, Why3_Dir_Name);
+         GG_Database := Get_Opt (V, GG_Database_Name);
       end if;
 
       pragma Assert (Has_Field (V, File_Specific_Name));
@@ -34,6 +34,7 @@
 with Errout;
 with Erroutc;
 with Errout_Wrapper;              use Errout_Wrapper;
+with Flow_Journal;
 with Flow_Refinement;             use Flow_Refinement;
 with Flow_Types;                  use Flow_Types;
 with Flow_Utility;                use Flow_Utility;
@@ -3577,6 +3578,7 @@ procedure Check_Is_Annotated
       Node_Slc : constant Source_Ptr := Sloc (Node);
    begin
       Info := Annotated_Range'(Present => False);
+      Flow_Journal.Record_Annotation_Use (Node, Msg, Check);
 
       --  This is a simple linear search in a sorted list, the only subtle
       --  thing is that several entries may match, or entries may include
@@ -0,0 +1,183 @@
+------------------------------------------------------------------------------
+--                                                                          --
+--                            GNAT2WHY COMPONENTS                           --
+--                                                                          --
+--                       C H U N K E D _ T A B L E S                        --
+--                                                                          --
+--                                 B o d y                                  --
+--                                                                          --
+--                       Copyright (C) 2026, AdaCore                        --
+--                                                                          --
+-- gnat2why is  free  software;  you can redistribute  it and/or  modify it --
+-- under terms of the  GNU General Public License as published  by the Free --
+-- Software  Foundation;  either version 3,  or (at your option)  any later --
+-- version.  gnat2why is distributed  in the hope that  it will be  useful, --
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- --
+-- TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public --
+-- License for  more details.  You should have  received  a copy of the GNU --
+-- General  Public License  distributed with  gnat2why;  see file COPYING3. --
+-- If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the --
+-- license.                                                                 --
+--                                                                          --
+-- gnat2why is maintained by AdaCore (http://www.adacore.com)               --
+--                                                                          --
+------------------------------------------------------------------------------
+
+with Ada.Unchecked_Deallocation;
+
+package body Chunked_Tables is
+
+   procedure Free is new Ada.Unchecked_Deallocation (Block, Block_Access);
+
+   procedure Free is new Ada.Unchecked_Deallocation (Chunk, Chunk_Access);
+
+   procedure Free is new
+     Ada.Unchecked_Deallocation (Element_Type, Element_Access);
+
+   function Position (Index : Index_Type) return Natural
+   is (Natural (Index - Index_Type'First))
+   with Inline;
+   --  Returns the zero-based position of the element at Index
+
+   --------------
+   -- Allocate --
+   --------------
+
+   overriding
+   procedure Allocate
+     (Pool                     : in out Arena_Pool;
+      Storage_Address          : out System.Address;
+      Size_In_Storage_Elements : Storage_Count;
+      Alignment                : Storage_Count)
+   is
+      A     : Arena renames Pool.Current.all;
+      Start : Storage_Count :=
+        (A.Top + Alignment - 1) / Alignment * Alignment;
+
+   begin
+      if Size_In_Storage_Elements > Block_Size then
+         raise Storage_Error;
+      end if;
+
+      --  An element is never split between two blocks. Blocks are allocated
+      --  with the maximal alignment and their size is a multiple of it, so
+      --  the start of the next block is suitably aligned.
+
+      if Start mod Block_Size + Size_In_Storage_Elements > Block_Size then
+         Start := (Start / Block_Size + 1) * Block_Size;
+      end if;
+
+      if Natural (Start / Block_Size) = Natural (A.Blocks.Length) then
+         A.Blocks.Append (new Block);
+      end if;
+
+      Storage_Address :=
+        A.Blocks (Natural (Start / Block_Size)) (Start mod Block_Size)'Address;
+      A.Top := Start + Size_In_Storage_Elements;
+   end Allocate;
+
+   ------------
+   -- Append --
+   ------------
+
+   procedure Append (Container : in out Table; New_Item : Element_Type) is
+      Chunk_Index : constant Natural := Container.Length / Chunk_Size;
+      Mark        : constant Storage_Count := Container.Storage.Top;
+      Element     : Element_Access;
+
+   begin
+      if Chunk_Index = Natural (Container.Chunks.Length) then
+         Container.Chunks.Append (new Chunk);
+      end if;
+
+      Pool.Current := Container.Storage'Unchecked_Access;
+      Element := new Element_Type'(New_Item);
+
+      Container.Chunks (Chunk_Index) (Container.Length mod Chunk_Size) :=
+        (Element => Element, Mark => Mark);
+
+      Container.Length := Container.Length + 1;
+   end Append;
+
+   -----------
+   -- Clear --
+   -----------
+
+   procedure Clear (Container : in out Table) is
+   begin
+      Set_Last (Container, Index_Type'First - 1);
+
+      for C of Container.Chunks loop
+         Free (C);
+      end loop;
+
+      for B of Container.Storage.Blocks loop
+         Free (B);
+      end loop;
+
+      --  Free the memory used by the directories themselves; GNAT's
+      --  implementation of Reserve_Capacity does it when called with 0.
+
+      Container.Chunks.Clear;
+      Container.Chunks.Reserve_Capacity (0);
+      Container.Storage.Blocks.Clear;
+      Container.Storage.Blocks.Reserve_Capacity (0);
+      Container.Storage.Top := 0;
+      Container.Length := 0;
+   end Clear;
+
+   ------------------------
+   -- Constant_Reference --
+   ------------------------
+
+   function Constant_Reference
+     (Container : Table; Index : Index_Type) return Constant_Reference_Type
+   is
+      Pos : constant Natural := Position (Index);
+   begin
+      return
+        (Element =>
+           Container.Chunks (Pos / Chunk_Size) (Pos mod Chunk_Size).Element);
+   end Constant_Reference;
+
+   ---------------
+   -- Reference --
+   ---------------
+
+   function Reference
+     (Container : in out Table; Index : Index_Type) return Reference_Type
+   is
+      Pos : constant Natural := Position (Index);
+   begin
+      return
+        (Element =>
+           Container.Chunks (Pos / Chunk_Size) (Pos mod Chunk_Size).Element);
+   end Reference;
+
+   --------------
+   -- Set_Last --
+   --------------
+
+   procedure Set_Last (Container : in out Table; Last : Index_Type'Base) is
+      New_Length : constant Natural := Natural (Last - Index_Type'First + 1);
+   begin
+      if New_Length = Container.Length then
+         return;
+      end if;
+
+      --  Finalize the removed elements, then reclaim the memory they used by
+      --  bringing the top of the arena back to where the first of them was
+      --  allocated.
+
+      for Pos in New_Length .. Container.Length - 1 loop
+         Free
+           (Container.Chunks (Pos / Chunk_Size) (Pos mod Chunk_Size).Element);
+      end loop;
+
+      Container.Storage.Top :=
+        Container.Chunks (New_Length / Chunk_Size) (New_Length mod Chunk_Size)
+          .Mark;
+      Container.Length := New_Length;
+   end Set_Last;
+
+end Chunked_Tables;
@@ -0,0 +1,116 @@
+------------------------------------------------------------------------------
+--                                                                          --
+--                            GNAT2WHY COMPONENTS                           --
+--                                                                          --
+--                        D E N S E _ B I T S E T S                         --
+--                                                                          --
+--                                 B o d y                                  --
+--                                                                          --
+--                       Copyright (C) 2026, AdaCore                        --
+--                                                                          --
+-- gnat2why is  free  software;  you can redistribute  it and/or  modify it --
+-- under terms of the  GNU General Public License as published  by the Free --
+-- Software  Foundation;  either version 3,  or (at your option)  any later --
+-- version.  gnat2why is distributed  in the hope that  it will be  useful, --
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- --
+-- TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public --
+-- License for  more details.  You should have  received  a copy of the GNU --
+-- General  Public License  distributed with  gnat2why;  see file COPYING3. --
+-- If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the --
+-- license.                                                                 --
+--                                                                          --
+-- gnat2why is maintained by AdaCore (http://www.adacore.com)               --
+--                                                                          --
+------------------------------------------------------------------------------
+
+package body Dense_Bitsets is
+
+   use type Interfaces.Unsigned_64;
+
+   function Bit (Element : Natural) return Word
+   is (Interfaces.Shift_Left (1, Element mod Word_Size))
+   with Inline;
+   --  Returns the mask of Element within its word
+
+   --------------
+   -- Contains --
+   --------------
+
+   function Contains (S : Bitset; Element : Natural) return Boolean is
+     ((S.Words (Element / Word_Size) and Bit (Element)) /= 0);
+
+   ---------------
+   -- Empty_Set --
+   ---------------
+
+   function Empty_Set (Last : Natural) return Bitset is
+     (Bitset'(Last_Word => Last / Word_Size, Words => <>));
+
+   -------------
+   -- Exclude --
+   -------------
+
+   procedure Exclude (S : in out Bitset; Element : Natural) is
+      W : Word renames S.Words (Element / Word_Size);
+   begin
+      W := W and not Bit (Element);
+   end Exclude;
+
+   -------------
+   -- Include --
+   -------------
+
+   procedure Include (S : in out Bitset; Element : Natural) is
+      W : Word renames S.Words (Element / Word_Size);
+   begin
+      W := W or Bit (Element);
+   end Include;
+
+   ---------------
+   -- Is_Subset --
+   ---------------
+
+   function Is_Subset (Subset : Bitset; Of_Set : Bitset) return Boolean is
+   begin
+      for J in Subset.Words'Range loop
+         if (Subset.Words (J) and not Of_Set.Words (J)) /= 0 then
+            return False;
+         end if;
+      end loop;
+      return True;
+   end Is_Subset;
+
+   -------------
+   -- Iterate --
+   -------------
+
+   procedure Iterate (S : Bitset) is
+   begin
+      for J in S.Words'Range loop
+         declare
+            W       : Word := S.Words (J);
+            Element : Natural := J * Word_Size;
+         begin
+            while W /= 0 loop
+               if (W and 1) /= 0 then
+                  Process (Element);
+               end if;
+               W := Interfaces.Shift_Right (W, 1);
+               Element := Element + 1;
+            end loop;
+         end;
+      end loop;
+   end Iterate;
+
+   -----------
+   -- Union --
+   -----------
+
+   procedure Union (Target : in out Bitset; Source : Bitset) is
+   begin
+      for J in Target.Words'Range loop
+         Target.Words (J) := Target.Words (J) or Source.Words (J);
+      end loop;
+   end Union;
+
+end Dense_Bitsets;
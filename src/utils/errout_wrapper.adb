@@ -3,6 +3,7 @@
 with Atree;                   use Atree;
 with Einfo.Utils;             use Einfo.Utils;
 with Erroutc;
+with Flow_Journal;
 with Gnat2Why_Args;
 with Gnat2Why_Opts;           use Gnat2Why_Opts;
 with Sinfo.Nodes;             use Sinfo.Nodes;
@@ -399,6 +400,7 @@ procedure Span_Locate (Msg : String; First_Node : Node_Id) is
          --  This should only be done for flow/proof messages, and currently
          --  the Error_Msg procedure is only called by the proof machinery.
 
+         Flow_Journal.Record_Errout_Msg (Msg & "!!", Span);
          Errout.Error_Msg (Msg & "!!", Span);
       end Span_Locate;
 
@@ -444,6 +446,7 @@ procedure Node_Locate (Msg : String; First_Node : Node_Id);
 
       procedure Node_Locate (Msg : String; First_Node : Node_Id) is
       begin
+         Flow_Journal.Record_Errout_Msg (Msg, N, First_Node, First);
          if First then
             Errout.Error_Msg_FE (Msg, N, First_Node);
          else
@@ -595,6 +598,15 @@ function Node_To_Name (N : Node_Id) return String is
       end case;
    end Node_To_Name;
 
+   ----------------------
+   -- Skip_Message_Ids --
+   ----------------------
+
+   procedure Skip_Message_Ids (Id : Message_Id) is
+   begin
+      Message_Id_Counter := Message_Id'Max (@, Id);
+   end Skip_Message_Ids;
+
    ----------------
    -- Tag_Suffix --
    ----------------
@@ -740,6 +752,7 @@ function Is_Entity_And_Has_Warnings_Off (F : Flow_Id) return Boolean
 
    begin
       if Suppr_Reason = No_String then
+         Flow_Journal.Record_Warnings_Use (Sloc (N), Msg);
          Suppr_Reason :=
            Erroutc.Warning_Specifically_Suppressed
              (Loc => Sloc (N), Msg => Msg'Unrestricted_Access);
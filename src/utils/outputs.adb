@@ -23,24 +23,63 @@
 --                                                                          --
 ------------------------------------------------------------------------------
 
+with GNAT.OS_Lib; use GNAT.OS_Lib;
+
 package body Outputs is
 
+   Buffer_Size : constant := 2 ** 20;
+
+   Buffer : String (1 .. Buffer_Size);
+   --  Output to the current file which is not yet written to the file
+
+   Buffer_Last : Natural := 0;
+   --  Index of the last character in Buffer
+
+   File : File_Descriptor := Invalid_FD;
+   --  Descriptor of the current file, if open
+
+   procedure Flush;
+   --  Write the contents of Buffer to the current file and empty it
+
    procedure I (O : Output_Id);
    --  If a new line has just been created, print as many spaces
    --  as the indentation level requires.
 
+   procedure Put (O : Output_Id; C : Character);
+   procedure Put (O : Output_Id; S : String);
+   --  Write C or S to output O
+
+   procedure Write (S : String);
+   --  Write S to the current file
+
    ------------------------
    -- Close_Current_File --
    ------------------------
 
    procedure Close_Current_File is
+      Success : Boolean;
    begin
-      pragma Assert (Is_Open (Output_Handles (Current_File)));
-      Close (Output_Handles (Current_File));
+      pragma Assert (File /= Invalid_FD);
+      Flush;
+      Close (File, Success);
+      if not Success then
+         raise Program_Error with "can't close output file";
+      end if;
+      File := Invalid_FD;
       Output_States (Current_File).Indent := 0;
       Output_States (Current_File).New_Line := False;
    end Close_Current_File;
 
+   -----------
+   -- Flush --
+   -----------
+
+   procedure Flush is
+   begin
+      Write (Buffer (1 .. Buffer_Last));
+      Buffer_Last := 0;
+   end Flush;
+
    -------
    -- I --
    -------
@@ -48,8 +87,7 @@ procedure Close_Current_File is
    procedure I (O : Output_Id) is
    begin
       if Output_States (O).New_Line then
-         Put
-           (Output_Handles (O), String'(1 .. Output_States (O).Indent => ' '));
+         Put (O, String'(1 .. Output_States (O).Indent => ' '));
          Output_States (O).New_Line := False;
       end if;
    end I;
@@ -60,7 +98,11 @@ procedure I (O : Output_Id) is
 
    procedure NL (O : Output_Id) is
    begin
-      New_Line (Output_Handles (O));
+      if O = Current_File then
+         Put (O, ASCII.LF);
+      else
+         New_Line (Output_Handles (O));
+      end if;
       Output_States (O).New_Line := True;
    end NL;
 
@@ -70,10 +112,13 @@ procedure NL (O : Output_Id) is
 
    procedure Open_Current_File (Filename : String) is
    begin
-      pragma Assert (not Is_Open (Output_Handles (Current_File)));
+      pragma Assert (File = Invalid_FD);
       pragma Assert (Output_States (Current_File).Indent = 0);
       pragma Assert (Output_States (Current_File).New_Line = False);
-      Create (Output_Handles (Current_File), Out_File, Filename);
+      File := Create_File (Filename, Fmode => Text);
+      if File = Invalid_FD then
+         raise Program_Error with "can't create output file " & Filename;
+      end if;
    end Open_Current_File;
 
    -------
@@ -82,7 +127,7 @@ procedure Open_Current_File (Filename : String) is
 
    procedure P (O : Output_Id; C : Character) is
    begin
-      Put (Output_Handles (O), C);
+      Put (O, C);
    end P;
 
    procedure P (O : Output_Id; S : String; As_String : Boolean := False) is
@@ -90,32 +135,19 @@ procedure P (O : Output_Id; S : String; As_String : Boolean := False) is
       I (O);
       if As_String then
 
-         --  Prepare buffer for escaping each quote with a backslash and
-         --  enclosing the resulting string in quotes.
-
-         declare
-            Buffer : String (1 .. S'Length * 2 + 2);
-            Cursor : Positive := 1;
-         begin
-            Buffer (Cursor) := '"';
-            Cursor := Cursor + 1;
-
-            for C of S loop
-               if C = '"' then
-                  Buffer (Cursor) := '\';
-                  Cursor := Cursor + 1;
-               end if;
-               Buffer (Cursor) := C;
-               Cursor := Cursor + 1;
-            end loop;
-
-            Buffer (Cursor) := '"';
-            --  No need to advance cursor for the last character
-
-            Put (Output_Handles (O), Buffer (1 .. Cursor));
-         end;
+         --  Escape each quote with a backslash and enclose the resulting
+         --  string in quotes.
+
+         Put (O, '"');
+         for C of S loop
+            if C = '"' then
+               Put (O, '\');
+            end if;
+            Put (O, C);
+         end loop;
+         Put (O, '"');
       else
-         Put (Output_Handles (O), S);
+         Put (O, S);
       end if;
    end P;
 
@@ -126,10 +158,53 @@ procedure P (O : Output_Id; S : String; As_String : Boolean := False) is
    procedure PL (O : Output_Id; S : String) is
    begin
       I (O);
-      Put_Line (Output_Handles (O), S);
+      if O = Current_File then
+         Put (O, S);
+         Put (O, ASCII.LF);
+      else
+         Put_Line (Output_Handles (O), S);
+      end if;
       Output_States (O).New_Line := True;
    end PL;
 
+   ---------
+   -- Put --
+   ---------
+
+   procedure Put (O : Output_Id; C : Character) is
+   begin
+      if O = Current_File then
+         if Buffer_Last = Buffer'Last then
+            Flush;
+         end if;
+         Buffer_Last := Buffer_Last + 1;
+         Buffer (Buffer_Last) := C;
+      else
+         Put (Output_Handles (O), C);
+      end if;
+   end Put;
+
+   procedure Put (O : Output_Id; S : String) is
+   begin
+      if O = Current_File then
+
+         --  Strings which do not fit in the remaining space are written
+         --  directly after the buffer if they would fill it anyway.
+
+         if S'Length > Buffer'Last - Buffer_Last then
+            Flush;
+            if S'Length >= Buffer'Length then
+               Write (S);
+               return;
+            end if;
+         end if;
+         Buffer (Buffer_Last + 1 .. Buffer_Last + S'Length) := S;
+         Buffer_Last := Buffer_Last + S'Length;
+      else
+         Put (Output_Handles (O), S);
+      end if;
+   end Put;
+
    ---------------------
    -- Relative_Indent --
    ---------------------
@@ -148,4 +223,17 @@ procedure Absolute_Indent (O : Output_Id; Level : Natural) is
       Output_States (O).Indent := Level;
    end Absolute_Indent;
 
+   -----------
+   -- Write --
+   -----------
+
+   procedure Write (S : String) is
+   begin
+      if S'Length > 0
+        and then Write (File, S'Address, S'Length) /= S'Length
+      then
+         raise Program_Error with "can't write output file";
+      end if;
+   end Write;
+
 end Outputs;
@@ -27,6 +27,7 @@
 with Ada.Containers;         use Ada.Containers;
 with Ada.Containers.Hashed_Maps;
 with Ada.Containers.Hashed_Sets;
+with Flow_Journal;
 with SPARK_Atree;            use SPARK_Atree;
 with SPARK_Atree.Entities;   use SPARK_Atree.Entities;
 with SPARK_Definition;       use SPARK_Definition;
@@ -107,7 +108,11 @@ function Get_Assume_JSON return GNATCOLL.JSON.JSON_Value is
    -- Register_Claim --
    --------------------
 
-   procedure Register_Claim (C : Claim) renames Claims.Include;
+   procedure Register_Claim (C : Claim) is
+   begin
+      Claims.Include (C);
+      Flow_Journal.Record_Claim (C);
+   end Register_Claim;
 
    -----------------------------------
    -- Register_Assumptions_For_Call --
@@ -0,0 +1,115 @@
+------------------------------------------------------------------------------
+--                                                                          --
+--                            GNAT2WHY COMPONENTS                           --
+--                                                                          --
+--                G N A T 2 W H Y - C A C H E _ B R O K E R                 --
+--                                                                          --
+--                                 B o d y                                  --
+--                                                                          --
+--                       Copyright (C) 2026, AdaCore                        --
+--                                                                          --
+-- gnat2why is  free  software;  you can redistribute  it and/or  modify it --
+-- under terms of the  GNU General Public License as published  by the Free --
+-- Software  Foundation;  either version 3,  or (at your option)  any later --
+-- version.  gnat2why is distributed  in the hope that  it will be  useful, --
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- --
+-- TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public --
+-- License for  more details.  You should have  received  a copy of the GNU --
+-- General  Public License  distributed with  gnat2why;  see file COPYING3. --
+-- If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the --
+-- license.                                                                 --
+--                                                                          --
+-- gnat2why is maintained by AdaCore (http://www.adacore.com)               --
+--                                                                          --
+------------------------------------------------------------------------------
+
+with Ada.Environment_Variables;
+with Interfaces.C;         use Interfaces.C;
+with Interfaces.C.Strings; use Interfaces.C.Strings;
+
+package body Gnat2Why.Cache_Broker is
+
+   Broker_Variable : constant String := "GNATPROVE_CACHE_BROKER";
+   --  Environment variable set by gnatprove to the name of the socket of the
+   --  broker
+
+   No_Connection : constant int := -1;
+
+   Connection : int := No_Connection;
+   --  File descriptor of the connection to the broker, if any
+
+   function Broker_Connect (Name : char_array) return int
+   with Import, Convention => C, External_Name => "gnat2why_broker_connect";
+   --  Connect to the broker listening on the Unix socket Name; return the
+   --  file descriptor of the connection, or -1 on error.
+
+   function Broker_Get
+     (Fd     : int;
+      Key    : char_array;
+      Value  : out chars_ptr;
+      Length : out size_t) return int
+   with Import, Convention => C, External_Name => "gnat2why_broker_get";
+   --  Send a get command for Key on connection Fd; return 1 on a hit, with
+   --  the value allocated in Value and Length, 0 on a miss and -1 on error.
+
+   procedure Broker_Free (Data : chars_ptr)
+   with Import, Convention => C, External_Name => "gnat2why_broker_free";
+   --  Free a value returned by Broker_Get
+
+   procedure Broker_Close (Fd : int)
+   with Import, Convention => C, External_Name => "gnat2why_broker_close";
+   --  Close connection Fd
+
+   ---------------
+   -- Available --
+   ---------------
+
+   function Available return Boolean
+   is (Ada.Environment_Variables.Value (Broker_Variable, "") /= "");
+
+   ---------
+   -- Get --
+   ---------
+
+   function Get (Key : String) return String is
+      Data   : chars_ptr;
+      Length : size_t;
+      Status : int;
+   begin
+      if Connection = No_Connection then
+         Connection :=
+           Broker_Connect
+             (To_C (Ada.Environment_Variables.Value (Broker_Variable)));
+
+         if Connection = No_Connection then
+            return "";
+         end if;
+      end if;
+
+      Status := Broker_Get (Connection, To_C (Key), Data, Length);
+
+      case Status is
+         when 1 =>
+            return Result : constant String :=
+              (if Length = 0
+               then ""
+               else Interfaces.C.Strings.Value (Data, Length))
+            do
+               Broker_Free (Data);
+            end return;
+
+         when 0 =>
+            return "";
+
+         when others =>
+
+            --  The state of the connection is unknown after an error, as
+            --  part of a reply may be left unread.
+
+            Broker_Close (Connection);
+            Connection := No_Connection;
+            return "";
+      end case;
+   end Get;
+
+end Gnat2Why.Cache_Broker;
@@ -25,6 +25,7 @@
 ------------------------------------------------------------------------------
 
 with Ada.Containers.Hashed_Maps;
+with Ada.Containers.Vectors;
 with Ada.Directories;
 with Ada.Environment_Variables;
 with Ada.Strings.Unbounded;          use Ada.Strings.Unbounded;
@@ -44,6 +45,7 @@
 with Einfo.Entities;                 use Einfo.Entities;
 with Einfo.Utils;                    use Einfo.Utils;
 with Errout_Wrapper;                 use Errout_Wrapper;
+with Filecache_Client;
 with Flow;                           use Flow;
 with Flow.Analysis.Assumptions;      use Flow.Analysis.Assumptions;
 with Flow_Generated_Globals.Phase_1;
@@ -57,12 +59,16 @@
 with GNAT.SHA1;
 with GNAT.Source_Info;
 with GNATCOLL.JSON;                  use GNATCOLL.JSON;
+with GNATCOLL.Symbols;               use GNATCOLL.Symbols;
 with GNATCOLL.Utils;                 use GNATCOLL.Utils;
 with Gnat2Why.Assumptions;           use Gnat2Why.Assumptions;
 with Gnat2Why.Borrow_Checker;        use Gnat2Why.Borrow_Checker;
+with Gnat2Why.Cache_Broker;
 with Gnat2Why.Data_Decomposition;    use Gnat2Why.Data_Decomposition;
 with Gnat2Why.Decls;                 use Gnat2Why.Decls;
 with Gnat2Why.Error_Messages;        use Gnat2Why.Error_Messages;
+with Gnat2Why.Proof_Costs;
+with Gnat2Why.Proof_Fingerprints;
 with Gnat2Why.Subprograms;           use Gnat2Why.Subprograms;
 with Gnat2Why.Tables;                use Gnat2Why.Tables;
 with Gnat2Why.Types;                 use Gnat2Why.Types;
@@ -75,6 +81,7 @@
 with Osint.C;                        use Osint.C;
 with Osint;                          use Osint;
 with Outputs;                        use Outputs;
+with Proof_Cache;
 with Sem;
 with Sem_Aux;                        use Sem_Aux;
 with Sem_Util;                       use Sem_Util;
@@ -96,12 +103,16 @@
 with VC_Kinds;                       use VC_Kinds;
 with Why;                            use Why;
 with Why.Atree;                      use Why.Atree;
+with Why.Atree.Accessors;            use Why.Atree.Accessors;
+with Why.Atree.Builders;
 with Why.Atree.Modules;              use Why.Atree.Modules;
 with Why.Atree.To_Json;              use Why.Atree.To_Json;
+with Why.Conversions;                use Why.Conversions;
 with Why.Gen.Binders;                use Why.Gen.Binders;
 with Why.Gen.Expr;                   use Why.Gen.Expr;
 with Why.Gen.Names;
 with Why.Inter;                      use Why.Inter;
+with Why.Ids;                        use Why.Ids;
 with Why.Images;                     use Why.Images;
 
 pragma Warnings (Off, "unit ""Why.Atree.Treepr"" is not referenced");
@@ -163,7 +174,13 @@ procedure Do_Ownership_Checking (Error_Found : out Boolean);
    --  Perform SPARK access legality checking
 
    procedure Print_GNAT_Json_File (Filename : String);
-   --  Print the GNAT AST as Json into file
+   --  Print the GNAT AST as Json into file. Only the theories of the current
+   --  entity are printed in the file. Each theory which they include is
+   --  printed once per unit in a shared theory file named after the digest
+   --  of its contents, and the file references exactly the shared theory
+   --  files it needs, together with their digest, so that the proof cache
+   --  key of the file accounts for them and does not depend on the other
+   --  entities of the unit.
 
    procedure Create_JSON_File
      (Progress : Analysis_Progress; Stop_Reason : Stop_Reason_Type);
@@ -196,17 +213,70 @@ function Process_Id_Hash (X : Process_Id) return Ada.Containers.Hash_Type
    is (Generic_Integer_Hash (Pid_To_Integer (X)));
    --  Hash function for process ids to be used in Hashed maps
 
+   type Gnatwhy3_Job is record
+      Output      : Path_Name_Type;
+      Entity      : Entity_Id;
+      Fingerprint : Unbounded_String;
+   end record;
+   --  A running gnatwhy3 process: Output is the temp file in which it stores
+   --  its output, Entity the entity whose proof it runs, and Fingerprint the
+   --  fingerprint of its proof job, as computed by Proof_Fingerprints.
+
    package Pid_Maps is new
      Ada.Containers.Hashed_Maps
        (Key_Type        => Process_Id,
-        Element_Type    => Path_Name_Type,
+        Element_Type    => Gnatwhy3_Job,
         Hash            => Process_Id_Hash,
-        Equivalent_Keys => "=",
-        "="             => "=");
+        Equivalent_Keys => "=");
 
    Output_File_Map : Pid_Maps.Map;
-   --  Global map which stores the temp file names in which the various
-   --  gnatwhy3 processes store their output, by process id.
+   --  Global map which stores the running gnatwhy3 processes, by process id
+
+   type Shared_Theory_File is record
+      Name   : Unbounded_String;
+      Digest : Unbounded_String;
+   end record;
+   --  A file holding a theory included by the theories of entities of the
+   --  current unit. Name is the file name as seen from gnatwhy3, and Digest
+   --  is the digest of its contents.
+
+   package Shared_Theory_File_Vectors is new
+     Ada.Containers.Vectors
+       (Index_Type   => Positive,
+        Element_Type => Shared_Theory_File);
+
+   package Symbol_To_Shared_File_Maps is new
+     Ada.Containers.Hashed_Maps
+       (Key_Type        => Symbol,
+        Element_Type    => Shared_Theory_File,
+        Hash            => GNATCOLL.Symbols.Hash,
+        Equivalent_Keys => "=");
+
+   Shared_Theories : Symbol_To_Shared_File_Maps.Map;
+   --  Map from the name of the theories printed in shared theory files to
+   --  their file.
+
+   Shared_Theory_Suffix : constant String := ".theory.gnat-json";
+
+   function Shared_Theory_File_Name (Digest : String) return String
+   is (Unit_Name & "-" & Digest & Shared_Theory_Suffix);
+   --  Name of the shared theory file of the current unit whose contents have
+   --  the given digest. The full names of entities contain no dot, so this
+   --  name does not clash with the files printed for entities.
+
+   procedure Print_Shared_Theory_File (Theory : Why_Node_Id);
+   --  Print Theory as Json into the shared theory file named after the
+   --  digest of its contents and register it in Shared_Theories.
+
+   procedure Delete_Stale_Shared_Theory_Files;
+   --  Delete the shared theory files of the current unit which were printed
+   --  by a previous run and not by this one. To be called once no gnatwhy3
+   --  process of the unit is running anymore.
+
+   function Path_From_Why3_Dir (Filename : String) return String;
+   --  Return the path of Filename relative to the directory in which
+   --  gnatwhy3 is run if it is located below it, and its absolute path
+   --  otherwise.
 
    procedure Collect_One_Result
    with Pre => not Output_File_Map.Is_Empty;
@@ -223,6 +293,33 @@ procedure Run_Gnatwhy3 (E : Entity_Id; Filename : String)
    --  After generating the Why file, run the proof tool. Wait for existing
    --  gnatwhy3 processes to finish if Max_Subprocesses is already reached.
 
+   function Lookup_Cached_Results
+     (Why3_Args : String_Lists.List; Output : out Path_Name_Type)
+      return Boolean;
+   --  If Why3_Args runs gnatwhy3 through spark_memcached_wrapper with a file
+   --  cache or with a memcached server accessed through the broker, look up
+   --  the cache for the output of gnatwhy3 with these arguments, the input
+   --  file being the last argument. If found, store it in a new temporary
+   --  file Output and return True, otherwise return False. The lookup is
+   --  done directly in gnat2why to avoid spawning processes on cache hits.
+   --  Other caches, i.e. a file cache combined with memcached servers, are
+   --  only accessed by the wrapper for now.
+
+   function Proof_Costs_File_Name return String
+   is (Ada.Directories.Compose (Name => Unit_Name, Extension => "cost"));
+   --  File in which the cost of proof of the entities of the current unit is
+   --  kept from one analysis to the next.
+
+   function Proof_Fingerprints_File_Name return String
+   is (Ada.Directories.Compose
+         (Name => Unit_Name, Extension => "fingerprints"));
+   --  File in which the output of gnatwhy3 for the entities of the current
+   --  unit is kept from one analysis to the next.
+
+   procedure Store_Output (Value : String; Output : out Path_Name_Type);
+   --  Store Value in a new temporary file Output, as if it had been output
+   --  by gnatwhy3.
+
    Max_Why3_Filename_Length : constant := 64;
    --  On windows, a path can be no longer than 250 or so chars. We allow a
    --  maximum of 64 (60 chars + 4 four the file extension) for the
@@ -248,9 +345,18 @@ procedure Collect_One_Result is
       Wait_Process (Pid, Success);
       pragma Assert (Pid /= Invalid_Pid);
       declare
-         Fn : constant String := Get_Name_String (Output_File_Map (Pid));
+         Job : constant Gnatwhy3_Job := Output_File_Map (Pid);
+         Fn  : constant String := Get_Name_String (Job.Output);
       begin
-         Parse_Why3_Results (Fn, Timing);
+         Parse_Why3_Results (Fn, Timing, From_Cache => False);
+
+         if Job.Fingerprint /= Null_Unbounded_String then
+            Proof_Fingerprints.Record_Output
+              (Job.Entity,
+               To_String (Job.Fingerprint),
+               Read_File_Into_String (Fn));
+         end if;
+
          Delete_File (Fn, Success);
          Output_File_Map.Delete (Pid);
       end;
@@ -371,6 +477,7 @@ procedure Create_JSON_File
       if Progress >= Progress_Proof then
          Set_Field (Full, "pragma_assume", Create (Get_Pragma_Assume_JSON));
          Set_Field (Full, "proof", Create (Proof_Msgs));
+         Set_Field (Full, "proof_cost", Proof_Costs.Proof_Cost_Summary);
       end if;
       Set_Field (Full, "assumptions", Get_Assume_JSON);
 
@@ -500,6 +607,69 @@ procedure Prescan_ALI_Files is
       Read_Withed_ALIs (Main_Lib_Id);
    end Prescan_ALI_Files;
 
+   --------------------------------------
+   -- Delete_Stale_Shared_Theory_Files --
+   --------------------------------------
+
+   procedure Delete_Stale_Shared_Theory_Files is
+      use Ada.Directories;
+
+      Prefix  : constant String := Unit_Name & "-";
+      Current : String_Sets.Set;
+      Search  : Search_Type;
+      Item    : Directory_Entry_Type;
+      Unused  : Boolean;
+
+      function Is_Shared_Theory_File (Name : String) return Boolean;
+      --  Return True if Name is the name of a shared theory file of the
+      --  current unit, i.e. if its part between Prefix and the suffix is a
+      --  digest. This excludes the files of child units, whose names start
+      --  with the same prefix.
+
+      ---------------------------
+      -- Is_Shared_Theory_File --
+      ---------------------------
+
+      function Is_Shared_Theory_File (Name : String) return Boolean is
+         First : constant Integer := Name'First + Prefix'Length;
+         Last  : constant Integer := Name'Last - Shared_Theory_Suffix'Length;
+      begin
+         return
+           First <= Last
+           and then (for all C of Name (First .. Last) =>
+                       C in '0' .. '9' | 'a' .. 'f');
+      end Is_Shared_Theory_File;
+
+      --  Start of processing for Delete_Stale_Shared_Theory_Files
+
+   begin
+      for Shared of Shared_Theories loop
+         Current.Include (Shared_Theory_File_Name (To_String (Shared.Digest)));
+      end loop;
+
+      Start_Search
+        (Search,
+         Directory => Current_Directory,
+         Pattern   => Prefix & "*" & Shared_Theory_Suffix,
+         Filter    => [Ordinary_File => True, others => False]);
+
+      while More_Entries (Search) loop
+         Get_Next_Entry (Search, Item);
+
+         declare
+            Name : constant String := Simple_Name (Item);
+         begin
+            if Is_Shared_Theory_File (Name)
+              and then not Current.Contains (Name)
+            then
+               Delete_File (Full_Name (Item), Unused);
+            end if;
+         end;
+      end loop;
+
+      End_Search (Search);
+   end Delete_Stale_Shared_Theory_Files;
+
    ---------------------
    -- Do_Generate_VCs --
    ---------------------
@@ -1008,9 +1178,18 @@ function Assertion (VC : VC_Kind) return String
             Timing_Phase_Completed
               (Timing, Null_Subp, "translation of standard");
 
+            Proof_Costs.Load_Proof_Costs (Proof_Costs_File_Name);
+            Proof_Fingerprints.Load_Fingerprints
+              (Proof_Fingerprints_File_Name);
+
             Translate_CUnit;
 
             Collect_Results;
+            Delete_Stale_Shared_Theory_Files;
+            Proof_Costs.Save_Proof_Costs (Proof_Costs_File_Name);
+            Proof_Fingerprints.Save_Fingerprints
+              (Proof_Fingerprints_File_Name);
+
             --  If the analysis is requested for a specific piece of code, we
             --  do not warn about useless pragma Annotate, because it's likely
             --  to be a false positive.
@@ -1197,20 +1376,232 @@ function Is_Translated_Subprogram (E : Entity_Id) return Boolean
 
        and then not Is_Hardcoded_Entity (E));
 
+   ---------------------------
+   -- Lookup_Cached_Results --
+   ---------------------------
+
+   function Lookup_Cached_Results
+     (Why3_Args : String_Lists.List; Output : out Path_Name_Type)
+      return Boolean
+   is
+      use String_Lists;
+      Position : String_Lists.Cursor := Why3_Args.First;
+   begin
+      Output := No_Path;
+
+      --  The arguments of the wrapper are the salt and the cache, followed by
+      --  the command and its arguments, the input file coming last.
+
+      while Has_Element (Position)
+        and then Element (Position) /= "spark_memcached_wrapper"
+      loop
+         Next (Position);
+      end loop;
+
+      if not Has_Element (Position) then
+         return False;
+      end if;
+
+      Next (Position);
+
+      declare
+         Salt    : constant String := Element (Position);
+         Info    : constant String := Element (Next (Position));
+         Command : String_Lists.List;
+      begin
+         Position := Next (Next (Position));
+         while Position /= Why3_Args.Last loop
+            Command.Append (Element (Position));
+            Next (Position);
+         end loop;
+
+         declare
+            Dir : constant String := Proof_Cache.File_Cache_Dir (Info);
+
+            function Lookup (Key : String) return String;
+            --  @return the value cached for Key, or the empty string if there
+            --    is none
+
+            ------------
+            -- Lookup --
+            ------------
+
+            function Lookup (Key : String) return String is
+            begin
+               if Dir /= "" then
+                  declare
+                     Cache : Filecache_Client.Filecache :=
+                       Filecache_Client.Init (Dir);
+                     Value : constant String := Cache.Get (Key);
+                  begin
+                     Cache.Close;
+                     return Value;
+                  end;
+               else
+                  return Cache_Broker.Get (Key);
+               end if;
+            end Lookup;
+
+         begin
+            if Dir = "" and then not Cache_Broker.Available then
+               return False;
+            end if;
+
+            declare
+               Value : constant String :=
+                 Lookup
+                   (Proof_Cache.Compute_Key
+                      (Salt, Command, Why3_Args.Last_Element));
+            begin
+               if Value = "" then
+                  return False;
+               end if;
+
+               Store_Output (Value, Output);
+               return True;
+            end;
+         end;
+      end;
+   end Lookup_Cached_Results;
+
+   ------------------------
+   -- Path_From_Why3_Dir --
+   ------------------------
+
+   function Path_From_Why3_Dir (Filename : String) return String is
+      Dir  : constant String :=
+        (if Gnat2Why_Args.Why3_Dir = Null_Unbounded_String
+         then ""
+         else
+           Normalize_Pathname
+             (To_String (Gnat2Why_Args.Why3_Dir), Resolve_Links => False));
+      Path : constant String :=
+        Normalize_Pathname (Filename, Resolve_Links => False);
+      Last : constant Natural := Path'First + Dir'Length;
+   begin
+      if Dir /= ""
+        and then Path'Length > Dir'Length + 1
+        and then Path (Path'First .. Last - 1) = Dir
+        and then Is_Directory_Separator (Path (Last))
+      then
+         return Path (Last + 1 .. Path'Last);
+      else
+         return Path;
+      end if;
+   end Path_From_Why3_Dir;
+
    --------------------------
    -- Print_GNAT_Json_File --
    --------------------------
 
    procedure Print_GNAT_Json_File (Filename : String) is
       Modules : constant Why_Node_Lists.List := Build_Printing_Plan;
+      Main    : Symbol_Set;
+      --  Names of the theories of the current entity
+
+      Own     : Why_Node_Lists.List;
+      --  Theories of the current entity, printed in Filename
+
+      Used    : Shared_Theory_File_Vectors.Vector;
+      --  Shared theory files needed by the theories of the current entity,
+      --  in the order of the printing plan, so that a theory always comes
+      --  after the theories that it includes.
+
+      Files   : JSON_Array;
+
    begin
+      for Th of Why_Sections (WF_Main) loop
+         declare
+            Decl : constant W_Theory_Declaration_Id := +Th;
+         begin
+            Main.Insert (Get_Name (Decl));
+         end;
+      end loop;
+
+      --  Split the printing plan between the theories of the entity and the
+      --  included ones, which are printed in shared theory files if not
+      --  already done for a previous entity. The order of the plan is
+      --  preserved in each part.
+
+      for M of Modules loop
+         declare
+            Decl : constant W_Theory_Declaration_Id := +M;
+            Name : constant Symbol := Get_Name (Decl);
+         begin
+            if Main.Contains (Name) then
+               Own.Append (M);
+            else
+               if not Shared_Theories.Contains (Name) then
+                  Print_Shared_Theory_File (M);
+               end if;
+               Used.Append (Shared_Theories (Name));
+            end if;
+         end;
+      end loop;
+
       Open_Current_File (Filename);
-      P (Current_File, "{ ""theory_declarations"" : ");
-      Why_Node_Lists_List_To_Json (Current_File, Modules);
+      Reset_Node_Counter;
+
+      for Shared of Used loop
+         declare
+            File : constant JSON_Value := Create_Object;
+         begin
+            Set_Field (File, "file", Shared.Name);
+            Set_Field (File, "digest", Shared.Digest);
+            Append (Files, File);
+         end;
+      end loop;
+
+      P (Current_File, "{ ""common_theories"" : ");
+      P (Current_File, Write (Create (Files)));
+      P (Current_File, ", ""theory_declarations"" : ");
+      Why_Node_Lists_List_To_Json (Current_File, Own);
       P (Current_File, "}");
       Close_Current_File;
    end Print_GNAT_Json_File;
 
+   ------------------------------
+   -- Print_Shared_Theory_File --
+   ------------------------------
+
+   procedure Print_Shared_Theory_File (Theory : Why_Node_Id) is
+      Decl     : constant W_Theory_Declaration_Id := +Theory;
+      Tmp_Name : constant String := Unit_Name & Shared_Theory_Suffix;
+      Theories : Why_Node_Lists.List;
+      Unused   : Boolean;
+   begin
+      --  The theory is printed into a temporary file first, as the name of
+      --  its file depends on its contents.
+
+      Theories.Append (Theory);
+      Open_Current_File (Tmp_Name);
+      Reset_Node_Counter;
+      P (Current_File, "{ ""theory_declarations"" : ");
+      Why_Node_Lists_List_To_Json (Current_File, Theories);
+      P (Current_File, "}");
+
+      Close_Current_File;
+
+      declare
+         Digest   : constant String := Proof_Cache.File_Digest (Tmp_Name);
+         Filename : constant String := Shared_Theory_File_Name (Digest);
+      begin
+         --  A file with the same name has the same contents, typically from
+         --  a previous run, in which case it is kept.
+
+         if Is_Regular_File (Filename) then
+            Delete_File (Tmp_Name, Unused);
+         else
+            Rename_File (Tmp_Name, Filename, Unused);
+         end if;
+
+         Shared_Theories.Insert
+           (Get_Name (Decl),
+            (Name   => To_Unbounded_String (Path_From_Why3_Dir (Filename)),
+             Digest => To_Unbounded_String (Digest)));
+      end;
+   end Print_Shared_Theory_File;
+
    ------------------
    -- Run_Gnatwhy3 --
    ------------------
@@ -1223,6 +1614,35 @@ procedure Run_Gnatwhy3 (E : Entity_Id; Filename : String) is
       Why3_Args : String_Lists.List := Gnat2Why_Args.Why3_Args;
       Command   : GNAT.OS_Lib.String_Access :=
         GNAT.OS_Lib.Locate_Exec_On_Path (Why3_Args.First_Element);
+      Cached    : Path_Name_Type;
+
+      Fingerprint : Unbounded_String;
+      --  Fingerprint of the proof job for E
+
+      procedure Process_Cached_Output;
+      --  Process the output of gnatwhy3 for E stored in file Cached instead
+      --  of running gnatwhy3, and record it for the next analysis.
+
+      ---------------------------
+      -- Process_Cached_Output --
+      ---------------------------
+
+      procedure Process_Cached_Output is
+         Cached_Fn : constant String := Get_Name_String (Cached);
+         Unused    : Boolean;
+      begin
+         Parse_Why3_Results (Cached_Fn, Timing, From_Cache => True);
+
+         if Fingerprint /= Null_Unbounded_String then
+            Proof_Fingerprints.Record_Output
+              (E, To_String (Fingerprint), Read_File_Into_String (Cached_Fn));
+         end if;
+
+         Delete_File (Cached_Fn, Unused);
+      end Process_Cached_Output;
+
+      --  Start of processing for Run_Gnatwhy3
+
    begin
       --  Exit gently if gnat2why3 can't be located, for whatever reason,
       --  e.g. when the PATH is wrong in developer setup.
@@ -1231,16 +1651,6 @@ procedure Run_Gnatwhy3 (E : Entity_Id; Filename : String) is
          raise Program_Error with "can't locate gnatwhy3";
       end if;
 
-      --  If the maximum is reached, or we are not allowed to run gnatwhy3 in
-      --  parallel, we wait for one process to finish first.
-
-      if Output_File_Map.Length = Max_Subprocesses
-        or else (not Output_File_Map.Is_Empty
-                 and then not Gnat2Why_Args.Parallel_Why3)
-      then
-         Collect_One_Result;
-      end if;
-
       Why3_Args.Append ("--entity");
       Why3_Args.Append (Img (E));
       --  Modifying the command line and printing it for debug purposes. We
@@ -1250,6 +1660,50 @@ procedure Run_Gnatwhy3 (E : Entity_Id; Filename : String) is
 
       Why3_Args.Append (Fn);
 
+      --  If the proof job for E is the same as in the previous analysis of
+      --  the unit, reuse the output of gnatwhy3 from that analysis.
+
+      Fingerprint :=
+        To_Unbounded_String
+          (Proof_Fingerprints.Compute_Fingerprint (Why3_Args));
+
+      declare
+         Previous : constant String :=
+           Proof_Fingerprints.Previous_Output (E, To_String (Fingerprint));
+      begin
+         if Previous /= "" then
+            Free (Command);
+            Store_Output (Previous, Cached);
+            Process_Cached_Output;
+            return;
+         end if;
+      end;
+
+      --  Pass an estimate of the cost of the proof job to the wrapper which
+      --  waits for its turn to run gnatwhy3, so that expensive jobs can be
+      --  started first.
+
+      if Why3_Args.First_Element = "spark_semaphore_wrapper" then
+         Why3_Args.Insert
+           (Before   => String_Lists.Next (Why3_Args.First),
+            New_Item =>
+              "--cost="
+              & GNATCOLL.Utils.Image
+                  (Proof_Costs.Estimated_Cost (E, Fn), Min_Width => 1));
+      end if;
+
+      Set_Directory (To_String (Gnat2Why_Args.Why3_Dir));
+
+      --  If the results of gnatwhy3 for this entity are already cached, there
+      --  is no need to spawn it, nor the wrapper which caches its results.
+
+      if Lookup_Cached_Results (Why3_Args, Cached) then
+         Set_Directory (Old_Dir);
+         Free (Command);
+         Process_Cached_Output;
+         return;
+      end if;
+
       if Gnat2Why_Args.Debug_Mode then
          for Elt of Why3_Args loop
             Ada.Text_IO.Put (Elt);
@@ -1260,7 +1714,15 @@ procedure Run_Gnatwhy3 (E : Entity_Id; Filename : String) is
 
       Why3_Args.Delete_First (1);
 
-      Set_Directory (To_String (Gnat2Why_Args.Why3_Dir));
+      --  If the maximum is reached, or we are not allowed to run gnatwhy3 in
+      --  parallel, we wait for one process to finish first.
+
+      if Output_File_Map.Length = Max_Subprocesses
+        or else (not Output_File_Map.Is_Empty
+                 and then not Gnat2Why_Args.Parallel_Why3)
+      then
+         Collect_One_Result;
+      end if;
 
       --  We need to capture stderr of gnatwhy3 output in case of Out_Of_Memory
       --  messages.
@@ -1287,7 +1749,11 @@ procedure Run_Gnatwhy3 (E : Entity_Id; Filename : String) is
             raise Program_Error with "can't spawn gnatwhy3";
          end if;
 
-         Output_File_Map.Insert (Pid, Name);
+         Output_File_Map.Insert
+           (Pid,
+            (Output      => Name,
+             Entity      => E,
+             Fingerprint => Fingerprint));
          Close (Fd);
 
          for Arg of Args loop
@@ -1298,6 +1764,21 @@ procedure Run_Gnatwhy3 (E : Entity_Id; Filename : String) is
       Free (Command);
    end Run_Gnatwhy3;
 
+   ------------------
+   -- Store_Output --
+   ------------------
+
+   procedure Store_Output (Value : String; Output : out Path_Name_Type) is
+      Fd : File_Descriptor;
+   begin
+      Create_Temp_File (Fd, Output);
+      pragma Assert (Fd /= Invalid_FD);
+      if Write (Fd, Value'Address, Value'Length) /= Value'Length then
+         raise Program_Error with "can't write cached gnatwhy3 results";
+      end if;
+      Close (Fd);
+   end Store_Output;
+
    ---------------------
    -- Translate_CUnit --
    ---------------------
@@ -1449,6 +1930,7 @@ procedure Register_Symbol (E : Entity_Id) is
       Translated_Object_Names.Reserve_Capacity (0);
 
       Why.Gen.Names.Free;
+      Why.Atree.Builders.Free;
       Why.Atree.Free;
    end Translate_CUnit;
 
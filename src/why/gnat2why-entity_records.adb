@@ -0,0 +1,134 @@
+------------------------------------------------------------------------------
+--                                                                          --
+--                            GNAT2WHY COMPONENTS                           --
+--                                                                          --
+--              G N A T 2 W H Y - E N T I T Y _ R E C O R D S               --
+--                                                                          --
+--                                 B o d y                                  --
+--                                                                          --
+--                       Copyright (C) 2026, AdaCore                        --
+--                                                                          --
+-- gnat2why is  free  software;  you can redistribute  it and/or  modify it --
+-- under terms of the  GNU General Public License as published  by the Free --
+-- Software  Foundation;  either version 3,  or (at your option)  any later --
+-- version.  gnat2why is distributed  in the hope that  it will be  useful, --
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- --
+-- TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public --
+-- License for  more details.  You should have  received  a copy of the GNU --
+-- General  Public License  distributed with  gnat2why;  see file COPYING3. --
+-- If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the --
+-- license.                                                                 --
+--                                                                          --
+-- gnat2why is maintained by AdaCore (http://www.adacore.com)               --
+--                                                                          --
+------------------------------------------------------------------------------
+
+with Ada.Directories;
+with Ada.Text_IO;
+with GNAT.OS_Lib;
+with SPARK_Definition; use SPARK_Definition;
+with SPARK_Util;       use SPARK_Util;
+
+package body Gnat2Why.Entity_Records is
+
+   -------------------
+   -- Find_Previous --
+   -------------------
+
+   function Find_Previous (E : Entity_Id) return Entity_Maps.Cursor is
+     (Previous.Find (Full_Name (E)));
+
+   ----------
+   -- Load --
+   ----------
+
+   procedure Load (File_Name : String) is
+
+      procedure Load_Entity (Name : UTF8_String; Value : JSON_Value);
+      --  Read the information recorded for entity Name
+
+      -----------------
+      -- Load_Entity --
+      -----------------
+
+      procedure Load_Entity (Name : UTF8_String; Value : JSON_Value) is
+      begin
+         Previous.Include (Name, From_JSON (Value));
+      end Load_Entity;
+
+      R : Read_Result;
+
+      --  Start of processing for Load
+
+   begin
+      Previous.Clear;
+
+      if not Ada.Directories.Exists (File_Name) then
+         return;
+      end if;
+
+      R := Read_File (File_Name);
+
+      if R.Success and then Kind (R.Value) = JSON_Object_Type then
+         Map_JSON_Object (R.Value, Load_Entity'Access);
+      end if;
+
+   exception
+      --  The information is only a hint for the next analysis, so an
+      --  ill-formed file is simply ignored.
+
+      when Constraint_Error =>
+         Previous.Clear;
+   end Load;
+
+   --------------------
+   -- Record_Current --
+   --------------------
+
+   procedure Record_Current (E : Entity_Id; Element : Element_Type) is
+   begin
+      Current.Include (Full_Name (E), Element);
+   end Record_Current;
+
+   ----------
+   -- Save --
+   ----------
+
+   procedure Save (File_Name : String) is
+      Elements : Entity_Maps.Map := Current;
+      Full     : constant JSON_Value := Create_Object;
+      FD       : Ada.Text_IO.File_Type;
+      Unused   : Boolean;
+   begin
+      --  Only entities which are still marked are considered, so that the
+      --  information about deleted or renamed entities is dropped.
+
+      for E of Entities_To_Translate loop
+         declare
+            Position : constant Entity_Maps.Cursor := Find_Previous (E);
+         begin
+            if Entity_Maps.Has_Element (Position)
+              and then not Elements.Contains (Entity_Maps.Key (Position))
+            then
+               Elements.Insert
+                 (Entity_Maps.Key (Position), Entity_Maps.Element (Position));
+            end if;
+         end;
+      end loop;
+
+      if Elements.Is_Empty then
+         GNAT.OS_Lib.Delete_File (File_Name, Unused);
+         return;
+      end if;
+
+      for C in Elements.Iterate loop
+         Set_Field
+           (Full, Entity_Maps.Key (C), To_JSON (Entity_Maps.Element (C)));
+      end loop;
+
+      Ada.Text_IO.Create (FD, Ada.Text_IO.Out_File, File_Name);
+      Ada.Text_IO.Put (FD, Write (Full));
+      Ada.Text_IO.Close (FD);
+   end Save;
+
+end Gnat2Why.Entity_Records;
@@ -48,6 +48,7 @@
 with Flow_Utility;           use Flow_Utility;
 with Gnat2Why.Assumptions;   use Gnat2Why.Assumptions;
 with Gnat2Why.Driver;        use Gnat2Why.Driver;
+with Gnat2Why.Proof_Costs;
 with Gnat2Why.Util;          use Gnat2Why.Util;
 with Gnat2Why_Args;          use Gnat2Why_Args;
 with Gnat2Why_Opts.Reading;
@@ -536,7 +537,9 @@ function Parse_Extra_Info (EI : Prover_Extra_Info) return Extra_Info is
    -- Parse_Why3_Results --
    ------------------------
 
-   procedure Parse_Why3_Results (Fn : String; Timing : in out Time_Token) is
+   procedure Parse_Why3_Results
+     (Fn : String; Timing : in out Time_Token; From_Cache : Boolean)
+   is
 
       --  See the file gnat_report.mli for a description of the format that we
       --  parse here.
@@ -545,6 +548,9 @@ procedure Parse_Why3_Results (Fn : String; Timing : in out Time_Token) is
 
       Subp : Entity_Id;
 
+      Job_Time : Duration := 0.0;
+      --  Total time spent by gnatwhy3, according to its timings
+
       type Cntexample_Info is record
          Cntexample        : Cntexample_File_Maps.Map;
          Giant_Step_Result : CE_RAC.Result;
@@ -584,6 +590,24 @@ procedure Handle_Error (Msg : String; Internal : Boolean)
       with No_Return;
       procedure Handle_Timings (V : JSON_Value);
 
+      procedure Handle_File (File : JSON_Value);
+      --  Handle the fields of the result file other than the results, which
+      --  are handled afterwards one at a time.
+
+      procedure Handle_Streamed_Result (V : JSON_Value);
+      --  Handle a single result entry and add its prover statistics to
+      --  Totals.
+
+      Totals : Prover_Stat_Maps.Map;
+      --  For each prover, the sum of its statistics over all VCs
+
+      Warnings : JSON_Array := Empty_Array;
+      --  Warnings issued by gnatwhy3, printed after the results
+
+      procedure Record_Cost;
+      --  Record the cost of the proof of Subp, based on the timings of
+      --  gnatwhy3 if any, and on the statistics of provers in Totals.
+
       ----------------------------
       -- Parse_Cntexamples_List --
       ----------------------------
@@ -644,6 +668,36 @@ procedure Handle_Error (Msg : String; Internal : Boolean) is
          end if;
       end Handle_Error;
 
+      -----------------
+      -- Handle_File --
+      -----------------
+
+      procedure Handle_File (File : JSON_Value) is
+      begin
+         if Has_Field (File, "error") then
+            declare
+               Msg      : constant String := Get (Get (File, "error"));
+               Internal : constant Boolean :=
+                 Has_Field (File, "internal")
+                 and then Get (Get (File, "internal"));
+            begin
+               Handle_Error (Msg, Internal);
+            end;
+         end if;
+         Subp := Entity_Id (Integer'(Get (File, "entity")));
+         if Has_Field (File, "timings") then
+            Handle_Timings (Get (File, "timings"));
+         end if;
+
+         --  Try to retreive input values from gnattest if they exist
+
+         Parse_Gnattest_Values (Subp);
+
+         if Has_Field (File, "warnings") then
+            Warnings := Get (Get (File, "warnings"));
+         end if;
+      end Handle_File;
+
       -------------------
       -- Handle_Result --
       -------------------
@@ -1128,6 +1182,43 @@ function Is_Subprogram_Body (X : Node_Id) return Boolean
          Free (Fuel);
       end Handle_Result;
 
+      ----------------------------
+      -- Handle_Streamed_Result --
+      ----------------------------
+
+      procedure Handle_Streamed_Result (V : JSON_Value) is
+      begin
+         Handle_Result (V);
+
+         if Has_Field (V, "stats") then
+            declare
+               Stats : constant Prover_Stat_Maps.Map :=
+                 From_JSON (Get (V, "stats"));
+            begin
+               for C in Stats.Iterate loop
+                  declare
+                     Stat            : constant Prover_Stat :=
+                       Prover_Stat_Maps.Element (C);
+                     Position        : Prover_Stat_Maps.Cursor;
+                     Unused_Inserted : Boolean;
+                  begin
+                     Totals.Insert
+                       (Prover_Stat_Maps.Key (C),
+                        (Count => 0, Max_Steps => 0, Max_Time => 0.0),
+                        Position,
+                        Unused_Inserted);
+                     Totals (Position).Count :=
+                       Totals (Position).Count + Stat.Count;
+                     Totals (Position).Max_Steps :=
+                       Totals (Position).Max_Steps + Stat.Max_Steps;
+                     Totals (Position).Max_Time :=
+                       Totals (Position).Max_Time + Stat.Max_Time;
+                  end;
+               end loop;
+            end;
+         end if;
+      end Handle_Streamed_Result;
+
       --------------------
       -- Handle_Timings --
       --------------------
@@ -1142,6 +1233,7 @@ procedure Timing_Entry (Name : UTF8_String; Value : JSON_Value);
          procedure Timing_Entry (Name : UTF8_String; Value : JSON_Value) is
             Time : constant Float := Get (Value);
          begin
+            Job_Time := Job_Time + Duration (Time);
             Register_Timing
               (Timing,
                Entity_To_Subp_Assumption (Subp),
@@ -1255,50 +1347,57 @@ function Parse_Why3_Prove_Result
                  else Create_Object));
       end Parse_Why3_Prove_Result;
 
+      -----------------
+      -- Record_Cost --
+      -----------------
+
+      procedure Record_Cost is
+         Steps       : Natural := 0;
+         Prover_Time : Float := 0.0;
+         Max_Prover  : Unbounded_String;
+         Max_Time    : Float := 0.0;
+      begin
+         for C in Totals.Iterate loop
+            Steps := Steps + Totals (C).Max_Steps;
+            Prover_Time := Prover_Time + Totals (C).Max_Time;
+            if Totals (C).Max_Time >= Max_Time then
+               Max_Time := Totals (C).Max_Time;
+               Max_Prover := To_Unbounded_String (Prover_Stat_Maps.Key (C));
+            end if;
+         end loop;
+
+         Proof_Costs.Record_Proof_Cost
+           (Subp,
+            Time   =>
+              (if Job_Time > 0.0 then Job_Time else Duration (Prover_Time)),
+            Steps  => Steps,
+            Prover => To_String (Max_Prover));
+      end Record_Cost;
+
       --  Start of processing for Parse_Why3_Results
 
    begin
       Mark_Subprograms_With_No_VC_As_Proved;
 
-      declare
-         File    : constant JSON_Value := Read_File_Into_JSON (Fn);
-         Results : constant JSON_Array := Get (Get (File, "results"));
-      begin
-         if Has_Field (File, "error") then
-            declare
-               Msg      : constant String := Get (Get (File, "error"));
-               Internal : constant Boolean :=
-                 Has_Field (File, "internal")
-                 and then Get (Get (File, "internal"));
-            begin
-               Handle_Error (Msg, Internal);
-            end;
-         end if;
-         Subp := Entity_Id (Integer'(Get (File, "entity")));
-         if Has_Field (File, "timings") then
-            Handle_Timings (Get (File, "timings"));
-         end if;
+      --  The results are parsed and handled one at a time, so that the
+      --  counterexamples of all results are never in memory together.
 
-         --  Try to retreive input values from gnattest if they exist
+      Iterate_JSON_Object_File
+        (Fn,
+         Array_Field     => "results",
+         Process_Object  => Handle_File'Access,
+         Process_Element => Handle_Streamed_Result'Access);
 
-         Parse_Gnattest_Values (Subp);
+      if not From_Cache then
+         Record_Cost;
+      end if;
 
-         for Index in 1 .. Length (Results) loop
-            Handle_Result (Get (Results, Index));
-         end loop;
-         if Has_Field (File, "warnings") then
-            declare
-               Warnings : constant JSON_Array := Get (Get (File, "warnings"));
-            begin
-               for Index in 1 .. Length (Warnings) loop
+      for Index in 1 .. Length (Warnings) loop
 
-                  --  ??? Use some other mechanism to print those messages?
+         --  ??? Use some other mechanism to print those messages?
 
-                  Ada.Text_IO.Put_Line (Get (Get (Warnings, Index)));
-               end loop;
-            end;
-         end if;
-      end;
+         Ada.Text_IO.Put_Line (Get (Get (Warnings, Index)));
+      end loop;
    exception
       when Error : Invalid_JSON_Stream =>
          declare
@@ -0,0 +1,156 @@
+------------------------------------------------------------------------------
+--                                                                          --
+--                            GNAT2WHY COMPONENTS                           --
+--                                                                          --
+--                 G N A T 2 W H Y - P R O O F _ C O S T S                  --
+--                                                                          --
+--                                 B o d y                                  --
+--                                                                          --
+--                       Copyright (C) 2025, AdaCore                        --
+--                                                                          --
+-- gnat2why is  free  software;  you can redistribute  it and/or  modify it --
+-- under terms of the  GNU General Public License as published  by the Free --
+-- Software  Foundation;  either version 3,  or (at your option)  any later --
+-- version.  gnat2why is distributed  in the hope that  it will be  useful, --
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- --
+-- TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public --
+-- License for  more details.  You should have  received  a copy of the GNU --
+-- General  Public License  distributed with  gnat2why;  see file COPYING3. --
+-- If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the --
+-- license.                                                                 --
+--                                                                          --
+-- gnat2why is maintained by AdaCore (http://www.adacore.com)               --
+--                                                                          --
+------------------------------------------------------------------------------
+
+with Ada.Directories;
+with Ada.Strings.Unbounded; use Ada.Strings.Unbounded;
+with GNATCOLL.JSON;         use GNATCOLL.JSON;
+with Gnat2Why.Entity_Records;
+
+package body Gnat2Why.Proof_Costs is
+
+   type Proof_Cost is record
+      Time   : Duration;
+      Steps  : Natural;
+      Prover : Unbounded_String;
+   end record;
+
+   function From_JSON (Value : JSON_Value) return Proof_Cost;
+   --  Read a cost from the file of costs
+
+   function To_JSON (Cost : Proof_Cost) return JSON_Value;
+   --  Return the representation of Cost in the file of costs
+
+   package Costs is new
+     Gnat2Why.Entity_Records
+       (Element_Type => Proof_Cost,
+        To_JSON      => To_JSON,
+        From_JSON    => From_JSON);
+   use Costs;
+
+   --------------------
+   -- Estimated_Cost --
+   --------------------
+
+   function Estimated_Cost (E : Entity_Id; Why_File : String) return Natural
+   is
+      use type Ada.Directories.File_Size;
+
+      Unknown_Cost : constant := 1_000_000_000;
+      --  Base cost of entities without recorded cost, which corresponds to
+      --  more than 11 days in milliseconds.
+
+      Position : constant Entity_Maps.Cursor := Find_Previous (E);
+   begin
+      if Entity_Maps.Has_Element (Position) then
+         return
+           Natural
+             (Duration'Min
+                (Entity_Maps.Element (Position).Time * 1000,
+                 Duration (Unknown_Cost - 1)));
+      else
+         return
+           Unknown_Cost
+           + Natural
+               (Ada.Directories.File_Size'Min
+                  (Ada.Directories.Size (Why_File),
+                   Ada.Directories.File_Size (Natural'Last - Unknown_Cost)));
+      end if;
+   end Estimated_Cost;
+
+   ---------------
+   -- From_JSON --
+   ---------------
+
+   function From_JSON (Value : JSON_Value) return Proof_Cost is
+     (Time   => Duration (Float'(Get (Value, "time"))),
+      Steps  => Get (Value, "steps"),
+      Prover => To_Unbounded_String (String'(Get (Value, "prover"))));
+
+   ----------------------
+   -- Load_Proof_Costs --
+   ----------------------
+
+   procedure Load_Proof_Costs (File_Name : String) renames Costs.Load;
+
+   ------------------------
+   -- Proof_Cost_Summary --
+   ------------------------
+
+   function Proof_Cost_Summary return JSON_Value is
+      Result    : constant JSON_Value := Create_Object;
+      Predicted : Duration := 0.0;
+      Actual    : Duration := 0.0;
+   begin
+      for C in Current.Iterate loop
+         declare
+            Position : constant Entity_Maps.Cursor :=
+              Previous.Find (Entity_Maps.Key (C));
+         begin
+            if Entity_Maps.Has_Element (Position) then
+               Predicted := Predicted + Entity_Maps.Element (Position).Time;
+               Actual := Actual + Entity_Maps.Element (C).Time;
+            end if;
+         end;
+      end loop;
+
+      Set_Field (Result, "predicted", Float (Predicted));
+      Set_Field (Result, "actual", Float (Actual));
+      return Result;
+   end Proof_Cost_Summary;
+
+   -----------------------
+   -- Record_Proof_Cost --
+   -----------------------
+
+   procedure Record_Proof_Cost
+     (E : Entity_Id; Time : Duration; Steps : Natural; Prover : String) is
+   begin
+      Record_Current
+        (E,
+         (Time   => Time,
+          Steps  => Steps,
+          Prover => To_Unbounded_String (Prover)));
+   end Record_Proof_Cost;
+
+   ----------------------
+   -- Save_Proof_Costs --
+   ----------------------
+
+   procedure Save_Proof_Costs (File_Name : String) renames Costs.Save;
+
+   -------------
+   -- To_JSON --
+   -------------
+
+   function To_JSON (Cost : Proof_Cost) return JSON_Value is
+      Obj : constant JSON_Value := Create_Object;
+   begin
+      Set_Field (Obj, "time", Float (Cost.Time));
+      Set_Field (Obj, "steps", Cost.Steps);
+      Set_Field (Obj, "prover", To_String (Cost.Prover));
+      return Obj;
+   end To_JSON;
+
+end Gnat2Why.Proof_Costs;
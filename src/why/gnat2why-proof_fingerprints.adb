@@ -0,0 +1,159 @@
+------------------------------------------------------------------------------
+--                                                                          --
+--                            GNAT2WHY COMPONENTS                           --
+--                                                                          --
+--          G N A T 2 W H Y - P R O O F _ F I N G E R P R I N T S           --
+--                                                                          --
+--                                 B o d y                                  --
+--                                                                          --
+--                       Copyright (C) 2026, AdaCore                        --
+--                                                                          --
+-- gnat2why is  free  software;  you can redistribute  it and/or  modify it --
+-- under terms of the  GNU General Public License as published  by the Free --
+-- Software  Foundation;  either version 3,  or (at your option)  any later --
+-- version.  gnat2why is distributed  in the hope that  it will be  useful, --
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of  MERCHAN- --
+-- TABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public --
+-- License for  more details.  You should have  received  a copy of the GNU --
+-- General  Public License  distributed with  gnat2why;  see file COPYING3. --
+-- If not,  go to  http://www.gnu.org/licenses  for a complete  copy of the --
+-- license.                                                                 --
+--                                                                          --
+-- gnat2why is maintained by AdaCore (http://www.adacore.com)               --
+--                                                                          --
+------------------------------------------------------------------------------
+
+with Ada.Strings.Unbounded; use Ada.Strings.Unbounded;
+with GNATCOLL.JSON;         use GNATCOLL.JSON;
+with Gnat2Why.Entity_Records;
+with Proof_Cache;
+with SPARK2014VSN;          use SPARK2014VSN;
+
+package body Gnat2Why.Proof_Fingerprints is
+
+   type Proof_Output is record
+      Fingerprint : Unbounded_String;
+      Output      : Unbounded_String;
+   end record;
+
+   function From_JSON (Value : JSON_Value) return Proof_Output;
+   --  Read an output from the file of outputs
+
+   function To_JSON (Output : Proof_Output) return JSON_Value;
+   --  Return the representation of Output in the file of outputs
+
+   package Outputs is new
+     Gnat2Why.Entity_Records
+       (Element_Type => Proof_Output,
+        To_JSON      => To_JSON,
+        From_JSON    => From_JSON);
+   use Outputs;
+
+   -------------------------
+   -- Compute_Fingerprint --
+   -------------------------
+
+   function Compute_Fingerprint (Why3_Args : String_Lists.List) return String
+   is
+      use String_Lists;
+
+      Position : Cursor := Why3_Args.First;
+      Command  : String_Lists.List;
+   begin
+      --  Skip the wrappers, so that the fingerprint only depends on the
+      --  command line of gnatwhy3 and on its binary.
+
+      while Has_Element (Position) and then Element (Position) /= "gnatwhy3"
+      loop
+         Next (Position);
+      end loop;
+
+      if not Has_Element (Position) then
+         return "";
+      end if;
+
+      while Position /= Why3_Args.Last loop
+         if Element (Position)
+            in "--force" | "--replay" | "--proof-dir" | "--debug-save-vcs"
+         then
+            return "";
+         end if;
+
+         Command.Append (Element (Position));
+         Next (Position);
+      end loop;
+
+      return
+        Proof_Cache.Compute_Key
+          (Salt    => SPARK2014_Static_Version_String,
+           Command => Command,
+           File    => Why3_Args.Last_Element);
+   end Compute_Fingerprint;
+
+   ---------------
+   -- From_JSON --
+   ---------------
+
+   function From_JSON (Value : JSON_Value) return Proof_Output is
+     (Fingerprint => To_Unbounded_String (String'(Get (Value, "fingerprint"))),
+      Output      => To_Unbounded_String (String'(Get (Value, "output"))));
+
+   -----------------------
+   -- Load_Fingerprints --
+   -----------------------
+
+   procedure Load_Fingerprints (File_Name : String) renames Outputs.Load;
+
+   ---------------------
+   -- Previous_Output --
+   ---------------------
+
+   function Previous_Output
+     (E : Entity_Id; Fingerprint : String) return String
+   is
+      Position : constant Entity_Maps.Cursor := Find_Previous (E);
+   begin
+      if Fingerprint /= ""
+        and then Entity_Maps.Has_Element (Position)
+        and then Entity_Maps.Element (Position).Fingerprint = Fingerprint
+      then
+         return To_String (Entity_Maps.Element (Position).Output);
+      else
+         return "";
+      end if;
+   end Previous_Output;
+
+   -------------------
+   -- Record_Output --
+   -------------------
+
+   procedure Record_Output
+     (E : Entity_Id; Fingerprint : String; Output : String) is
+   begin
+      if Fingerprint /= "" then
+         Record_Current
+           (E,
+            (Fingerprint => To_Unbounded_String (Fingerprint),
+             Output      => To_Unbounded_String (Output)));
+      end if;
+   end Record_Output;
+
+   -----------------------
+   -- Save_Fingerprints --
+   -----------------------
+
+   procedure Save_Fingerprints (File_Name : String) renames Outputs.Save;
+
+   -------------
+   -- To_JSON --
+   -------------
+
+   function To_JSON (Output : Proof_Output) return JSON_Value is
+      Obj : constant JSON_Value := Create_Object;
+   begin
+      Set_Field (Obj, "fingerprint", Output.Fingerprint);
+      Set_Field (Obj, "output", Output.Output);
+      return Obj;
+   end To_JSON;
+
+end Gnat2Why.Proof_Fingerprints;
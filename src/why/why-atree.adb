@@ -37,19 +37,11 @@ procedure Prepend (List_Id : Why_Node_List; New_Item : Why_Node_Id) is
 
    procedure Free is
    begin
-      --  Remove the (controlled) objects of the Why3 nodes with Clear and
-      --  free the memory used by the vector itself with Reserve_Capacity.
-      --
-      --  Note: while Ada RM says "If the capacity of Container is already
-      --  greater than or equal to [Reserve_Capacity parameter], then
-      --  Reserve_Capacity has no effect" the GNAT's implementation of
-      --  Reserve_Capcity frees the underlying memory, so let's do that.
+      --  Remove the (controlled) objects of the Why3 nodes and free the
+      --  memory used by the tables themselves.
 
       Node_Table.Clear;
-      Node_Table.Reserve_Capacity (0);
-
       List_Table.Clear;
-      List_Table.Reserve_Capacity (0);
    end Free;
 
    ----------------
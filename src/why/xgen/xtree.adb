@@ -75,6 +75,7 @@ procedure Xtree is
         Print_Class_Wide_Builder_Declarations'Access);
    Add ("Implement_Class_Wide_Builders",
         Print_Class_Wide_Builder_Bodies'Access);
+   Add ("Implement_Hash_Consing", Print_Hash_Consing_Bodies'Access);
    Add ("Declare_Accessors", Print_Accessor_Declarations'Access);
    Add ("Implement_Accessors", Print_Accessor_Bodies'Access);
    Add ("Declare_Mutators", Print_Mutator_Declarations'Access);
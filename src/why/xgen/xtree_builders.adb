@@ -65,10 +65,60 @@ procedure Print_Builder_Implementation
    --  Print the handled sequence of statements that implements this builder
 
    procedure Print_Builder_Local_Declarations
-     (O  : in out Output_Record;
-      IK : Id_Kind);
+     (O    : in out Output_Record;
+      Kind : Why_Node_Kind;
+      IK   : Id_Kind);
    --  Print the local declarations in builder body
 
+   function Is_Hash_Consed (Kind : Why_Node_Kind) return Boolean;
+   --  Return True if the builders of this kind hash-cons the nodes that they
+   --  create (when they are terms or predicates). This is the case for the
+   --  kinds of types, names and expressions which cannot be modified after
+   --  their creation; declarations are left alone.
+
+   function Hash_Expression (FI : Field_Info) return String;
+   --  Return an expression hashing the field FI of a node called Node, or
+   --  the empty string if this field is not hashed (it is still compared
+   --  by Equivalent_Nodes).
+
+   List_Mark : constant String := "List_Mark";
+
+   ---------------------
+   -- Hash_Expression --
+   ---------------------
+
+   function Hash_Expression (FI : Field_Info) return String is
+      Field : constant String := "Node." & Field_Name (FI);
+   begin
+      if Is_Why_Id (FI) then
+         return "Field_Hash (" & Field & ")";
+      end if;
+
+      declare
+         Typ : constant String := Type_Name (FI, Opaque);
+      begin
+         if Typ in "Uint" | "Ureal" | "Symbol_Set" | "String_Sets.Set" then
+            return "";
+         elsif Typ = "Symbol" then
+            return "GNATCOLL.Symbols.Hash (" & Field & ")";
+         elsif Typ in "Node_Id" | "Source_Ptr" then
+            return "Hash_Type'Mod (" & Field & ")";
+         else
+            return "Hash_Type (" & Typ & "'Pos (" & Field & "))";
+         end if;
+      end;
+   end Hash_Expression;
+
+   --------------------
+   -- Is_Hash_Consed --
+   --------------------
+
+   function Is_Hash_Consed (Kind : Why_Node_Kind) return Boolean is
+     (not Is_Mutable (Kind)
+      and then Get_Domain (Kind) /= EW_Prog
+      and then Kind in W_Type .. W_Name
+                     | W_Universal_Quantif .. W_Record_Aggregate);
+
    ------------------------
    -- Print_Builder_Body --
    ------------------------
@@ -240,13 +290,20 @@ function K (S : String) return String is
              Empty_Nodes & "." & Mixed_Case_Name (Kind) & "_Node);");
       PL (O, "declare");
       Relative_Indent (O, 3);
-      Print_Builder_Local_Declarations (O, IK);
+      Print_Builder_Local_Declarations (O, Kind, IK);
       Relative_Indent (O, -3);
       PL (O, "begin");
       Relative_Indent (O, 3);
       Common_Fields.Fields.Iterate (Print_Record_Initialization'Access);
       Variant_Part.Fields.Iterate (Print_Record_Initialization'Access);
-      PL (O, "return " & K (New_Node_Id) & ";");
+
+      if Is_Hash_Consed (Kind) then
+         PL (O, "return " & K ("Hash_Cons (" & New_Node_Id & ", "
+                               & List_Mark & ")") & ";");
+      else
+         PL (O, "return " & K (New_Node_Id) & ";");
+      end if;
+
       Relative_Indent (O, -3);
       PL (O, "end;");
    end Print_Builder_Implementation;
@@ -256,8 +313,9 @@ function K (S : String) return String is
    --------------------------------------
 
    procedure Print_Builder_Local_Declarations
-     (O  : in out Output_Record;
-      IK : Id_Kind)
+     (O    : in out Output_Record;
+      Kind : Why_Node_Kind;
+      IK   : Id_Kind)
    is
    begin
       PL (O, New_Node_Id & " : constant Why_Node_Id := " &
@@ -271,6 +329,11 @@ procedure Print_Builder_Local_Declarations
       else
          PL (O, "  True;");
       end if;
+
+      if Is_Hash_Consed (Kind) then
+         PL (O, List_Mark & " : constant Why_Node_List'Base := " &
+                "List_Table.Last_Index;");
+      end if;
    end Print_Builder_Local_Declarations;
 
    ---------------------------------
@@ -464,8 +527,7 @@ procedure Print_Class_Wide_Builder_Declarations (O : in out Output_Record)
    procedure Print_Class_Wide_Empty_Nodes (O : in out Output_Record);
    --  Print persistent empty nodes of each kind
    --
-   --  As Why_Node is a controlled type and it is stored an instance of
-   --  Ada.Containers.Indefinite_Vectors, it is relatively expensive to create
+   --  As Why_Node is a controlled type, it is relatively expensive to create
    --  nodes locally, copying them into Node_Table and then destroying.
    --
    --  Instead, we declare persistent empty nodes for each node kind, which are
@@ -528,4 +590,136 @@ procedure Print_Class_Wide_Builder_Bodies (O : in out Output_Record) is
       end loop;
    end Print_Class_Wide_Builder_Bodies;
 
+   -------------------------------
+   -- Print_Hash_Consing_Bodies --
+   -------------------------------
+
+   procedure Print_Hash_Consing_Bodies (O : in out Output_Record) is
+      First : Boolean;
+   begin
+      Print_Box (O, "Equivalent_Nodes");
+      NL (O);
+      PL (O, "function Equivalent_Nodes "
+          & "(Left, Right : Why_Node_Id) return Boolean is");
+      Relative_Indent (O, 3);
+      PL (O, "L : Why_Node renames Node_Table (Left);");
+      PL (O, "R : Why_Node renames Node_Table (Right);");
+      Relative_Indent (O, -3);
+      PL (O, "begin");
+      Relative_Indent (O, 3);
+      P (O, "if L.Kind /= R.Kind");
+
+      for FI of Common_Fields.Fields loop
+         NL (O);
+         P (O, "  or else L." & Field_Name (FI) & " /= R." & Field_Name (FI));
+      end loop;
+
+      NL (O);
+      PL (O, "then");
+      PL (O, "   return False;");
+      PL (O, "end if;");
+      NL (O);
+      PL (O, "case L.Kind is");
+      Relative_Indent (O, 3);
+
+      for Kind in Valid_Kind'Range loop
+         if Is_Hash_Consed (Kind) then
+            First := True;
+            PL (O, "when " & Mixed_Case_Name (Kind) & " =>");
+            Relative_Indent (O, 3);
+
+            if Why_Tree_Info (Kind).Fields.Is_Empty then
+               PL (O, "return True;");
+            else
+               P (O, "return");
+
+               for FI of Why_Tree_Info (Kind).Fields loop
+                  declare
+                     FN : constant String := Field_Name (FI);
+                  begin
+                     if First then
+                        P (O, " ");
+                        First := False;
+                     else
+                        NL (O);
+                        P (O, "  and then ");
+                     end if;
+
+                     if Is_List (FI) then
+                        P (O, "Same_List (L." & FN & ", R." & FN & ")");
+                     else
+                        P (O, "L." & FN & " = R." & FN);
+                     end if;
+                  end;
+               end loop;
+
+               PL (O, ";");
+            end if;
+
+            Relative_Indent (O, -3);
+         end if;
+      end loop;
+
+      PL (O, "when others =>");
+      PL (O, "   raise Program_Error;");
+      Relative_Indent (O, -3);
+      PL (O, "end case;");
+      Relative_Indent (O, -3);
+      PL (O, "end Equivalent_Nodes;");
+      NL (O);
+
+      Print_Box (O, "Hash_Node");
+      NL (O);
+      PL (O, "function Hash_Node (Node_Id : Why_Node_Id) return Hash_Type is");
+      Relative_Indent (O, 3);
+      PL (O, "Node : Why_Node renames Node_Table (Node_Id);");
+      PL (O, "H    : Hash_Type := Why_Node_Kind'Pos (Node.Kind);");
+      Relative_Indent (O, -3);
+      PL (O, "begin");
+      Relative_Indent (O, 3);
+
+      for FI of Common_Fields.Fields loop
+         if Hash_Expression (FI) /= "" then
+            PL (O, "H := H * 31 + " & Hash_Expression (FI) & ";");
+         end if;
+      end loop;
+
+      NL (O);
+      PL (O, "case Node.Kind is");
+      Relative_Indent (O, 3);
+
+      for Kind in Valid_Kind'Range loop
+         if Is_Hash_Consed (Kind) then
+            declare
+               Hashed : Boolean := False;
+            begin
+               PL (O, "when " & Mixed_Case_Name (Kind) & " =>");
+               Relative_Indent (O, 3);
+
+               for FI of Why_Tree_Info (Kind).Fields loop
+                  if Hash_Expression (FI) /= "" then
+                     PL (O, "H := H * 31 + " & Hash_Expression (FI) & ";");
+                     Hashed := True;
+                  end if;
+               end loop;
+
+               if not Hashed then
+                  PL (O, "null;");
+               end if;
+
+               Relative_Indent (O, -3);
+            end;
+         end if;
+      end loop;
+
+      PL (O, "when others =>");
+      PL (O, "   raise Program_Error;");
+      Relative_Indent (O, -3);
+      PL (O, "end case;");
+      NL (O);
+      PL (O, "return H;");
+      Relative_Indent (O, -3);
+      PL (O, "end Hash_Node;");
+   end Print_Hash_Consing_Bodies;
+
 end Xtree_Builders;
@@ -0,0 +1,16 @@
+with Ops;
+
+package body Client with SPARK_Mode is
+
+   procedure Good (X : out Integer) is
+   begin
+      Ops.Bump;  --  @GLOBAL:NONE
+      Ops.Read (X);  --  @GLOBAL:NONE
+   end Good;
+
+   procedure Bad is
+   begin
+      Ops.Bump;  --  @GLOBAL:CHECK
+   end Bad;
+
+end Client;
@@ -0,0 +1,15 @@
+with State;
+
+package body Ops with SPARK_Mode is
+
+   procedure Bump is
+   begin
+      State.V := State.W;
+   end Bump;
+
+   procedure Read (X : out Integer) is
+   begin
+      X := State.W;
+   end Read;
+
+end Ops;
@@ -0,0 +1,39 @@
+import glob
+from e3.os.process import Run
+from test_support import check_marks, generate_project_file
+
+# The globals of Ops are generated in phase 1, stored in its GG file, linked
+# into the GG database, and read back in phase 2 to check the Global
+# contracts of Client against the calls to Ops. When Ops changes, its GG
+# file is regenerated and the contracts are checked against the new globals.
+
+
+def flow():
+    """Run flow analysis on the project and return its messages"""
+    process = Run(
+        ["gnatprove", "-P", "test.gpr", "--mode=flow"]
+        + ["--output=oneline", "--report=all"]
+    )
+    return str.splitlines(process.out)
+
+
+def global_messages(lines):
+    """Return the number of messages about global contracts in lines"""
+    return len([line for line in lines if "must be a global output" in line])
+
+
+generate_project_file()
+
+lines = flow()
+check_marks(lines)
+print("GG files written:", len(glob.glob("gnatprove/**/*.gg", recursive=True)) > 0)
+print("GG database linked:", len(glob.glob("gnatprove/gnatprove.ggdb")) == 1)
+print("messages with the globals of Ops:", global_messages(lines))
+
+with open("ops.adb") as f:
+    body = f.read()
+with open("ops.adb", "w") as f:
+    f.write(body.replace("State.V := State.W;", "null;"))
+
+lines = flow()
+print("messages with the new globals of Ops:", global_messages(lines))
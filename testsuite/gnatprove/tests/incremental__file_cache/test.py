@@ -0,0 +1,49 @@
+import os
+from e3.os.process import Run
+from test_support import prove_all
+
+# Proof results are stored in a file cache. A second run on unchanged sources
+# must find all of its results in the cache: it adds no entry, and it reads
+# entries, which updates their modification time. A change to the sources
+# must lead to new entries.
+
+cache_dir = os.path.abspath("cache")
+cache_opt = "--memcached-server=file:" + cache_dir
+os.makedirs(cache_dir)
+
+
+def entries():
+    """Return the number of entries in the file cache"""
+    process = Run(["spark_cache", "stats", cache_dir])
+    return int(process.out.split()[0])
+
+
+def age_entries():
+    """Set the modification time of all entries ten days back"""
+    old = os.path.getmtime(cache_dir) - 10 * 24 * 3600
+    for root, _, files in os.walk(cache_dir):
+        for name in files:
+            os.utime(os.path.join(root, name), (old, old))
+
+
+prove_all(opt=[cache_opt], cache_allowed=False, no_output=True, exit_status=0)
+first = entries()
+print("entries stored by the first run:", first > 0)
+
+age_entries()
+prove_all(
+    opt=[cache_opt, "-f"], cache_allowed=False, no_output=True, exit_status=0
+)
+print("entries added by the unchanged run:", entries() - first)
+
+Run(["spark_cache", "gc", cache_dir, "--max-age=1"])
+kept = entries()
+print("entries read by the unchanged run:", kept > 0)
+
+with open("counters.adb") as f:
+    body = f.read()
+with open("counters.adb", "w") as f:
+    f.write(body.replace("return A + B;", "return B + A;"))
+
+prove_all(opt=[cache_opt], cache_allowed=False, no_output=True, exit_status=0)
+print("entries added after a change:", entries() > kept)
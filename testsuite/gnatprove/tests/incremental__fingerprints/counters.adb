@@ -0,0 +1,18 @@
+package body Counters with SPARK_Mode is
+
+   procedure Incr (C : in out Count) is
+   begin
+      C := C + 1;  --  @RANGE_CHECK:PASS
+   end Incr;
+
+   procedure Decr (C : in out Count) is
+   begin
+      C := C - 1;  --  @RANGE_CHECK:PASS
+   end Decr;
+
+   function Total (A, B : Count) return Natural is
+   begin
+      return A + B;  --  @OVERFLOW_CHECK:PASS
+   end Total;
+
+end Counters;
@@ -0,0 +1,38 @@
+import glob
+from e3.os.process import Run
+from test_support import check_marks, generate_project_file
+
+# gnat2why records the output of gnatwhy3 for each entity together with the
+# fingerprint of its proof job. When the unit is analyzed again, the output
+# is reused for the entities whose proof job did not change. In debug mode,
+# gnat2why prints the command line of each proof job it actually runs.
+
+
+def gnatprove():
+    """Analyze the project in debug mode and return the number of proof jobs
+    run by gnat2why"""
+    process = Run(
+        ["gnatprove", "-P", "test.gpr", "-j1", "-d"]
+        + ["--output=oneline", "--report=all"]
+    )
+    lines = str.splitlines(process.out)
+    check_marks(lines)
+    return len([line for line in lines if " --entity " in line])
+
+
+generate_project_file()
+
+first = gnatprove()
+print("proof jobs run by the first analysis:", first > 0)
+print(
+    "fingerprints recorded:",
+    len(glob.glob("gnatprove/**/counters.fingerprints", recursive=True)) == 1,
+)
+
+with open("counters.adb") as f:
+    body = f.read()
+with open("counters.adb", "w") as f:
+    f.write(body.replace("return A + B;", "return B + A;"))
+
+second = gnatprove()
+print("proof jobs run after changing one subprogram:", 0 < second < first)
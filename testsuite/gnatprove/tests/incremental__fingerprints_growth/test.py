@@ -0,0 +1,46 @@
+import os
+from e3.os.process import Run
+from test_support import check_marks, generate_project_file
+
+# Growing the body of the first subprogram of a unit adds Why nodes which are
+# printed before those of the other entities. The files of these entities,
+# and so the fingerprints of their proof jobs, must not change, so that only
+# the proof of the first subprogram is run again. In debug mode, gnat2why
+# prints the command line of each proof job it actually runs, which ends with
+# the file of the entity.
+
+
+def proof_jobs():
+    """Analyze the project in debug mode and return the files of the proof
+    jobs run by gnat2why"""
+    process = Run(
+        ["gnatprove", "-P", "test.gpr", "-j1", "-d"]
+        + ["--output=oneline", "--report=all"]
+    )
+    lines = str.splitlines(process.out)
+    check_marks(lines)
+    return sorted(
+        os.path.basename(line.split()[-1]) for line in lines if " --entity " in line
+    )
+
+
+generate_project_file()
+
+first = proof_jobs()
+print("proof jobs run by the first analysis:", len(first) > 1)
+
+with open("counters.adb") as f:
+    body = f.read()
+with open("counters.adb", "w") as f:
+    f.write(
+        body.replace(
+            "      C := C + 1;  --  @RANGE_CHECK:PASS\n   end Grow;",
+            "      C := C + 1;  --  @RANGE_CHECK:PASS\n"
+            "      C := C + 2;  --  @RANGE_CHECK:PASS\n"
+            "      C := C + 3;  --  @RANGE_CHECK:PASS\n"
+            "   end Grow;",
+        )
+    )
+
+for job in proof_jobs():
+    print("proof job run after growing Grow:", job)
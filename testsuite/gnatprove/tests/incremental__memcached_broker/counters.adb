@@ -0,0 +1,13 @@
+package body Counters with SPARK_Mode is
+
+   procedure Incr (C : in out Count) is
+   begin
+      C := C + 1;  --  @RANGE_CHECK:PASS
+   end Incr;
+
+   function Total (A, B : Count) return Natural is
+   begin
+      return A + B;  --  @OVERFLOW_CHECK:PASS
+   end Total;
+
+end Counters;
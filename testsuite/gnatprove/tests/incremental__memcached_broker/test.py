@@ -0,0 +1,81 @@
+import shutil
+import socketserver
+import threading
+from e3.os.process import Run
+from test_support import generate_project_file
+
+# Proof results are stored in a memcached server, accessed through the broker
+# spawned by gnatprove. After removing the object directory, so that no
+# result is reused from the previous analysis, gnat2why must find all the
+# results of gnatwhy3 in the server through the broker, without spawning any
+# proof job, and store nothing. In debug mode, gnat2why prints the command
+# line of each proof job it actually runs.
+
+values = {}
+sets = [0]
+
+
+class Memcached(socketserver.StreamRequestHandler):
+    """Minimal memcached server, implementing the get, set and quit commands
+    of the text protocol"""
+
+    def handle(self):
+        while True:
+            line = self.rfile.readline()
+            if not line:
+                return
+            command = line.split()
+            if command[0] == b"get":
+                for key in command[1:]:
+                    if key in values:
+                        data = values[key]
+                        self.wfile.write(
+                            b"VALUE %s 0 %d\r\n%s\r\n" % (key, len(data), data)
+                        )
+                self.wfile.write(b"END\r\n")
+            elif command[0] == b"set":
+                data = self.rfile.read(int(command[4]) + 2)[:-2]
+                values[command[1]] = data
+                sets[0] += 1
+                self.wfile.write(b"STORED\r\n")
+            elif command[0] == b"quit":
+                return
+            else:
+                self.wfile.write(b"ERROR\r\n")
+
+
+class Server(socketserver.ThreadingTCPServer):
+    daemon_threads = True
+    allow_reuse_address = True
+
+
+server = Server(("127.0.0.1", 0), Memcached)
+threading.Thread(target=server.serve_forever, daemon=True).start()
+cache_opt = "--memcached-server=127.0.0.1:%d" % server.server_address[1]
+
+
+def gnatprove():
+    """Analyze the project in debug mode and return the messages and the
+    number of proof jobs run by gnat2why"""
+    process = Run(
+        ["gnatprove", "-P", "test.gpr", "-j1", "-d", cache_opt]
+        + ["--output=oneline", "--report=all"]
+    )
+    lines = str.splitlines(process.out)
+    messages = sorted(line for line in lines if line.startswith("counters."))
+    return messages, len([line for line in lines if " --entity " in line])
+
+
+generate_project_file()
+
+first, _ = gnatprove()
+stored = sets[0]
+print("results stored by the first run:", stored > 0)
+
+shutil.rmtree("gnatprove")
+second, jobs = gnatprove()
+print("proof jobs run after removing the object directory:", jobs)
+print("results stored by the second run:", sets[0] - stored)
+print("same messages:", first == second)
+
+server.shutdown()
@@ -0,0 +1,34 @@
+import glob
+from test_support import prove_all
+
+# The theories included by the entities of a unit are printed in shared files
+# named after the digest of their contents. Growing the body of the first
+# subprogram of the unit adds Why nodes which are printed before these
+# theories; the contents of their files, and so their names, must not change.
+
+
+def theory_files():
+    """Return the shared theory files of the unit"""
+    return set(glob.glob("gnatprove/**/counters-*.theory.gnat-json", recursive=True))
+
+
+prove_all(no_output=True, exit_status=0)
+before = theory_files()
+print("shared theory files written:", len(before) > 0)
+
+with open("counters.adb") as f:
+    body = f.read()
+with open("counters.adb", "w") as f:
+    f.write(
+        body.replace(
+            "      C := C + 1;  --  @RANGE_CHECK:PASS\n   end Grow;",
+            "      C := C + 1;  --  @RANGE_CHECK:PASS\n"
+            "      C := C + 2;  --  @RANGE_CHECK:PASS\n"
+            "      C := C + 3;  --  @RANGE_CHECK:PASS\n"
+            "   end Grow;",
+        )
+    )
+
+prove_all(no_output=True, exit_status=0)
+after = theory_files()
+print("shared theory files renamed after growing Grow:", len(before ^ after))
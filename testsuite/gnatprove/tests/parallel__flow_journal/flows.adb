@@ -0,0 +1,31 @@
+package body Flows with SPARK_Mode is
+
+   function First (C : Boolean) return Integer is
+      X : Integer;
+   begin
+      if C then
+         X := 1;
+      end if;
+      return X;  --  @INITIALIZED:CHECK
+   end First;
+
+   function Second (C : Boolean) return Integer is
+      X : Integer;
+   begin
+      if not C then
+         X := 2;
+      end if;
+      return X;  --  @INITIALIZED:CHECK
+   end Second;
+
+   procedure Copy_First (X, Z : Integer; Y : out Integer) is
+   begin
+      Y := X + Z;
+   end Copy_First;
+
+   procedure Copy_Second (X, Z : Integer; Y : out Integer) is
+   begin
+      Y := X - Z;
+   end Copy_Second;
+
+end Flows;
@@ -0,0 +1,49 @@
+import glob
+import json
+import os.path
+
+from e3.os.process import Run
+from test_support import check_marks, generate_project_file
+
+# With several jobs, the entities of a unit are analyzed by worker processes,
+# whose effects are replayed by gnat2why in the order of the sequential
+# analysis. The messages must be the same, and in the same order, as when
+# the entities are analyzed one after the other. This includes the ids of
+# messages, printed in IDE mode, and the names and contents of trace files.
+
+
+def flow(jobs):
+    """Run flow analysis on the project with the given number of jobs and
+    return its messages, flow results and trace files"""
+    process = Run(
+        ["gnatprove", "-P", "test.gpr", "-f", "--mode=flow", "-j%d" % jobs]
+        + ["--output=oneline", "--report=all", "--ide-progress-bar"]
+    )
+    lines = [line for line in str.splitlines(process.out) if "['#" in line]
+    check_marks(lines)
+    with open(os.path.join("gnatprove", "flows.spark"), "r") as f:
+        results = [
+            (result.get("msg_id"), result.get("tracefile"))
+            for result in json.load(f)["flow"]
+        ]
+    traces = {}
+    for trace in glob.glob(os.path.join("gnatprove", "*.trace")):
+        with open(trace, "r") as f:
+            traces[os.path.basename(trace)] = f.read()
+        os.remove(trace)
+    return lines, results, traces
+
+
+generate_project_file()
+
+sequential = flow(1)
+parallel = flow(4)
+
+print("messages issued:", len(sequential[0]) > 0)
+print("trace files written:", len(sequential[2]) > 0)
+print("same messages in parallel:", parallel[0] == sequential[0])
+print("same flow results in parallel:", parallel[1] == sequential[1])
+print("same trace files in parallel:", parallel[2] == sequential[2])
+if parallel != sequential:
+    print("sequential:", sequential)
+    print("parallel:", parallel)
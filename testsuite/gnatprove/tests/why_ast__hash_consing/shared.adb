@@ -0,0 +1,41 @@
+package body Shared with SPARK_Mode is
+
+   --  The same expressions occur in contexts where their checks are proved,
+   --  and in contexts where they are not. Each check must keep its own
+   --  location and result, even though the terms that express them are
+   --  structurally equal and shared in the Why AST.
+
+   procedure Incr_Small (X : Integer; Y : out Integer) is
+   begin
+      if X < 100 then
+         Y := X + 1;  --  @OVERFLOW_CHECK:PASS
+      else
+         Y := X + 1;  --  @OVERFLOW_CHECK:FAIL
+      end if;
+   end Incr_Small;
+
+   procedure Incr_Any (X : Integer; Y : out Integer) is
+   begin
+      Y := X + 1;  --  @OVERFLOW_CHECK:FAIL
+   end Incr_Any;
+
+   function Sum_Small (T : Table) return Integer is
+      Result : Integer := 0;
+   begin
+      for I in Index loop
+         pragma Loop_Invariant (Result in 0 .. 1_000 * Integer (I - 1));
+         Result := Result + T (I);  --  @OVERFLOW_CHECK:PASS
+      end loop;
+      return Result;
+   end Sum_Small;
+
+   function Sum_Any (T : Table) return Integer is
+      Result : Integer := 0;
+   begin
+      for I in Index loop
+         Result := Result + T (I);  --  @OVERFLOW_CHECK:FAIL
+      end loop;
+      return Result;
+   end Sum_Any;
+
+end Shared;
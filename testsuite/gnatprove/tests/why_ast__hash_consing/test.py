@@ -0,0 +1,7 @@
+from test_support import prove_all
+
+# Structurally equal Why terms are shared between checks whose results differ.
+# The marks in the sources check that sharing them does not mix up the
+# results or the locations of these checks.
+
+prove_all(no_output=True, exit_status=0)